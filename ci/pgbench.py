@@ -193,6 +193,32 @@ class OrderedInsertTest():
 		schema = engineGetSchema(engine)
 		return ("INSERT INTO {0}.insert_test VALUES (current_timestamp, :client_id);\n").format(schema)
 
+class SerialInsertTest():
+	def needsStdTables(self):
+		return False
+
+	def prepare(self, engine, node):
+		schema = engineGetSchema(engine)
+		using = " USING orioledb" if engine == 'orioledb' else ""
+		node.safe_psql(
+			("CREATE TABLE {0}.serial_insert_test (\n" +
+			 "  id bigserial PRIMARY KEY,\n" +
+			 "  client_id int NOT NULL,\n" +
+			 "  ts timestamp NOT NULL){1};\n" +
+			 "CREATE TABLE {0}.ctid_insert_test (\n" +
+			 "  client_id int NOT NULL,\n" +
+			 "  ts timestamp NOT NULL){1};").format(schema, using))
+
+	def prepareForRun(self, engine, node):
+		node.safe_psql('CHECKPOINT;')
+		schema = engineGetSchema(engine)
+		node.safe_psql('TRUNCATE {0}.serial_insert_test, {0}.ctid_insert_test;'.format(schema))
+
+	def getScript(self, engine):
+		schema = engineGetSchema(engine)
+		return ("INSERT INTO {0}.serial_insert_test (client_id, ts) VALUES (:client_id, current_timestamp);\n" +
+				"INSERT INTO {0}.ctid_insert_test VALUES (:client_id, current_timestamp);\n").format(schema)
+
 class BloatTest():
 	def needsStdTables(self):
 		return False
@@ -240,6 +266,66 @@ class BloatTest():
 				"INSERT INTO {0}.bloat_test VALUES(:id, random(), random(), random(), random(), now())\n" +
 				"ON CONFLICT (id) DO UPDATE SET ts = now();").format(schema)
 
+class HotPageTest():
+	def needsStdTables(self):
+		return False
+
+	def prepare(self, engine, node):
+		schema = engineGetSchema(engine)
+		using = " USING orioledb" if engine == 'orioledb' else ""
+		node.safe_psql(
+			("CREATE TABLE {0}.hot_page_test (\n" +
+			 "  id int PRIMARY KEY,\n" +
+			 "  value bigint NOT NULL){1};").format(schema, using))
+
+	def prepareForRun(self, engine, node):
+		schema = engineGetSchema(engine)
+		node.safe_psql(
+			("TRUNCATE {0}.hot_page_test;\n" +
+			 "INSERT INTO {0}.hot_page_test\n" +
+			 "  SELECT i, 0 FROM generate_series(1, 16) i;").format(schema))
+		node.safe_psql('CHECKPOINT;')
+
+	def getScript(self, engine):
+		schema = engineGetSchema(engine)
+		return ("\\set id random(1, 16)\n" +
+				"UPDATE {0}.hot_page_test SET value = value + 1 WHERE id = :id;\n").format(schema)
+
+class LogicalDecodingTest():
+	def needsStdTables(self):
+		return False
+
+	def prepare(self, engine, node):
+		schema = engineGetSchema(engine)
+		using = " USING orioledb" if engine == 'orioledb' else ""
+		node.safe_psql(
+			("CREATE TABLE {0}.decoding_test (\n" +
+			 "  id bigserial PRIMARY KEY,\n" +
+			 "  client_id int NOT NULL,\n" +
+			 "  value float8 NOT NULL,\n" +
+			 "  payload text NOT NULL){1};\n" +
+			 "CREATE PUBLICATION decoding_test_{2} FOR TABLE {0}.decoding_test;").format(schema, using, engine))
+		# Slot can't be created in the transaction which has performed writes
+		node.safe_psql(
+			"SELECT pg_create_logical_replication_slot('decoding_test_{0}', 'pgoutput');".format(engine))
+
+	def prepareForRun(self, engine, node):
+		schema = engineGetSchema(engine)
+		node.safe_psql(
+			("SELECT count(*) FROM pg_logical_slot_get_binary_changes('decoding_test_{0}', NULL, NULL,\n" +
+			 "  'proto_version', '1', 'publication_names', 'decoding_test_{0}');").format(engine))
+		node.safe_psql('CHECKPOINT;')
+		node.safe_psql('TRUNCATE {0}.decoding_test;'.format(schema))
+
+	def getScript(self, engine):
+		schema = engineGetSchema(engine)
+		return ("INSERT INTO {0}.decoding_test (client_id, value, payload)\n" +
+				"  SELECT :client_id, random(), repeat('x', 100) FROM generate_series(1, 10);\n" +
+				"\\if :client_id = 0\n" +
+				"SELECT count(*) FROM pg_logical_slot_get_binary_changes('decoding_test_{1}', NULL, NULL,\n" +
+				"  'proto_version', '1', 'publication_names', 'decoding_test_{1}');\n" +
+				"\\endif\n").format(schema, engine)
+
 class WGTest():
 	def needsStdTables(self):
 		return False
@@ -390,7 +476,10 @@ test_classes = {
 	'read-only-9' : ReadOnlyTest9,
 	'read-only-zipf' : ReadOnlyZipfTest,
 	'ordered-insert' : OrderedInsertTest,
+	'serial-insert' : SerialInsertTest,
 	'bloat' : BloatTest,
+	'hot-page' : HotPageTest,
+	'logical-decoding' : LogicalDecodingTest,
 	'wg' : WGTest,
 }
 
@@ -601,6 +690,9 @@ class PgBenchTest:
 							  str(args.max_wal_size),
 							  str(args.checkpoint_timeout)))
 
+			if 'logical-decoding' in args.tests:
+				node.append_conf("wal_level = logical\n")
+
 			if 'builtin' in args.engines:
 				node.append_conf("shared_buffers = %s\n" %
 								 (args.shared_buffers))
@@ -4,4 +4,4 @@ set -eux
 
 export PATH="$GITHUB_WORKSPACE/python3-venv/bin:$PATH"
 
-pip3 install 'moto[s3]' flask flask_cors boto3
+pip3 install 'moto[s3]' flask flask_cors boto3 zstandard
@@ -149,6 +149,13 @@ typedef struct
 	uint32		(*hash) (BTreeDescr *desc, OTuple tuple, BTreeKeyType tupleType);
 	uint32		(*unique_hash) (BTreeDescr *desc, OTuple tuple);
 	OBTreeKeyCmp cmp;
+
+	/*
+	 * Optional.  Makes the shortest non-leaf key separating `left` and
+	 * `right` leaf tuples, omitting trailing attributes not needed to tell
+	 * them apart.  Returns null tuple if nothing could be omitted.
+	 */
+	OTuple		(*make_separator) (BTreeDescr *desc, OTuple left, OTuple right);
 } BTreeOps;
 
 #define MAX_NUM_DIRTY_PARTS			4
@@ -167,6 +174,12 @@ typedef struct
 	S3TaskLocation writeMaxLocation;
 } BTreeS3PartsInfo;
 
+typedef struct
+{
+	OInMemoryBlkno blkno;
+	uint32		pageChangeCount;
+} BTreeLocationHint;
+
 struct BTreeDescr
 {
 	BTreeRootInfo rootInfo;
@@ -185,6 +198,18 @@ struct BTreeDescr
 	BTreeS3PartsInfo buildPartsInfo[2];
 	OXid		createOxid;
 	BTreeOps   *ops;
+
+	/*
+	 * Backend-local location of the rightmost leaf, where appends of
+	 * increasing keys go.  Validated by page change count before use.
+	 */
+	BTreeLocationHint rightmostLeaf;
+
+	/*
+	 * Backend-local location of the last modified leaf.  Maintained only
+	 * when o_btree_use_last_leaf_hint is set.
+	 */
+	BTreeLocationHint lastLeaf;
 };
 
 static inline int
@@ -238,12 +263,6 @@ o_btree_cmp(BTreeDescr *desc, void *p1, BTreeKeyType k1,
 
 typedef struct BTreePageItemLocator BTreePageItemLocator;
 
-typedef struct
-{
-	OInMemoryBlkno blkno;
-	uint32		pageChangeCount;
-} BTreeLocationHint;
-
 typedef struct
 {
 	BTreeLocationHint hint;
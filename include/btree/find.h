@@ -89,6 +89,12 @@ extern bool find_page(OBTreeFindPageContext *context, void *key,
 extern bool refind_page(OBTreeFindPageContext *context, void *key,
 						BTreeKeyType keyType, uint16 level,
 						OInMemoryBlkno blkno, uint32 pageChangeCount);
+extern bool find_rightmost_leaf_by_hint(OBTreeFindPageContext *context,
+										void *key, BTreeKeyType keyType,
+										BTreeLocationHint *hint);
+extern bool find_leaf_by_hint(OBTreeFindPageContext *context,
+							  void *key, BTreeKeyType keyType,
+							  BTreeLocationHint *hint);
 
 extern bool find_right_page(OBTreeFindPageContext *context, OFixedKey *hikey);
 extern bool find_left_page(OBTreeFindPageContext *context, OFixedKey *hikey);
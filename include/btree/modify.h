@@ -50,6 +50,7 @@ typedef struct BTreeModifyCallbackInfo
 } BTreeModifyCallbackInfo;
 
 extern BTreeModifyCallbackInfo nullCallbackInfo;
+extern bool o_btree_use_last_leaf_hint;
 
 extern bool o_btree_autonomous_insert(BTreeDescr *desc, OTuple tuple);
 extern bool o_btree_autonomous_delete(BTreeDescr *desc, OTuple key, BTreeKeyType keyType,
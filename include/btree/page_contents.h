@@ -17,6 +17,14 @@
 #include "s3/queue.h"
 
 #define NUM_SEQ_SCANS_ARRAY_SIZE	32
+#define EXTENT_CACHE_SIZE			64
+
+/* Free extent kept in the meta page cache, see free_extents.c */
+typedef struct
+{
+	uint64		offset;
+	uint64		length;
+} CachedFileExtent;
 
 /* The structure of BTree meta page.  Referenced by metaPageBlkno. */
 typedef struct
@@ -50,6 +58,21 @@ typedef struct
 
 	LWLock		punchHolesLock;
 	uint32		punchHolesChkpNum;
+
+	/*
+	 * Free extents of a compressed tree cached in front of the free extents
+	 * sys trees.  Cached extents are absent in the sys trees.
+	 */
+	LWLock		extentCacheLock;
+	slock_t		extentCacheSpinlock;
+	int			extentCacheCount;
+	CachedFileExtent extentCache[EXTENT_CACHE_SIZE];
+
+	/*
+	 * Split of leaf pages might truncate separator keys.  Persisted as
+	 * CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION of the checkpoint file header.
+	 */
+	bool		suffixTruncation;
 } BTreeMetaPage;
 
 StaticAssertDecl(sizeof(BTreeMetaPage) <= ORIOLEDB_BLCKSZ,
@@ -43,7 +43,7 @@ extern BTreeSeqScan *make_btree_seq_scan(BTreeDescr *desc,
 extern BTreeSeqScan *make_btree_seq_scan_cb(BTreeDescr *desc,
 											OSnapshot *oSnapshot,
 											BTreeSeqScanCallbacks *cb,
-											void *arg);
+											void *arg, void *poscan);
 extern BTreeSeqScan *make_btree_sampling_scan(BTreeDescr *desc,
 											  BlockSampler sampler);
 extern OTuple btree_seq_scan_getnext(BTreeSeqScan *scan, MemoryContext mctx,
@@ -51,6 +51,9 @@ extern OTuple btree_seq_scan_getnext(BTreeSeqScan *scan, MemoryContext mctx,
 									 BTreeLocationHint *hint);
 extern OTuple btree_seq_scan_getnext_raw(BTreeSeqScan *scan, MemoryContext mctx,
 										 bool *end, BTreeLocationHint *hint);
+extern void btree_downlinks_range_high(BTreeDescr *desc, CommitSeqNo csn,
+									   void *key, BTreeKeyType keyType,
+									   int ndownlinks, OFixedKey *high);
 extern void free_btree_seq_scan(BTreeSeqScan *scan);
 extern void seq_scans_cleanup(void);
 
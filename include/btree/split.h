@@ -30,6 +30,7 @@ extern OffsetNumber btree_page_split_location(BTreeDescr *desc, Page page,
 											  OTuple tuple, bool replace,
 											  OffsetNumber target_location,
 											  float spaceRatio, OTuple *split_item,
+											  OTuple *last_left_item,
 											  CommitSeqNo csn);
 extern OffsetNumber btree_get_split_left_count(BTreeDescr *desc,
 											   OInMemoryBlkno blkno,
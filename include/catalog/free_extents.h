@@ -17,6 +17,7 @@
 
 extern FileExtent get_extent(BTreeDescr *desc, uint16 len);
 extern void free_extent(BTreeDescr *desc, FileExtent extent);
+extern void free_extents_cache_flush(BTreeDescr *desc);
 
 typedef void (*ForEachExtentCallback) (BTreeDescr *desc, FileExtent extent, void *arg);
 extern void foreach_free_extent(BTreeDescr *desc, ForEachExtentCallback callback,
@@ -17,6 +17,7 @@
 
 #include "orioledb.h"
 
+#include "catalog/index.h"
 #include "catalog/o_tables.h"
 #include "tableam/descr.h"
 
@@ -141,6 +142,8 @@ extern void build_secondary_index(OTable *o_table, OTableDescr *descr,
 								  OIndexNumber ix_num,
 								  bool in_dedicated_recovery_worker,
 								  IndexBuildResult *result);
+extern void o_validate_index_concurrently(Relation heap, Relation index,
+										  ValidateIndexState *state);
 PGDLLEXPORT void _o_index_parallel_build_main(dsm_segment *seg, shm_toc *toc);
 extern void _o_index_parallel_build_inner(dsm_segment *seg, shm_toc *toc,
 										  OTable *recovery_o_table, OTable *recovery_old_o_table);
@@ -0,0 +1,39 @@
+/*-------------------------------------------------------------------------
+ *
+ * o_descr_cache.h
+ *		Declarations of the shared cache of serialized table and index
+ *		descriptions.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/include/catalog/o_descr_cache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef __O_DESCR_CACHE_H__
+#define __O_DESCR_CACHE_H__
+
+/*
+ * Cache key.  OTable images have type == oIndexInvalid, OIndex images have
+ * the index type.
+ */
+typedef struct
+{
+	ORelOids	oids;
+	OIndexType	type;
+} ODescrCacheKey;
+
+extern int	o_descr_cache_size;
+
+extern Size o_descr_cache_shmem_needs(void);
+extern void o_descr_cache_shmem_init(Pointer ptr, bool found);
+
+extern Pointer o_descr_cache_get(ODescrCacheKey *key, Size *length,
+								 uint32 *version, uint64 *generation);
+extern void o_descr_cache_put(ODescrCacheKey *key, Pointer data, Size length,
+							  uint32 version, uint64 generation);
+extern void o_descr_cache_invalidate(ORelOids oids);
+extern void o_descr_cache_invalidate_all(void);
+
+#endif							/* __O_DESCR_CACHE_H__ */
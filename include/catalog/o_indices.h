@@ -77,6 +77,7 @@ extern bool o_indices_add(OTable *table, OIndexNumber ixNum, OXid oxid,
 extern bool o_indices_del(OTable *table, OIndexNumber ixNum, OXid oxid,
 						  CommitSeqNo csn);
 extern OIndex *o_indices_get(ORelOids oids, OIndexType type);
+extern OIndex *o_indices_get_cached(ORelOids oids, OIndexType type);
 extern bool o_indices_update(OTable *table, OIndexNumber ixNum,
 							 OXid oxid, CommitSeqNo csn);
 extern bool o_indices_find_table_oids(ORelOids indexOids, OIndexType type,
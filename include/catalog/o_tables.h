@@ -149,6 +149,9 @@ extern bool o_tables_add_version(OTable *table, OXid oxid, CommitSeqNo csn,
 /* Returns OTable by its oids */
 extern OTable *o_tables_get(ORelOids oids);
 
+/* Same as o_tables_get(), but uses the shared descriptions cache */
+extern OTable *o_tables_get_cached(ORelOids oids);
+
 /* Returns OTable by its oids and version */
 extern OTable *o_tables_get_by_oids_and_version(ORelOids oids, uint32 *version);
 
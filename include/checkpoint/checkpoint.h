@@ -26,8 +26,15 @@ struct CheckpointFileHeader
 	uint64		datafileLength;
 	uint64		numFreeBlocks;
 	uint32		leafPagesNum;
+	uint32		flags;			/* CHECKPOINT_FILE_FLAG_* */
 };
 
+/*
+ * Separator keys of the tree might be suffix-truncated.  Fixed when the tree
+ * is created according to orioledb.btree_suffix_truncation.
+ */
+#define CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION	(1 << 0)
+
 typedef enum
 {
 	NextKeyNone,
@@ -183,6 +190,7 @@ typedef struct
 	int			copyBlknoTrancheId;
 	int			oMetaTrancheId;
 	int			punchHolesTrancheId;
+	int			extentCacheTrancheId;
 	pg_atomic_uint64 xidRecLastPos;
 	pg_atomic_uint64 xidRecFlushPos;
 	XidFileRec	xidRecQueue[FLEXIBLE_ARRAY_MEMBER];
@@ -44,11 +44,13 @@
 #endif
 
 #define ORIOLEDB_VERSION "OrioleDB public beta 9"
-#define ORIOLEDB_BINARY_VERSION 5
+#define ORIOLEDB_BINARY_VERSION 6
 #define ORIOLEDB_DATA_DIR "orioledb_data"
 #define ORIOLEDB_UNDO_DIR "orioledb_undo"
 #define ORIOLEDB_RMGR_ID (129)
 #define ORIOLEDB_XLOG_CONTAINER (0x00)
+/* Flag of the container compressed with orioledb.wal_compress */
+#define ORIOLEDB_XLOG_COMPRESSED (0x10)
 
 /*
  * perform_page_split() removes a key data from first right page downlink.
@@ -325,7 +327,9 @@ extern Size device_length;
 extern int	default_compress;
 extern int	default_primary_compress;
 extern int	default_toast_compress;
+extern int	wal_compress;
 extern bool orioledb_table_description_compress;
+extern bool orioledb_btree_suffix_truncation;
 extern bool orioledb_s3_mode;
 extern int	s3_num_workers;
 extern int	s3_desired_size;
@@ -337,6 +341,7 @@ extern char *s3_prefix;
 extern char *s3_accesskey;
 extern char *s3_secretkey;
 extern char *s3_cainfo;
+extern int	s3_archive_compress;
 
 #define GET_CUR_PROCDATA() \
 	(AssertMacro(MYPROCNUMBER >= 0 && \
@@ -378,6 +383,7 @@ typedef struct ORelOptions
 	int			compress_offset;
 	int			primary_compress_offset;
 	int			toast_compress_offset;
+	bool		wal_update_delta;
 } ORelOptions;
 
 typedef struct OBTOptions
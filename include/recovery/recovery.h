@@ -45,12 +45,16 @@ extern int	recovery_queue_size_guc;
 extern int	recovery_pool_size_guc;
 extern int	recovery_idx_pool_size_guc;
 extern int	recovery_parallel_indices_rebuild_limit_guc;
+extern bool recovery_batch_apply_guc;
 extern OXid recovery_oxid;
 
 typedef struct BTreeDescr BTreeDescr;
 
 extern OTuple recovery_rec_insert(BTreeDescr *desc, OTuple tuple, bool *allocated, int *size);
 extern OTuple recovery_rec_update(BTreeDescr *desc, OTuple tuple, bool *allocated, int *size);
+extern OTuple recovery_rec_update_delta(BTreeDescr *desc, OTuple tuple,
+										OTuple oldTuple, bool *allocated,
+										int *size);
 extern OTuple recovery_rec_delete(BTreeDescr *desc, OTuple tuple, bool *allocated, int *size);
 extern OTuple recovery_rec_delete_key(BTreeDescr *desc, OTuple key, bool *allocated, int *size);
 
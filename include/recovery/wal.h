@@ -30,6 +30,7 @@
 #define WAL_REC_ROLLBACK_TO_SAVEPOINT (11)
 #define WAL_REC_JOINT_COMMIT (12)
 #define WAL_REC_TRUNCATE	(13)
+#define WAL_REC_UPDATE_DELTA (14)
 
 /* Constants for commitInProgressXlogLocation */
 #define OWalTmpCommitPos			(0)
@@ -109,7 +110,19 @@ typedef struct
 	uint8		relnode[sizeof(Oid)];
 } WALRecTruncate;
 
+/*
+ * Header of the container compressed with orioledb.wal_compress.  It's
+ * followed by zstd frame of compressedLength bytes and zero padding.
+ */
+typedef struct
+{
+	uint8		rawLength[sizeof(uint16)];
+	uint8		compressedLength[sizeof(uint16)];
+} WALContainerCompressed;
+
 #define LOCAL_WAL_BUFFER_SIZE	(8192)
+/* Smaller containers are never compressed */
+#define WAL_COMPRESS_MIN_LENGTH	(128)
 #define ORIOLEDB_WAL_PREFIX	"o_wal"
 #define ORIOLEDB_WAL_PREFIX_SIZE (5)
 
@@ -127,13 +140,34 @@ extern XLogRecPtr wal_joint_commit(OXid oxid, TransactionId logicalXid,
 								   TransactionId xid);
 extern void wal_after_commit(void);
 extern void wal_rollback(OXid oxid, TransactionId logicalXid);
-extern XLogRecPtr log_logical_wal_container(Pointer ptr, int length);
+extern XLogRecPtr log_logical_wal_container(Pointer ptr, int length,
+											 int nrecords);
+extern Pointer wal_container_decompress(Pointer data, int *length);
 extern void o_wal_insert(BTreeDescr *desc, OTuple tuple);
 extern void o_wal_update(BTreeDescr *desc, OTuple tuple);
+extern void o_wal_update_delta(BTreeDescr *desc, OTuple tuple,
+							   OTuple oldTuple);
 extern void o_wal_delete(BTreeDescr *desc, OTuple tuple);
 extern void o_wal_delete_key(BTreeDescr *desc, OTuple key);
 extern void add_truncate_wal_record(ORelOids oids);
 extern bool get_local_wal_has_material_changes(void);
 extern void set_local_wal_has_material_changes(bool value);
 
+/*
+ * Returns the position of the record within the container started at
+ * containerPtr.  Uncompressed containers use the record offset.  Records of
+ * a compressed container are numbered instead: the offsets within the raw
+ * data might exceed the container length.  Writer pads the compressed
+ * container to keep the numbered positions inside it, and leaves a gap
+ * after each of them for the positions following the record.
+ */
+static inline XLogRecPtr
+wal_container_rec_ptr(XLogRecPtr containerPtr, bool compressed,
+					  int recno, int offset)
+{
+	if (compressed)
+		return containerPtr + 2 * recno;
+	return containerPtr + offset;
+}
+
 #endif							/* __WAL_H__ */
@@ -19,6 +19,17 @@
 
 #define O_SHA256_DIGEST_STRING_LENGTH	(SHA256_DIGEST_LENGTH * 2 + 1)
 
+/*
+ * File attributes used to detect unchanged files without reading them.  Zero
+ * mtime means that attributes are unknown or can't be trusted.
+ */
+typedef struct S3FileStat
+{
+	uint64		size;
+	int64		mtime;
+	uint64		inode;
+} S3FileStat;
+
 typedef struct S3FileChecksum
 {
 	char		filename[MAXPGPATH];
@@ -27,6 +38,8 @@ typedef struct S3FileChecksum
 	bool		changed;		/* true if the checksum changed since last
 								 * checkpoint */
 	uint32		checkpointNumber;
+	S3FileStat	stat;			/* attributes of the file when the checksum
+								 * was calculated */
 } S3FileChecksum;
 
 typedef struct S3ChecksumState
@@ -46,8 +59,12 @@ extern S3ChecksumState *makeS3ChecksumState(uint32 checkpointNumber,
 extern void freeS3ChecksumState(S3ChecksumState *state);
 extern void flushS3ChecksumState(S3ChecksumState *state, const char *filename);
 
+extern S3FileChecksum *getS3FileChecksumUnchanged(S3ChecksumState *state,
+												  const char *filename,
+												  S3FileStat *fileStat);
 extern S3FileChecksum *getS3FileChecksum(S3ChecksumState *state,
 										 const char *filename,
-										 Pointer data, uint64 size);
+										 Pointer data, uint64 size,
+										 S3FileStat *fileStat);
 
 #endif							/* __S3_CHECKSUM_H__ */
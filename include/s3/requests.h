@@ -18,7 +18,12 @@
 #define S3_RESPONSE_CONDITION_CONFLICT	409
 #define S3_RESPONSE_CONDITION_FAILED	412
 
+/* Suffix of the objects compressed by s3_put_file_compressed() */
+#define S3_COMPRESSED_SUFFIX			".zst"
+
 extern long s3_put_file(char *objectname, char *filename, bool ifNoneMatch);
+extern long s3_put_file_compressed(char *objectname, char *filename,
+								   OCompress lvl);
 extern void s3_get_file(char *objectname, char *filename);
 extern void s3_put_empty_dir(char *objectname);
 extern long s3_put_file_part(char *objectname, char *filename, int partnum);
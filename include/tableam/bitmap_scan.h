@@ -18,8 +18,10 @@
 #include "tableam/scan.h"
 
 #include "lib/rbtree.h"
+#include "utils/dsa.h"
 
 typedef struct OBitmapScan OBitmapScan;
+typedef struct OParallelBitmapScanData OParallelBitmapScan;
 
 typedef struct OBitmapHeapPlanState
 {
@@ -33,6 +35,8 @@ typedef struct OBitmapHeapPlanState
 	MemoryContext cxt;
 	OBitmapScan *scan;
 	OEACallsCounters *eaCounters;
+	/* shared state of parallel scan, NULL if scan isn't parallel */
+	OParallelBitmapScan *pstate;
 } OBitmapHeapPlanState;
 
 extern OBitmapScan *o_make_bitmap_scan(OBitmapHeapPlanState *bitmap_state,
@@ -43,6 +47,13 @@ extern OBitmapScan *o_make_bitmap_scan(OBitmapHeapPlanState *bitmap_state,
 extern TupleTableSlot *o_exec_bitmap_fetch(OBitmapScan *scan,
 										   CustomScanState *node);
 extern void o_free_bitmap_scan(OBitmapScan *scan);
+extern Size o_bitmap_scan_estimate_dsm(void);
+extern void o_bitmap_scan_initialize_dsm(OBitmapHeapPlanState *bitmap_state,
+										 void *coordinate);
+extern void o_bitmap_scan_reinitialize_dsm(OBitmapHeapPlanState *bitmap_state,
+										   Relation rel, dsa_area *dsa);
+extern void o_bitmap_scan_initialize_worker(OBitmapHeapPlanState *bitmap_state,
+											void *coordinate);
 
 extern RBTree *o_keybitmap_create(void);
 extern void o_keybitmap_insert(RBTree *rbtree, uint64 value);
@@ -53,5 +64,8 @@ extern bool o_keybitmap_is_empty(RBTree *rbtree);
 extern bool o_keybitmap_test(RBTree *rbtree, uint64 value);
 extern bool o_keybitmap_range_is_valid(RBTree *rbtree, uint64 low, uint64 high);
 extern uint64 o_keybitmap_get_next(RBTree *rbtree, uint64 prev, bool *found);
+extern Size o_keybitmap_serialized_size(RBTree *rbtree);
+extern void o_keybitmap_serialize(RBTree *rbtree, Pointer ptr);
+extern RBTree *o_keybitmap_deserialize(Pointer ptr);
 
 #endif							/* __TABLEAM_BITMAP_SCAN_H__ */
@@ -120,6 +120,9 @@ struct OIndexDescr
 	TupleDesc	leafTupdesc;
 	OTupleFixedFormatSpec leafSpec;
 
+	/* Deforming program for leaf tuples, built on demand */
+	OTupleDeformProgram *leafDeform;
+
 	/*
 	 * Flag to indicate unique index and number of unique fields for unique
 	 * index.
@@ -248,6 +251,7 @@ extern OIndexDescr *o_fetch_index_descr(ORelOids oids, OIndexType type,
 extern void recreate_table_descr_by_oids(ORelOids oids);
 extern void o_fill_tmp_table_descr(OTableDescr *descr, OTable *o_table);
 extern void o_free_tmp_table_descr(OTableDescr *descr);
+extern OTupleDeformProgram *o_index_get_leaf_deform(OIndexDescr *descr);
 
 static inline bool
 is_explain_analyze(PlanState *ps)
@@ -17,6 +17,44 @@
 #include "tableam/scan.h"
 
 #include "access/sdir.h"
+#include "storage/spin.h"
+
+/*
+ * Simple qual of form "column op constant", which is evaluated directly on
+ * the primary index tuple before storing it into the slot.
+ */
+typedef struct OTupleQual
+{
+	AttrNumber	attnum;			/* table attribute number */
+	bool		varOnLeft;
+	Oid			collation;
+	Datum		constval;
+	FmgrInfo	finfo;
+} OTupleQual;
+
+typedef enum
+{
+	OParallelIndexScanNotStarted,
+	OParallelIndexScanInProgress,
+	OParallelIndexScanFinished
+} OParallelIndexScanStatus;
+
+/*
+ * Shared state of parallel index scan.  Participants split the key range
+ * into chunks covering O_PARALLEL_INDEX_SCAN_CHUNK downlinks of level-1
+ * pages.  `nextKey` is the low key of the next chunk to be claimed.
+ */
+typedef struct OParallelIndexScanData
+{
+	slock_t		mutex;
+	OParallelIndexScanStatus status;
+	uint64		version;		/* incremented on each claim */
+	OFixedShmemKey nextKey;
+} OParallelIndexScanData;
+
+typedef OParallelIndexScanData *OParallelIndexScan;
+
+#define O_PARALLEL_INDEX_SCAN_CHUNK	8
 
 typedef struct OScanState
 {
@@ -37,6 +75,21 @@ typedef struct OScanState
 	/* used only by direct modify functions */
 	CmdType		cmd;
 	OSnapshot	oSnapshot;
+	/* quals checked before the tuple is deformed */
+	OTupleQual *tupleQuals;
+	int			numTupleQuals;
+	/* the whole scan qual, set if tupleQuals are excluded from ps.qual */
+	ExprState  *fullQual;
+	/* late materialization counters for EXPLAIN ANALYZE */
+	uint64		rowsSkipped;
+	uint64		rowsDeformed;
+	uint64		attrsDeformed;
+	/* parallel scan: the key range is split into chunks */
+	bool		parallelChunks;
+	/* parallel scan: the other participant does the whole scan */
+	bool		parallelSkip;
+	/* parallel scan: upper bound of the current chunk */
+	OFixedKey	chunkHigh;
 } OScanState;
 
 typedef struct OIndexPlanState
@@ -67,7 +120,10 @@ extern OTuple o_index_scan_getnext(OTableDescr *descr, OScanState *ostate,
 								   CommitSeqNo *tupleCsn,
 								   bool scan_primary, MemoryContext tupleCxt,
 								   BTreeLocationHint *hint);
+extern void o_init_tuple_quals(OScanState *ostate, ScanState *ss);
 extern TupleTableSlot *o_exec_fetch(OScanState *ostate, ScanState *ss);
+extern void o_explain_deform_counters(OScanState *ostate, ScanState *ss,
+									  ExplainState *es);
 extern bool o_exec_qual(ExprContext *econtext, ExprState *qual,
 						TupleTableSlot *slot);
 extern TupleTableSlot *o_exec_project(ProjectionInfo *projInfo,
@@ -84,5 +140,6 @@ extern void eanalyze_counters_explain(OTableDescr *descr,
 									  ExplainState *es);
 
 extern int	o_get_num_prefix_exact_keys(ScanKey scankey, int nscankeys);
+extern void o_parallel_index_scan_init(OParallelIndexScan pscan);
 
 #endif							/* __TABLEAM_INDEX_SCAN_H__ */
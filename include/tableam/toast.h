@@ -25,6 +25,14 @@
 /* external function used by toast_fetch_datum() */
 extern struct varlena *o_detoast(struct varlena *attr);
 
+/* detoasts several values, fetching the values of the same row at once */
+extern void o_detoast_batch(struct varlena **attrs, struct varlena **results,
+							int n);
+
+/* remembers TOAST pointers of a row to fetch them at once on detoasting */
+extern void o_detoast_set_row(struct varlena **attrs, int n);
+extern void o_detoast_reset_row(void);
+
 /*
  * BTree functions.
  */
@@ -46,9 +46,44 @@ typedef struct
 typedef OTupleHeaderData *OTupleHeader;
 #define SizeOfOTupleHeader MAXALIGN(sizeof(OTupleHeaderData))
 
+/*
+ * Header of the tuple delta relative to the previous tuple version.  It's
+ * followed by the bitmap of changed attributes, the bitmap of non-null
+ * attributes and raw values of changed non-null attributes, each prefixed
+ * with uint16 length.  Delta isn't aligned, read it using memcpy().
+ */
+typedef struct
+{
+	uint32		version;
+	uint16		natts;
+	uint16		len;			/* total length including the header */
+} OTupleDeltaHeader;
+
+/*
+ * Precomputed deforming program for the given tuple descriptor.  Each step
+ * keeps attribute properties needed for deforming, so the deforming loop
+ * doesn't have to look into the tuple descriptor and to branch on them.
+ */
+typedef struct
+{
+	int16		attlen;
+	bool		attbyval;
+	uint8		alignto;		/* alignment in bytes */
+	int32		fixedoff;		/* offset valid until the first null or
+								 * variable-length value, or -1 */
+} OTupleDeformStep;
+
+typedef struct
+{
+	int			natts;
+	OTupleDeformStep steps[FLEXIBLE_ARRAY_MEMBER];
+} OTupleDeformProgram;
+
 /*
  * Works with orioledb table tuples in primary index. It can fetch
- * TOAST pointers from table tuple.
+ * TOAST pointers from table tuple.  Attributes beyond the number stored in
+ * the header of variable-format tuple (e.g. omitted by suffix truncation of
+ * the key) are returned as nulls.
  */
 #define o_fastgetattr(tup, attnum, tupleDesc, spec, isnull)			\
 (																	\
@@ -74,6 +109,12 @@ typedef OTupleHeaderData *OTupleHeader;
 		)															\
 	)																\
 	:																\
+	((attnum) > ((OTupleHeader) (tup).data)->natts) ?				\
+	(																\
+		(*(isnull) = true),											\
+		(Datum) NULL												\
+	)																\
+	:																\
 	(																\
 		(!(((OTupleHeader) (tup).data)->hasnulls)) ?				\
 		(															\
@@ -122,6 +163,11 @@ typedef OTupleHeaderData *OTupleHeader;
 		)															\
 	)																\
 	:																\
+	((attnum) > ((OTupleHeader) (tup).data)->natts) ?				\
+	(																\
+		NULL														\
+	)																\
+	:																\
 	(																\
 		(!(((OTupleHeader) (tup).data)->hasnulls)) ?				\
 		(															\
@@ -174,6 +220,10 @@ typedef OTupleHeaderData *OTupleHeader;
 extern void o_tuple_init_reader(OTupleReaderState *state, OTuple tuple,
 								TupleDesc desc, OTupleFixedFormatSpec *spec);
 extern Datum o_tuple_read_next_field(OTupleReaderState *state, bool *isnull);
+extern OTupleDeformProgram *o_tuple_deform_program_build(TupleDesc desc);
+extern bool o_tuple_deform(OTupleDeformProgram *program,
+						   OTupleReaderState *state, int count,
+						   Datum *values, bool *isnull);
 extern uint32 o_tuple_next_field_offset(OTupleReaderState *state,
 										Form_pg_attribute att);
 extern ItemPointer o_tuple_get_last_iptr(TupleDesc desc,
@@ -199,5 +249,24 @@ extern uint32 o_tuple_get_version(OTuple tuple);
 extern void o_tuple_set_version(OTupleFixedFormatSpec *spec, OTuple *tuple,
 								uint32 version);
 extern void o_tuple_set_ctid(OTuple tuple, ItemPointer iptr);
+extern int	o_tuple_make_delta(TupleDesc desc, OTupleFixedFormatSpec *spec,
+							   OTuple oldTuple, OTuple newTuple,
+							   Pointer delta, int maxLen);
+extern int	o_tuple_delta_length(Pointer delta);
+extern OTuple o_tuple_apply_delta(TupleDesc desc, OTupleFixedFormatSpec *spec,
+								  OTuple base, Pointer delta);
+
+/*
+ * Number of attributes of the non-leaf key.  Suffix-truncated keys have less
+ * attributes than their tuple descriptor, omitted ones are considered to be
+ * minus infinity.  Keys of fixed format are never truncated.
+ */
+static inline int
+o_key_natts(OTuple key, TupleDesc desc)
+{
+	if (key.formatFlags & O_TUPLE_FLAGS_FIXED_FORMAT)
+		return desc->natts;
+	return Min(((OTupleHeader) key.data)->natts, desc->natts);
+}
 
 #endif							/* __TUPLE_FORMAT_H__ */
@@ -160,6 +160,10 @@ extern bool o_toast_delete(OIndexDescr *primary, OIndexDescr *toast,
 extern Pointer o_toast_get(OIndexDescr *primary, OIndexDescr *toast,
 						   OTuple pk, uint16 attn, Size data_size,
 						   OSnapshot *snapshot);
+extern void o_toast_get_batch(OIndexDescr *primary, OIndexDescr *toast,
+							  OTuple pk, int nattrs, uint16 *attnums,
+							  Size *data_sizes, Pointer *results,
+							  OSnapshot *snapshot);
 
 extern int	o_toast_cmp(BTreeDescr *desc, void *p1, BTreeKeyType k1,
 						void *p2, BTreeKeyType k2);
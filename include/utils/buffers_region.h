@@ -0,0 +1,44 @@
+/*-------------------------------------------------------------------------
+ *
+ * buffers_region.h
+ *		Declarations for the separately allocated region of orioledb page
+ *		buffers.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/include/utils/buffers_region.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef __BUFFERS_REGION_H__
+#define __BUFFERS_REGION_H__
+
+#include "utils/guc.h"
+
+typedef enum
+{
+	OBuffersHugePagesOff = 0,
+	OBuffersHugePagesTry,
+	OBuffersHugePagesOn
+} OBuffersHugePages;
+
+typedef enum
+{
+	OBuffersNumaOff = 0,
+	OBuffersNumaInterleave,
+	OBuffersNumaBind
+} OBuffersNuma;
+
+extern const struct config_enum_entry buffers_huge_pages_options[];
+extern const struct config_enum_entry buffers_numa_options[];
+
+extern int	buffers_huge_pages;
+extern int	buffers_huge_page_size;
+extern int	buffers_numa;
+extern char *buffers_numa_nodes;
+
+extern bool buffers_region_enabled(void);
+extern Pointer buffers_region_get(Size size);
+
+#endif							/* __BUFFERS_REGION_H__ */
@@ -16,6 +16,12 @@
 extern void o_compress_init(void);
 extern Pointer o_compress_page(Pointer page, size_t *size, OCompress lvl);
 extern void o_decompress_page(Pointer src, size_t size, Pointer page);
+extern Pointer o_compress_buffer(Pointer src, size_t size,
+								 size_t *result_size, OCompress lvl);
+extern void o_decompress_buffer(Pointer src, size_t size, Pointer dst,
+								size_t dst_size);
+extern Pointer o_compress_data(Pointer src, size_t size,
+							   size_t *result_size, OCompress lvl);
 extern OCompress o_compress_max_lvl(void);
 extern void validate_compress(OCompress compress, char *prefix);
 
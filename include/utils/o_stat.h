@@ -0,0 +1,119 @@
+/*-------------------------------------------------------------------------
+ *
+ * o_stat.h
+ *		Declarations of OrioleDB cumulative I/O and eviction statistics.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/include/utils/o_stat.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef __O_STAT_H__
+#define __O_STAT_H__
+
+#include "btree/btree.h"
+
+#include "access/xact.h"
+#include "portability/instr_time.h"
+
+/* Kinds of waits accounted by o_stat_wait_start()/o_stat_wait_end() */
+typedef enum OStatWaitKind
+{
+	OStatWaitPageLock = 0,		/* lock_page() */
+	OStatWaitPageRead,			/* page_wait_for_read_enable() */
+	OStatWaitPageSplit,			/* relock_page() waiting for split completion */
+	OStatWaitIO,				/* wait_for_io_completion() */
+	OStatWaitKindsNum
+} OStatWaitKind;
+
+/*
+ * Wait time histogram buckets.  Bucket i holds waits shorter than
+ * 16 * 4^i microseconds, the last one holds all the longer waits.
+ */
+#define O_STAT_WAIT_BUCKETS		8
+
+/* Counters of each wait kind: waits, sampled waits, sampled time, buckets */
+#define O_STAT_WAIT_WAITS		0
+#define O_STAT_WAIT_SAMPLED		1
+#define O_STAT_WAIT_TIME		2
+#define O_STAT_WAIT_HIST		3
+#define O_STAT_WAIT_COUNTERS	(O_STAT_WAIT_HIST + O_STAT_WAIT_BUCKETS)
+
+/*
+ * Cumulative counters.  The same set is kept for each tree and for the whole
+ * instance.  Undo, WAL and S3 checkpoint counters are global-only.  Wait
+ * counters follow the regular ones, O_STAT_WAIT_COUNTERS for each wait kind.
+ */
+typedef enum OStatCounter
+{
+	OStatPageLoads = 0,			/* pages read from data files */
+	OStatBytesRead,				/* bytes read from data files */
+	OStatS3PartLoads,			/* data file parts downloaded from S3 */
+	OStatEvictionsClean,		/* evictions of clean pages */
+	OStatEvictionsDirty,		/* evictions requiring a write */
+	OStatEvictionsOnDemand,		/* evictions to get free pages */
+	OStatEvictionsBGWriter,		/* evictions by orioledb bgwriter */
+	OStatEvictionsExplicit,		/* evictions by orioledb_evict_pages() */
+	OStatEvictionsTree,			/* trees evicted together with their root */
+	OStatWritesBackend,			/* pages written by regular backends */
+	OStatWritesBGWriter,		/* pages written by orioledb bgwriter */
+	OStatWritesCheckpointer,	/* pages written by checkpointer */
+	OStatBytesWritten,			/* bytes written to data files */
+	OStatBytesUncompressed,		/* uncompressed size of written pages */
+	OStatUndoBytes,				/* undo records generated */
+	OStatUndoBytesWritten,		/* undo bytes spilled to disk */
+	OStatWalBytes,				/* uncompressed size of WAL containers */
+	OStatWalBytesWritten,		/* WAL container bytes written to WAL */
+	OStatWalCompressTime,		/* microseconds spent compressing WAL */
+	OStatWalDecompressTime,		/* microseconds spent decompressing WAL */
+	OStatS3FilesHashed,			/* PGDATA files hashed by S3 checkpoints */
+	OStatS3BytesHashed,			/* bytes of PGDATA files hashed */
+	OStatS3FilesSkipped,		/* PGDATA files skipped as unchanged */
+	OStatWaitFirst,				/* first of the wait counters */
+	OStatCountersNum = OStatWaitFirst + OStatWaitKindsNum * O_STAT_WAIT_COUNTERS
+} OStatCounter;
+
+/* State of the wait in progress */
+typedef struct
+{
+	bool		sampled;
+	instr_time	start;
+} OStatWait;
+
+extern int	o_stat_max_trees;
+extern int	o_stat_wait_sample_interval;
+
+extern Size o_stat_shmem_needs(void);
+extern void o_stat_shmem_init(Pointer ptr, bool found);
+
+extern void o_stat_count(Oid datoid, Oid relnode, OStatCounter counter,
+						 uint64 value);
+extern void o_stat_count_write(BTreeDescr *desc, uint64 bytesWritten);
+extern void o_stat_count_eviction(BTreeDescr *desc, bool dirty,
+								  bool requested);
+extern void o_stat_drop_tree(Oid datoid, Oid relnode);
+extern void o_stat_flush(void);
+extern uint64 o_stat_global_read(OStatCounter counter);
+extern void o_stat_xact_callback(XactEvent event, void *arg);
+extern uint32 o_stat_wait_event(OStatWaitKind kind);
+extern void o_stat_wait_start(OStatWait *wait);
+extern void o_stat_wait_end(OStatWait *wait, Oid datoid, Oid relnode,
+							OStatWaitKind kind);
+
+/* Counts the event for the tree */
+static inline void
+o_stat_tree_count(BTreeDescr *desc, OStatCounter counter, uint64 value)
+{
+	o_stat_count(desc->oids.datoid, desc->oids.relnode, counter, value);
+}
+
+/* Counts the event which isn't attributed to any tree */
+static inline void
+o_stat_global_count(OStatCounter counter, uint64 value)
+{
+	o_stat_count(InvalidOid, InvalidOid, counter, value);
+}
+
+#endif							/* __O_STAT_H__ */
@@ -36,12 +36,31 @@
 #define PPOOL_RESERVE_MASK_ALL (PPOOL_RESERVE_META_MASK | PPOOL_RESERVE_INSERT_MASK \
 								| PPOOL_RESERVE_FIND_MASK | PPOOL_RESERVE_SHARED_INFO_INSERT_MASK)
 
+/*
+ * Shared counters of page lending between the pools and of the pool pressure.
+ */
+typedef struct
+{
+	/* count of pool pages currently occupied by the other pools */
+	pg_atomic_uint32 lentPagesCount;
+	/* count of the other pools pages currently occupied by this pool */
+	pg_atomic_uint32 borrowedPagesCount;
+	/* total count of pages borrowed from the other pools */
+	pg_atomic_uint64 borrowsCount;
+	/* total count of pages evicted by the clock of the pool */
+	pg_atomic_uint64 evictionsCount;
+} OPagePoolCounters;
+
 struct OPagePool
 {
+	/* type of the pool */
+	OPagePoolType type;
 	/* count of available to reserve pages in the pool */
 	pg_atomic_uint64 *availablePagesCount;
 	/* count of dirty pages in the pool */
 	pg_atomic_uint32 *dirtyPagesCount;
+	/* lending and pressure counters */
+	OPagePoolCounters *counters;
 	/* init position for the ucm */
 	OInMemoryBlkno location;
 	/* offset of the pool in the o_shared_buffers */
@@ -50,6 +69,8 @@ struct OPagePool
 	OInMemoryBlkno size;
 	/* reserved pages count by type array */
 	OInMemoryBlkno numPagesReserved[PPOOL_RESERVE_COUNT];
+	/* part of numPagesReserved reserved in the main pool */
+	OInMemoryBlkno numPagesBorrowed[PPOOL_RESERVE_COUNT];
 	/* usage counter map and their size in shared memory */
 	UsageCountMap ucm;
 	Size		ucmShmemSize;
@@ -57,7 +78,9 @@ struct OPagePool
 	pg_prng_state prngSeed;
 };
 
-extern Size ppool_estimate_space(OPagePool *pool, OInMemoryBlkno offset, OInMemoryBlkno size, bool debug);
+extern bool ppool_adaptive_buffers;
+
+extern Size ppool_estimate_space(OPagePool *pool, OPagePoolType type, OInMemoryBlkno offset, OInMemoryBlkno size, bool debug);
 extern void ppool_shmem_init(OPagePool *pool, Pointer ptr, bool found);
 extern OInMemoryBlkno ppool_free_pages_count(OPagePool *pool);
 extern OInMemoryBlkno ppool_dirty_pages_count(OPagePool *pool);
@@ -76,6 +99,14 @@ extern void ppool_free_page(OPagePool *pool, OInMemoryBlkno blkno, bool haveLock
 											 * detect changes concurrent to
 											 * write operatorions */
 #define PAGE_DESC_FLAG_BOTH_DIRTY		(PAGE_DESC_FLAG_DIRTY | PAGE_DESC_FLAG_CONCURRENT_DIRTY)
+/*
+ * Type of the pool, which borrowed the page from the main pool.  Zero for
+ * the pages used by the pool they belong to.
+ */
+#define PAGE_DESC_BORROWER_SHIFT		2
+#define PAGE_DESC_BORROWER_MASK			(3 << PAGE_DESC_BORROWER_SHIFT)
+#define PAGE_DESC_GET_BORROWER(page_desc) \
+	(((page_desc)->flags & PAGE_DESC_BORROWER_MASK) >> PAGE_DESC_BORROWER_SHIFT)
 #define IS_DIRTY(blkno) (O_GET_IN_MEMORY_PAGEDESC(blkno)->flags & PAGE_DESC_FLAG_DIRTY)
 #define IS_DIRTY_CONCURRENT(blkno) (O_GET_IN_MEMORY_PAGEDESC(blkno)->flags & PAGE_DESC_FLAG_CONCURRENT_DIRTY)
 #define CLEAN_DIRTY_CONCURRENT(blkno) (O_GET_IN_MEMORY_PAGEDESC(blkno)->flags &= ~PAGE_DESC_FLAG_CONCURRENT_DIRTY)
@@ -90,7 +121,7 @@ extern void ppool_free_page(OPagePool *pool, OInMemoryBlkno blkno, bool haveLock
 		} \
 		if (!IS_DIRTY(blkno)) { \
 			O_GET_IN_MEMORY_PAGEDESC(blkno)->flags |= PAGE_DESC_FLAG_BOTH_DIRTY; \
-			pg_atomic_fetch_add_u32((desc)->ppool->dirtyPagesCount, 1); \
+			pg_atomic_fetch_add_u32(get_ppool_by_blkno(blkno)->dirtyPagesCount, 1); \
 		} \
 		else if (!IS_DIRTY_CONCURRENT(blkno)) \
 		{ \
@@ -102,10 +133,14 @@ extern void ppool_free_page(OPagePool *pool, OInMemoryBlkno blkno, bool haveLock
 #define MARK_DIRTY(desc, blkno) \
 	MARK_DIRTY_EXTENDED(desc, blkno, false)
 
+/*
+ * Dirty pages are accounted in the pool the page belongs to, which might
+ * differ from the pool of the tree for the borrowed pages.
+ */
 #define CLEAN_DIRTY(pool, blkno) \
 	if (IS_DIRTY(blkno)) { \
 		O_GET_IN_MEMORY_PAGEDESC(blkno)->flags &= ~PAGE_DESC_FLAG_BOTH_DIRTY; \
-		pg_atomic_fetch_sub_u32((pool)->dirtyPagesCount, 1); \
+		pg_atomic_fetch_sub_u32(get_ppool_by_blkno(blkno)->dirtyPagesCount, 1); \
 	}
 
 #define FREE_PAGE_IF_VALID(pool, blkno) \
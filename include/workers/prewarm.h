@@ -0,0 +1,27 @@
+/*-------------------------------------------------------------------------
+ *
+ * prewarm.h
+ *		Routines for automatic warm-up of OrioleDB page pool.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/include/workers/prewarm.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef __PREWARM_H__
+#define __PREWARM_H__
+
+#define AUTOPREWARM_FILENAME	ORIOLEDB_DATA_DIR "/autoprewarm"
+
+extern bool orioledb_autoprewarm;
+extern int	autoprewarm_interval;
+extern int	autoprewarm_workers;
+
+extern void register_autoprewarm(void);
+extern int64 autoprewarm_dump(void);
+PGDLLEXPORT void autoprewarm_main(Datum);
+PGDLLEXPORT void autoprewarm_worker_main(Datum);
+
+#endif							/* __PREWARM_H__ */
@@ -15,6 +15,11 @@ from threading import Event
 from typing import Callable
 from urllib.parse import urlparse
 
+try:
+	import zstandard
+except ImportError:
+	zstandard = None
+
 
 class OrioledbS3ObjectLoader:
 
@@ -141,24 +146,57 @@ class OrioledbS3ObjectLoader:
 		orioledb_control = get_orioledb_control_data(self.data_dir)
 		self.download_undo(orioledb_control['undoRegularStartLocation'],
 		                   orioledb_control['undoRegularEndLocation'],
-		                   "orioledb_data/%02X%08Xdata")
+		                   "orioledb_undo/%02X%08Xrow")
 		self.download_undo(orioledb_control['undoSystemStartLocation'],
 		                   orioledb_control['undoSystemEndLocation'],
-		                   "orioledb_data/%02X%08Xsystem")
+		                   "orioledb_undo/%02X%08Xsystem")
 		wal_file = control["Latest checkpoint's REDO WAL file"]
 		local_path = os.path.join(self.data_dir, f"pg_wal/{wal_file}")
 		wal_file = os.path.join(self.prefix, f"wal/{wal_file}")
-		self.download_file(self.bucket_name, wal_file, local_path)
+		self.download_archive_file(self.bucket_name, wal_file, local_path)
 
 	def download_undo(self, startLocation, endLocation, template):
 		UNDO_FILE_SIZE = 0x4000000
 		if startLocation >= endLocation:
 			return
 		for fileNum in range(startLocation // UNDO_FILE_SIZE,
-		                     (endLocation - 1) // UNDO_FILE_SIZE):
+		                     (endLocation - 1) // UNDO_FILE_SIZE + 1):
 			fileName = template % (fileNum >> 32, fileNum & 0xFFFFFFFF)
+			local_path = os.path.join(self.data_dir, fileName)
 			fileName = os.path.join(self.prefix, fileName)
-			loader.download_file(self.bucket_name, fileName, fileName)
+			self.download_archive_file(self.bucket_name, fileName, local_path)
+
+	# WAL and undo files might be archived compressed with
+	# orioledb.s3_archive_compress.  Such objects have the suffix below.
+	COMPRESSED_SUFFIX = '.zst'
+
+	def download_archive_file(self, bucket_name, file_key,
+	                          local_path) -> bool:
+		compressed_key = file_key + self.COMPRESSED_SUFFIX
+		try:
+			self.s3.head_object(Bucket=bucket_name, Key=compressed_key)
+		except ClientError as e:
+			if e.response['Error']['Code'] in ("404", "NoSuchKey"):
+				return self.download_file(bucket_name, file_key, local_path)
+			raise
+
+		compressed_path = local_path + self.COMPRESSED_SUFFIX
+		if not self.download_file(bucket_name, compressed_key,
+		                          compressed_path):
+			return False
+
+		if zstandard is None:
+			raise Exception(f"{compressed_key} is compressed, "
+			                "install zstandard python module to load it")
+		with open(compressed_path, 'rb') as src:
+			with open(local_path, 'wb') as dst:
+				zstandard.ZstdDecompressor().copy_stream(src, dst)
+		os.chmod(local_path, 0o600)
+		os.unlink(compressed_path)
+		if self.verbose:
+			print(f"{compressed_key} -> {local_path} (decompressed)",
+			      flush=True)
+		return True
 
 	def last_checkpoint_number(self, bucket_name):
 		paginator = self.s3.get_paginator('list_objects_v2')
@@ -494,7 +532,7 @@ class OrioledbS3ObjectLoader:
 	                                 chkp_num: int) -> dict[str, str]:
 		res = {}
 
-		pattern_str = r"^FILE: (?P<filename>.+), CHECKSUM: (?P<checksum>.+), CHECKPOINT: (?P<checkpoint>\d+)$"
+		pattern_str = r"^FILE: (?P<filename>.+), CHECKSUM: (?P<checksum>[^,]+), CHECKPOINT: (?P<checkpoint>\d+)(?:, SIZE: \d+, MTIME: \d+, INODE: \d+)?$"
 		pattern = re.compile(pattern_str)
 		with open(file_checksums_name) as file:
 			for line in file:
@@ -543,11 +581,13 @@ def get_orioledb_control_data(data_dir: str):
 	"""
 
 	f = open(f"{data_dir}/orioledb_data/control", 'rb')
-	data = f.read(8 * 13)
+	data = f.read(8 * 18)
+	# CheckpointControl.undoInfo[] of UndoLogRegular and UndoLogSystem:
+	# checkpointRetainStartLocation and checkpointRetainEndLocation
 	(undoRegularStartLocation,
-	 undoRegularEndLocation) = struct.unpack('QQ', data[8 * 8:8 * 10])
+	 undoRegularEndLocation) = struct.unpack('QQ', data[8 * 10:8 * 12])
 	(undoSystemStartLocation,
-	 undoSystemEndLocation) = struct.unpack('QQ', data[8 * 11:8 * 13])
+	 undoSystemEndLocation) = struct.unpack('QQ', data[8 * 16:8 * 18])
 	f.close()
 
 	dict = {
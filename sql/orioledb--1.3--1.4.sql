@@ -0,0 +1,169 @@
+/* contrib/orioledb/sql/orioledb--1.3--1.4.sql */
+
+-- complain if script is sourced in psql, rather than via CREATE EXTENSION
+\echo Use "ALTER EXTENSION orioledb UPDATE TO '1.4'" to load this file. \quit
+
+CREATE FUNCTION orioledb_get_stat_global(OUT page_loads int8,
+										 OUT bytes_read int8,
+										 OUT s3_part_loads int8,
+										 OUT evictions_clean int8,
+										 OUT evictions_dirty int8,
+										 OUT evictions_on_demand int8,
+										 OUT evictions_bgwriter int8,
+										 OUT evictions_explicit int8,
+										 OUT evictions_tree int8,
+										 OUT writes_backend int8,
+										 OUT writes_bgwriter int8,
+										 OUT writes_checkpointer int8,
+										 OUT bytes_written int8,
+										 OUT bytes_uncompressed int8,
+										 OUT undo_bytes int8,
+										 OUT undo_bytes_written int8,
+										 OUT wal_bytes int8,
+										 OUT wal_bytes_written int8,
+										 OUT wal_compress_us int8,
+										 OUT wal_decompress_us int8,
+										 OUT s3_files_hashed int8,
+										 OUT s3_bytes_hashed int8,
+										 OUT s3_files_skipped int8,
+										 OUT stats_reset timestamptz)
+RETURNS record
+AS 'MODULE_PATHNAME'
+VOLATILE LANGUAGE C;
+
+CREATE FUNCTION orioledb_get_stat_trees(OUT datoid oid,
+										OUT relnode oid,
+										OUT page_loads int8,
+										OUT bytes_read int8,
+										OUT s3_part_loads int8,
+										OUT evictions_clean int8,
+										OUT evictions_dirty int8,
+										OUT evictions_on_demand int8,
+										OUT evictions_bgwriter int8,
+										OUT evictions_explicit int8,
+										OUT evictions_tree int8,
+										OUT writes_backend int8,
+										OUT writes_bgwriter int8,
+										OUT writes_checkpointer int8,
+										OUT bytes_written int8,
+										OUT bytes_uncompressed int8)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+VOLATILE LANGUAGE C;
+
+CREATE FUNCTION orioledb_stat_reset()
+RETURNS void
+AS 'MODULE_PATHNAME'
+VOLATILE LANGUAGE C;
+
+CREATE VIEW orioledb_stat_global AS
+  SELECT s.*,
+         CASE WHEN s.bytes_written > 0
+              THEN s.bytes_uncompressed::float8 / s.bytes_written
+         END AS compression_ratio,
+         CASE WHEN s.wal_bytes_written > 0
+              THEN s.wal_bytes::float8 / s.wal_bytes_written
+         END AS wal_compression_ratio
+  FROM orioledb_get_stat_global() s;
+
+CREATE VIEW orioledb_stat_trees AS
+  SELECT s.datoid,
+         i.table_reloid,
+         i.index_reloid,
+         s.relnode,
+         i.index_type,
+         s.page_loads,
+         s.bytes_read,
+         s.s3_part_loads,
+         s.evictions_clean,
+         s.evictions_dirty,
+         s.evictions_on_demand,
+         s.evictions_bgwriter,
+         s.evictions_explicit,
+         s.evictions_tree,
+         s.writes_backend,
+         s.writes_bgwriter,
+         s.writes_checkpointer,
+         s.bytes_written,
+         s.bytes_uncompressed,
+         CASE WHEN s.bytes_written > 0
+              THEN s.bytes_uncompressed::float8 / s.bytes_written
+         END AS compression_ratio
+  FROM orioledb_get_stat_trees() s
+  LEFT JOIN orioledb_index_oids() i
+    ON i.datoid = s.datoid AND i.index_relnode = s.relnode;
+
+CREATE FUNCTION orioledb_get_stat_waits(OUT datoid oid,
+										OUT relnode oid,
+										OUT wait_kind text,
+										OUT waits int8,
+										OUT sampled_waits int8,
+										OUT sampled_wait_us int8,
+										OUT wait_histogram int8[])
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+VOLATILE LANGUAGE C;
+
+CREATE VIEW orioledb_stat_waits AS
+  SELECT s.datoid,
+         i.table_reloid,
+         i.index_reloid,
+         s.relnode,
+         i.index_type,
+         s.wait_kind,
+         s.waits,
+         s.sampled_waits,
+         s.sampled_wait_us,
+         CASE WHEN s.sampled_waits > 0
+              THEN s.sampled_wait_us::float8 / s.sampled_waits
+         END AS avg_wait_us,
+         s.wait_histogram
+  FROM orioledb_get_stat_waits() s
+  LEFT JOIN orioledb_index_oids() i
+    ON i.datoid = s.datoid AND i.index_relnode = s.relnode;
+
+CREATE FUNCTION orioledb_autoprewarm_dump()
+RETURNS int8
+AS 'MODULE_PATHNAME'
+VOLATILE LANGUAGE C;
+
+CREATE FUNCTION orioledb_get_page_pools(OUT pool_name text,
+										OUT all_pages int8,
+										OUT lent_pages int8,
+										OUT borrowed_pages int8,
+										OUT free_pages int8,
+										OUT dirty_pages int8,
+										OUT borrows int8,
+										OUT evictions int8)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+VOLATILE LANGUAGE C;
+
+CREATE VIEW orioledb_page_pools AS
+  SELECT s.pool_name,
+         s.all_pages,
+         s.all_pages - s.lent_pages + s.borrowed_pages AS current_pages,
+         s.lent_pages,
+         s.borrowed_pages,
+         s.free_pages,
+         s.dirty_pages,
+         s.borrows,
+         s.evictions
+  FROM orioledb_get_page_pools() s;
+
+CREATE FUNCTION orioledb_get_recovery_workers(OUT worker_id int4,
+											  OUT commit_lsn pg_lsn,
+											  OUT applied_modifies int8,
+											  OUT sorted_batches int8,
+											  OUT sorted_modifies int8,
+											  OUT apply_time float8)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+VOLATILE LANGUAGE C;
+
+CREATE VIEW orioledb_recovery_workers AS
+  SELECT s.*,
+         CASE WHEN s.apply_time > 0
+              THEN s.applied_modifies * 1000.0 / s.apply_time
+         END AS apply_rate
+  FROM orioledb_get_recovery_workers() s;
@@ -80,7 +80,8 @@ stack_page_split(BTreeDescr *desc, OIndexBuildStackItem *stack, int level,
 	offset = BTREE_PAGE_LOCATOR_GET_OFFSET(img, &stack[level].loc);
 	left_count = btree_page_split_location(desc, img, offset,
 										   tuplesize, tuple, false, offset,
-										   0.9, NULL, COMMITSEQNO_INPROGRESS);
+										   0.9, NULL, NULL,
+										   COMMITSEQNO_INPROGRESS);
 
 
 	/* Distribute the tuples according the the split location */
@@ -440,6 +441,8 @@ btree_write_index_data(BTreeDescr *desc, TupleDesc tupdesc,
 	file_header->numFreeBlocks = pg_atomic_read_u64(&metaPageBlkno.numFreeBlocks);
 	file_header->leafPagesNum = pg_atomic_read_u32(&metaPageBlkno.leafPagesNum);
 	file_header->ctid = pg_atomic_read_u64(&metaPageBlkno.ctid);
+	if (orioledb_btree_suffix_truncation)
+		file_header->flags |= CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION;
 }
 
 S3TaskLocation
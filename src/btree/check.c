@@ -591,7 +591,7 @@ btree_check_compression_recursive(BTreeDescr *desc, BTreeCompressStats *stats, O
 	OrioleDBPageHeader *header = (OrioleDBPageHeader *) p;
 	size_t		compressed_size;
 
-	page_inc_usage_count(&desc->ppool->ucm, blkno,
+	page_inc_usage_count(&(get_ppool_by_blkno(blkno)->ucm), blkno,
 						 pg_atomic_read_u32(&header->usageCount), false);
 
 	context->index++;
@@ -816,6 +816,108 @@ retry:
 	return true;
 }
 
+/*
+ * Try to locate the key for modification on the hinted leaf.  Returns true
+ * with the leaf locked on success.  Returns false and resets the hint if the
+ * hint is outdated or the key doesn't surely belong to the page; then the
+ * caller should use find_page().
+ *
+ * Key surely belongs to the leaf if it isn't less than the first key on the
+ * page, since the page lokey isn't greater than the first key, and it's less
+ * than the page hikey.  If `rightmost` is set, only the rightmost leaf is
+ * accepted.
+ */
+static bool
+find_leaf_by_hint_internal(OBTreeFindPageContext *context, void *key,
+						   BTreeKeyType keyType, BTreeLocationHint *hint,
+						   bool rightmost)
+{
+	BTreeDescr *desc = context->desc;
+	BTreePageItemLocator loc;
+	OrioleDBPageDesc *pageDesc;
+	OInMemoryBlkno blkno = hint->blkno;
+	OTuple		firstTuple;
+	Page		p;
+
+	Assert(BTREE_PAGE_FIND_IS(context, MODIFY));
+
+	if (!OInMemoryBlknoIsValid(blkno) ||
+		hint->pageChangeCount == InvalidOPageChangeCount ||
+		blkno == desc->rootInfo.rootPageBlkno)
+		return false;
+
+	p = O_GET_IN_MEMORY_PAGE(blkno);
+	pageDesc = O_GET_IN_MEMORY_PAGEDESC(blkno);
+	lock_page(blkno);
+
+	if (O_PAGE_GET_CHANGE_COUNT(p) != hint->pageChangeCount ||
+		!ORelOidsIsEqual(pageDesc->oids, desc->oids) ||
+		!O_PAGE_IS(p, LEAF) || (rightmost && !O_PAGE_IS(p, RIGHTMOST)) ||
+		O_PAGE_IS(p, BROKEN_SPLIT) ||
+		RightLinkIsValid(((BTreePageHeader *) p)->rightLink) ||
+		BTREE_PAGE_ITEMS_COUNT(p) == 0)
+	{
+		unlock_page(blkno);
+		hint->blkno = OInvalidInMemoryBlkno;
+		return false;
+	}
+
+	BTREE_PAGE_LOCATOR_FIRST(p, &loc);
+	BTREE_PAGE_READ_LEAF_TUPLE(firstTuple, p, &loc);
+	if (o_btree_cmp(desc, key, keyType, &firstTuple, BTreeKeyLeafTuple) < 0)
+	{
+		unlock_page(blkno);
+		hint->blkno = OInvalidInMemoryBlkno;
+		return false;
+	}
+
+	if (!O_PAGE_IS(p, RIGHTMOST))
+	{
+		OTuple		hikey;
+
+		BTREE_PAGE_GET_HIKEY(hikey, p);
+		if (o_btree_cmp(desc, key, keyType, &hikey, BTreeKeyNonLeafKey) >= 0)
+		{
+			unlock_page(blkno);
+			hint->blkno = OInvalidInMemoryBlkno;
+			return false;
+		}
+	}
+
+	(void) btree_page_search(desc, p, key, keyType, NULL, &loc);
+
+	context->index = 0;
+	context->items[0].locator = loc;
+	context->items[0].blkno = blkno;
+	context->items[0].pageChangeCount = hint->pageChangeCount;
+	return true;
+}
+
+/*
+ * Try to locate the key for modification on the cached rightmost leaf of
+ * the tree.  Appends of monotonically increasing keys always go there, so
+ * the descent from the root could be skipped.
+ *
+ * Once the hint misses, it's reset until the next append found by find_page().
+ */
+bool
+find_rightmost_leaf_by_hint(OBTreeFindPageContext *context, void *key,
+							BTreeKeyType keyType, BTreeLocationHint *hint)
+{
+	return find_leaf_by_hint_internal(context, key, keyType, hint, true);
+}
+
+/*
+ * Try to locate the key for modification on the last modified leaf of the
+ * tree.  Modifications applied in the key order mostly go to the same leaf.
+ */
+bool
+find_leaf_by_hint(OBTreeFindPageContext *context, void *key,
+				  BTreeKeyType keyType, BTreeLocationHint *hint)
+{
+	return find_leaf_by_hint_internal(context, key, keyType, hint, false);
+}
+
 /*
  * Find the right sibling of the current page.
  *
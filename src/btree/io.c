@@ -34,6 +34,7 @@
 #include "tableam/handler.h"
 #include "utils/compress.h"
 #include "utils/elog.h"
+#include "utils/o_stat.h"
 #include "utils/page_pool.h"
 #include "utils/seq_buf.h"
 #include "utils/stopevent.h"
@@ -79,6 +80,8 @@ static LWLockPadded *io_locks;
 static IOShmem *ioShmem = NULL;
 static int	num_io_lwlocks;
 static bool io_in_progress = false;
+/* are we evicting pages for orioledb_evict_pages()? */
+static bool evict_requested = false;
 
 static bool prepare_non_leaf_page(Page p);
 static uint64 get_free_disk_offset(BTreeDescr *desc);
@@ -893,8 +896,18 @@ assign_io_num(OInMemoryBlkno blkno, OffsetNumber offnum)
 void
 wait_for_io_completion(int ionum)
 {
+	OStatWait	wait;
+
+	if (LWLockConditionalAcquire(&io_locks[ionum].lock, LW_SHARED))
+	{
+		LWLockRelease(&io_locks[ionum].lock);
+		return;
+	}
+
+	o_stat_wait_start(&wait);
 	LWLockAcquire(&io_locks[ionum].lock, LW_SHARED);
 	LWLockRelease(&io_locks[ionum].lock);
+	o_stat_wait_end(&wait, InvalidOid, InvalidOid, OStatWaitIO);
 }
 
 /*
@@ -1153,6 +1166,7 @@ read_page_from_disk(BTreeDescr *desc, Pointer img, uint64 downlink,
 	uint64		offset = DOWNLINK_GET_DISK_OFF(downlink);
 	uint32		chkpNum = 0;
 	uint16		len = DOWNLINK_GET_DISK_LEN(downlink);
+	off_t		total_size = 0;
 	bool		err = false;
 
 	Assert(FileExtentOffIsValid(offset));
@@ -1178,6 +1192,7 @@ read_page_from_disk(BTreeDescr *desc, Pointer img, uint64 downlink,
 		read_size = ORIOLEDB_BLCKSZ;
 
 		err = btree_smgr_read(desc, img, chkpNum, read_size, byte_offset) != read_size;
+		total_size += read_size;
 	}
 	else
 	{
@@ -1199,6 +1214,7 @@ read_page_from_disk(BTreeDescr *desc, Pointer img, uint64 downlink,
 			read_size = len * ORIOLEDB_COMP_BLCKSZ;
 
 			err = btree_smgr_read(desc, buf, chkpNum, read_size, byte_offset) != read_size;
+			total_size += read_size;
 
 			if (!err)
 			{
@@ -1218,6 +1234,7 @@ read_page_from_disk(BTreeDescr *desc, Pointer img, uint64 downlink,
 			/* details about writed image parts are in write_page_to_disk */
 			err = btree_smgr_read(desc, (Pointer) &header, chkpNum, read_size, byte_offset) != read_size;
 			byte_offset += read_size;
+			total_size += read_size;
 
 			if (!err)
 			{
@@ -1227,6 +1244,7 @@ read_page_from_disk(BTreeDescr *desc, Pointer img, uint64 downlink,
 				memset(img, 0, skipped);
 				read_size = ORIOLEDB_BLCKSZ - skipped;
 				err = btree_smgr_read(desc, img + skipped, chkpNum, read_size, byte_offset) != read_size;
+				total_size += read_size;
 
 				page_header = (BTreePageHeader *) img;
 				page_header->checkpointNum = header.chkpNum;
@@ -1234,6 +1252,12 @@ read_page_from_disk(BTreeDescr *desc, Pointer img, uint64 downlink,
 		}
 	}
 
+	if (!err)
+	{
+		o_stat_tree_count(desc, OStatPageLoads, 1);
+		o_stat_tree_count(desc, OStatBytesRead, total_size);
+	}
+
 	return !err;
 }
 
@@ -1246,7 +1270,8 @@ write_page_to_disk(BTreeDescr *desc, FileExtent *extent, uint32 curChkpNum,
 {
 
 	off_t		byte_offset,
-				write_size;
+				write_size,
+				total_size = 0;
 	bool		err = false;
 	uint32		chkpNum = 0;
 
@@ -1272,6 +1297,7 @@ write_page_to_disk(BTreeDescr *desc, FileExtent *extent, uint32 curChkpNum,
 		write_size = ORIOLEDB_BLCKSZ;
 
 		err = btree_smgr_write(desc, page, chkpNum, write_size, byte_offset) != write_size;
+		total_size += write_size;
 	}
 	else
 	{
@@ -1297,6 +1323,7 @@ write_page_to_disk(BTreeDescr *desc, FileExtent *extent, uint32 curChkpNum,
 		write_size = sizeof(OCompressHeader);
 		err = btree_smgr_write(desc, (char *) &header, chkpNum, write_size, byte_offset) != write_size;
 		byte_offset += write_size;
+		total_size += write_size;
 
 		if (err)
 			return false;
@@ -1305,6 +1332,7 @@ write_page_to_disk(BTreeDescr *desc, FileExtent *extent, uint32 curChkpNum,
 		{
 			write_size = extent->len * ORIOLEDB_COMP_BLCKSZ - sizeof(OCompressHeader);
 			err = btree_smgr_write(desc, page, chkpNum, write_size, byte_offset) != write_size;
+			total_size += write_size;
 		}
 		else
 		{
@@ -1320,10 +1348,13 @@ write_page_to_disk(BTreeDescr *desc, FileExtent *extent, uint32 curChkpNum,
 			page += skipped;
 			write_size = ORIOLEDB_BLCKSZ - skipped;
 			err = btree_smgr_write(desc, page, chkpNum, write_size, byte_offset) != write_size;
-
+			total_size += write_size;
 		}
 	}
 
+	if (!err)
+		o_stat_count_write(desc, total_size);
+
 	return !err;
 }
 
@@ -1357,6 +1388,7 @@ load_page(OBTreeFindPageContext *context)
 	bool		was_image = false;
 	bool		was_keep_lokey = false;
 	uint32		chkpNum = 0;
+	UsageCountMap *ucm;
 
 	context_index = context->index;
 	parent_blkno = context->items[context_index].blkno;
@@ -1399,7 +1431,8 @@ load_page(OBTreeFindPageContext *context)
 	parent_page_desc = O_GET_IN_MEMORY_PAGEDESC(parent_blkno);
 	page_desc = O_GET_IN_MEMORY_PAGEDESC(blkno);
 
-	page_desc->flags = 0;
+	/* Keep the borrower set by ppool_get_page() */
+	page_desc->flags &= PAGE_DESC_BORROWER_MASK;
 
 	/* Read page data and put it to the page */
 	if (!read_page_from_disk(desc, buf, downlink, &page_desc->fileExtent))
@@ -1418,8 +1451,9 @@ load_page(OBTreeFindPageContext *context)
 	}
 
 	put_page_image(blkno, buf);
-	page_change_usage_count(&desc->ppool->ucm, blkno,
-							(pg_atomic_read_u32(desc->ppool->ucm.epoch) + 2) % UCM_USAGE_LEVELS);
+	ucm = &(get_ppool_by_blkno(blkno)->ucm);
+	page_change_usage_count(ucm, blkno,
+							(pg_atomic_read_u32(ucm->epoch) + 2) % UCM_USAGE_LEVELS);
 	page_desc->type = parent_page_desc->type;
 	page_desc->oids = parent_page_desc->oids;
 
@@ -1998,6 +2032,8 @@ write_page(OBTreeFindPageContext *context, OInMemoryBlkno blkno, Page img,
 	Assert(OInMemoryBlknoIsValid(desc->rootInfo.rootPageBlkno));
 	Assert(page_is_locked(blkno));
 	EA_EVICT_INC(blkno);
+	if (evict)
+		o_stat_count_eviction(desc, IS_DIRTY(blkno), evict_requested);
 
 	if (!is_root)
 	{
@@ -2258,6 +2294,8 @@ evict_btree(BTreeDescr *desc, uint32 checkpoint_number)
 	}
 
 	was_dirty = IS_DIRTY(root_blkno);
+	o_stat_count_eviction(desc, was_dirty, evict_requested);
+	o_stat_tree_count(desc, OStatEvictionsTree, 1);
 	if (was_dirty)
 	{
 		bool		not_used;
@@ -2287,6 +2325,10 @@ evict_btree(BTreeDescr *desc, uint32 checkpoint_number)
 		unlock_page(root_blkno);
 	}
 
+	/* cached free extents would be lost with the meta page */
+	if (!orioledb_s3_mode && OCompressIsValid(desc->compress))
+		free_extents_cache_flush(desc);
+
 	if (!hasMetaLock)
 	{
 		if (!LWLockConditionalAcquire(&checkpoint_state->oTablesMetaLock,
@@ -2305,6 +2347,8 @@ evict_btree(BTreeDescr *desc, uint32 checkpoint_number)
 	file_header.leafPagesNum = pg_atomic_read_u32(&metaPage->leafPagesNum);
 	file_header.ctid = pg_atomic_read_u64(&metaPage->ctid);
 	file_header.numFreeBlocks = pg_atomic_read_u64(&metaPage->numFreeBlocks);
+	if (metaPage->suffixTruncation)
+		file_header.flags |= CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION;
 #ifdef USE_ASSERT_CHECKING
 	for (i = 0; i < NUM_SEQ_SCANS_ARRAY_SIZE; i++)
 		Assert(pg_atomic_read_u32(&metaPage->numSeqScans[i]) == 0);
@@ -2764,7 +2808,16 @@ orioledb_evict_pages(PG_FUNCTION_ARGS)
 	Oid			relid = PG_GETARG_OID(0);
 	int			maxLevel = PG_GETARG_INT32(1);
 
-	write_relation_pages(relid, maxLevel, true);
+	evict_requested = true;
+	PG_TRY();
+	{
+		write_relation_pages(relid, maxLevel, true);
+	}
+	PG_FINALLY();
+	{
+		evict_requested = false;
+	}
+	PG_END_TRY();
 
 	PG_RETURN_VOID();
 }
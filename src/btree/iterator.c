@@ -469,6 +469,51 @@ o_btree_iterator_create(BTreeDescr *desc, void *key, BTreeKeyType kind,
 	return it;
 }
 
+/*
+ * Repositions forward iterator to the first tuple >= key.  The key must not
+ * be less than the keys already returned.  If the key is within the current
+ * page image, the image is searched without descending the tree again.
+ */
+void
+o_btree_iterator_seek(BTreeIterator *it, void *key, BTreeKeyType kind)
+{
+	OBTreeFindPageContext *context = &it->context;
+	BTreeDescr *desc = context->desc;
+	Page		img = context->img;
+
+	Assert(IT_IS_FORWARD(it));
+	Assert(key != NULL);
+
+#ifdef USE_ASSERT_CHECKING
+	O_TUPLE_SET_NULL(it->prevTuple.tuple);
+#endif
+
+	if (!it->combinedPage)
+	{
+		bool		onPage = O_PAGE_IS(img, RIGHTMOST);
+
+		if (!onPage)
+		{
+			OTuple		hikey;
+
+			BTREE_PAGE_GET_HIKEY(hikey, img);
+			onPage = o_btree_cmp(desc, key, kind, &hikey, BTreeKeyNonLeafKey) < 0;
+		}
+
+		if (onPage)
+		{
+			BTreePageItemLocator *loc = &context->items[context->index].locator;
+
+			btree_page_search(desc, img, key, kind, NULL, loc);
+			page_locator_find_real_item(img, NULL, loc);
+			return;
+		}
+	}
+
+	find_page(context, key, kind, 0);
+	load_page_from_undo(it, key, kind);
+}
+
 void
 o_btree_iterator_set_tuple_ctx(BTreeIterator *it, MemoryContext tupleCxt)
 {
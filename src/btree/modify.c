@@ -79,6 +79,12 @@ BTreeModifyCallbackInfo nullCallbackInfo =
 	.arg = NULL
 };
 
+/*
+ * Try the last modified leaf of the tree before descending from the root.
+ * Set by the recovery workers applying modifications sorted by key.
+ */
+bool		o_btree_use_last_leaf_hint = false;
+
 static const LOCKMODE hwLockModes[] = {AccessShareLock, RowShareLock, ExclusiveLock, AccessExclusiveLock};
 
 static void unlock_release(BTreeModifyInternalContext *context, bool unlock);
@@ -967,6 +973,36 @@ reserve_undo_for_modification(UndoLogType undoType)
 	}
 }
 
+/*
+ * Remembers the leaf found for insertion if the key goes to the end of the
+ * rightmost leaf.  The next append of an increasing key will try it before
+ * descending from the root.  Random inserts rarely get there, so they don't
+ * lock the hot rightmost leaf in vain.
+ */
+static inline void
+remember_rightmost_leaf(BTreeDescr *desc, OBTreeFindPageContext *context)
+{
+	OBtreePageFindItem *item = &context->items[context->index];
+	Page		p = O_GET_IN_MEMORY_PAGE(item->blkno);
+
+	if (O_PAGE_IS(p, RIGHTMOST) &&
+		!BTREE_PAGE_LOCATOR_IS_VALID(p, &item->locator) &&
+		item->blkno != desc->rootInfo.rootPageBlkno)
+	{
+		desc->rightmostLeaf.blkno = item->blkno;
+		desc->rightmostLeaf.pageChangeCount = item->pageChangeCount;
+	}
+}
+
+static inline void
+remember_last_leaf(BTreeDescr *desc, OBTreeFindPageContext *context)
+{
+	OBtreePageFindItem *item = &context->items[context->index];
+
+	desc->lastLeaf.blkno = item->blkno;
+	desc->lastLeaf.pageChangeCount = item->pageChangeCount;
+}
+
 static OBTreeModifyResult
 o_btree_normal_modify(BTreeDescr *desc, BTreeOperationType action,
 					  OTuple tuple, BTreeKeyType tupleType,
@@ -1006,8 +1042,23 @@ o_btree_normal_modify(BTreeDescr *desc, BTreeOperationType action,
 
 	if (hint && OInMemoryBlknoIsValid(hint->blkno))
 		refind_page(&pageFindContext, key, keyType, 0, hint->blkno, hint->pageChangeCount);
-	else
+	else if (o_btree_use_last_leaf_hint &&
+			 find_leaf_by_hint(&pageFindContext, key, keyType,
+							   &desc->lastLeaf))
+	{
+		/* found on the last modified leaf */
+	}
+	else if (action != BTreeOperationInsert ||
+			 !find_rightmost_leaf_by_hint(&pageFindContext, key, keyType,
+										  &desc->rightmostLeaf))
+	{
 		(void) find_page(&pageFindContext, key, keyType, 0);
+		if (action == BTreeOperationInsert)
+			remember_rightmost_leaf(desc, &pageFindContext);
+	}
+
+	if (o_btree_use_last_leaf_hint)
+		remember_last_leaf(desc, &pageFindContext);
 
 	return o_btree_modify_internal(&pageFindContext, action, tuple, tupleType,
 								   key, keyType, opOxid, opCsn,
@@ -1137,8 +1188,13 @@ o_btree_insert_unique(BTreeDescr *desc, OTuple tuple, BTreeKeyType tupleType,
 	if (hint && OInMemoryBlknoIsValid(hint->blkno))
 		refind_page(&pageFindContext, key, BTreeKeyUniqueLowerBound, 0,
 					hint->blkno, hint->pageChangeCount);
-	else
+	else if (!find_rightmost_leaf_by_hint(&pageFindContext, key,
+										  BTreeKeyUniqueLowerBound,
+										  &desc->rightmostLeaf))
+	{
 		(void) find_page(&pageFindContext, key, BTreeKeyUniqueLowerBound, 0);
+		remember_rightmost_leaf(desc, &pageFindContext);
+	}
 
 retry:
 
@@ -30,6 +30,7 @@
 #include "storage/proc.h"
 #include "storage/proclist.h"
 #include "storage/s_lock.h"
+#include "storage/spin.h"
 #include "utils/memdebug.h"
 
 /*
@@ -326,6 +327,7 @@ init_new_btree_page(BTreeDescr *desc, OInMemoryBlkno blkno, uint16 flags,
 	Page		p = O_GET_IN_MEMORY_PAGE(blkno);
 	OrioleDBPageDesc *page_desc = O_GET_IN_MEMORY_PAGEDESC(blkno);
 	BTreePageHeader *header = (BTreePageHeader *) p;
+	UsageCountMap *ucm;
 
 	if (!noLock)
 	{
@@ -355,8 +357,9 @@ init_new_btree_page(BTreeDescr *desc, OInMemoryBlkno blkno, uint16 flags,
 	header->itemsCount = 0;
 	header->prevInsertOffset = MaxOffsetNumber;
 	header->maxKeyLen = 0;
-	page_change_usage_count(&desc->ppool->ucm, blkno,
-							(pg_atomic_read_u32(desc->ppool->ucm.epoch) + 2) % UCM_USAGE_LEVELS);
+	ucm = &(get_ppool_by_blkno(blkno)->ucm);
+	page_change_usage_count(ucm, blkno,
+							(pg_atomic_read_u32(ucm->epoch) + 2) % UCM_USAGE_LEVELS);
 
 	memset(p + offsetof(BTreePageHeader, chunkDesc),
 		   0,
@@ -387,6 +390,9 @@ init_meta_page(OInMemoryBlkno blkno, uint32 leafPagesNum)
 					 checkpoint_state->oMetaTrancheId);
 	LWLockInitialize(&metaPage->punchHolesLock,
 					 checkpoint_state->punchHolesTrancheId);
+	LWLockInitialize(&metaPage->extentCacheLock,
+					 checkpoint_state->extentCacheTrancheId);
+	SpinLockInit(&metaPage->extentCacheSpinlock);
 
 	page_desc->type = oIndexInvalid;
 	page_desc->oids.datoid = InvalidOid;
@@ -22,6 +22,7 @@
 #include "tableam/descr.h"
 #include "transam/oxid.h"
 #include "transam/undo.h"
+#include "utils/o_stat.h"
 #include "utils/page_pool.h"
 #include "utils/stopevent.h"
 #include "utils/ucm.h"
@@ -265,6 +266,29 @@ dequeue_self(OInMemoryBlkno blkno)
 	return state;
 }
 
+/*
+ * Remembers the tree the page belongs to for the wait statistics.  Should be
+ * called while the page waiters list is locked, right after queueing.  Once
+ * we are woken up, the page might be already evicted and reused by another
+ * tree, so the oids can't be read in page_wait_end().
+ */
+static inline void
+page_wait_set_oids(OInMemoryBlkno blkno, ORelOids *oids, bool waited)
+{
+	if (!waited)
+		*oids = O_GET_IN_MEMORY_PAGEDESC(blkno)->oids;
+}
+
+/*
+ * Accounts the finished wait for the page to the tree it belonged to when
+ * the wait started.
+ */
+static void
+page_wait_end(OStatWait *wait, ORelOids oids, OStatWaitKind kind)
+{
+	o_stat_wait_end(wait, oids.datoid, oids.relnode, kind);
+}
+
 /*
  * Place exclusive lock on the page.  Doesn't block readers before
  * page_block_reads() is called.
@@ -277,6 +301,9 @@ lock_page(OInMemoryBlkno blkno)
 	OrioleDBPageHeader *header = (OrioleDBPageHeader *) p;
 	uint32		prevState;
 	int			extraWaits = 0;
+	OStatWait	wait;
+	ORelOids	waitOids = {0, 0, 0};
+	bool		waited = false;
 
 	Assert(get_my_locked_page_index(blkno) < 0);
 
@@ -296,6 +323,7 @@ lock_page(OInMemoryBlkno blkno)
 						   lwWaitLink);
 		MyProc->lwWaiting = true;
 		MyProc->lwWaitMode = LW_EXCLUSIVE;
+		page_wait_set_oids(blkno, &waitOids, waited);
 		prevState = pg_atomic_fetch_and_u32(&header->state, ~PAGE_STATE_LIST_LOCKED_FLAG);
 		if (!O_PAGE_STATE_IS_LOCKED(prevState))
 		{
@@ -307,7 +335,12 @@ lock_page(OInMemoryBlkno blkno)
 			}
 		}
 
-		pgstat_report_wait_start(PG_WAIT_LWLOCK | LWTRANCHE_BUFFER_CONTENT);
+		if (!waited)
+		{
+			o_stat_wait_start(&wait);
+			waited = true;
+		}
+		pgstat_report_wait_start(o_stat_wait_event(OStatWaitPageLock));
 
 		for (;;)
 		{
@@ -322,6 +355,9 @@ lock_page(OInMemoryBlkno blkno)
 
 	my_locked_page_add(blkno, prevState | PAGE_STATE_LOCKED_FLAG);
 
+	if (waited)
+		page_wait_end(&wait, waitOids, OStatWaitPageLock);
+
 	/*
 	 * Fix the process wait semaphore's count for any absorbed wakeups.
 	 */
@@ -336,6 +372,9 @@ page_wait_for_read_enable(OInMemoryBlkno blkno)
 	OrioleDBPageHeader *header = (OrioleDBPageHeader *) p;
 	uint32		prevState;
 	int			extraWaits = 0;
+	OStatWait	wait;
+	ORelOids	waitOids = {0, 0, 0};
+	bool		waited = false;
 
 	while (true)
 	{
@@ -348,15 +387,21 @@ page_wait_for_read_enable(OInMemoryBlkno blkno)
 						   lwWaitLink);
 		MyProc->lwWaiting = true;
 		MyProc->lwWaitMode = LW_SHARED;
+		page_wait_set_oids(blkno, &waitOids, waited);
 		prevState = pg_atomic_fetch_and_u32(&header->state, ~PAGE_STATE_LIST_LOCKED_FLAG);
 
 		if (!(prevState & PAGE_STATE_NO_READ_FLAG))
 		{
 			dequeue_self(blkno);
-			return;
+			break;
 		}
 
-		pgstat_report_wait_start(PG_WAIT_LWLOCK | LWTRANCHE_BUFFER_CONTENT);
+		if (!waited)
+		{
+			o_stat_wait_start(&wait);
+			waited = true;
+		}
+		pgstat_report_wait_start(o_stat_wait_event(OStatWaitPageRead));
 
 		for (;;)
 		{
@@ -369,6 +414,9 @@ page_wait_for_read_enable(OInMemoryBlkno blkno)
 		pgstat_report_wait_end();
 	}
 
+	if (waited)
+		page_wait_end(&wait, waitOids, OStatWaitPageRead);
+
 	/*
 	 * Fix the process wait semaphore's count for any absorbed wakeups.
 	 */
@@ -385,6 +433,9 @@ page_wait_for_changecount(OInMemoryBlkno blkno, uint32 state)
 	OrioleDBPageHeader *header = (OrioleDBPageHeader *) p;
 	uint32		curState;
 	int			extraWaits = 0;
+	OStatWait	wait;
+	ORelOids	waitOids = {0, 0, 0};
+	bool		waited = false;
 
 	while (true)
 	{
@@ -404,15 +455,22 @@ page_wait_for_changecount(OInMemoryBlkno blkno, uint32 state)
 						   lwWaitLink);
 		MyProc->lwWaiting = true;
 		MyProc->lwWaitMode = LW_SHARED;
+		page_wait_set_oids(blkno, &waitOids, waited);
 		curState = pg_atomic_fetch_and_u32(&header->state, ~PAGE_STATE_LIST_LOCKED_FLAG);
 
 		if ((curState & PAGE_STATE_CHANGE_COUNT_MASK) !=
 			(state & PAGE_STATE_CHANGE_COUNT_MASK))
 		{
-			return dequeue_self(blkno);
+			curState = dequeue_self(blkno);
+			break;
 		}
 
-		pgstat_report_wait_start(PG_WAIT_LWLOCK | LWTRANCHE_BUFFER_CONTENT);
+		if (!waited)
+		{
+			o_stat_wait_start(&wait);
+			waited = true;
+		}
+		pgstat_report_wait_start(o_stat_wait_event(OStatWaitPageSplit));
 
 		for (;;)
 		{
@@ -427,12 +485,16 @@ page_wait_for_changecount(OInMemoryBlkno blkno, uint32 state)
 			}
 			extraWaits++;
 		}
-		if (exit_loop)
-			break;
 
 		pgstat_report_wait_end();
+
+		if (exit_loop)
+			break;
 	}
 
+	if (waited)
+		page_wait_end(&wait, waitOids, OStatWaitPageSplit);
+
 	/*
 	 * Fix the process wait semaphore's count for any absorbed wakeups.
 	 */
@@ -1148,10 +1148,10 @@ make_btree_seq_scan(BTreeDescr *desc, OSnapshot *oSnapshot, void *poscan)
 
 BTreeSeqScan *
 make_btree_seq_scan_cb(BTreeDescr *desc, OSnapshot *oSnapshot,
-					   BTreeSeqScanCallbacks *cb, void *arg)
+					   BTreeSeqScanCallbacks *cb, void *arg, void *poscan)
 {
 	o_btree_load_shmem(desc);
-	return make_btree_seq_scan_internal(desc, oSnapshot, cb, arg, NULL, NULL);
+	return make_btree_seq_scan_internal(desc, oSnapshot, cb, arg, NULL, poscan);
 }
 
 BTreeSeqScan *
@@ -1623,6 +1623,52 @@ btree_seq_scan_getnext_raw(BTreeSeqScan *scan, MemoryContext mctx,
 	return tuple;
 }
 
+/*
+ * Gets the upper bound of the key range of up to `ndownlinks` downlinks of
+ * the level-1 page starting from the downlink, which covers the `key`.
+ * Parallel index scans use it to split the key range into chunks.
+ *
+ * The bound is always greater than the `key`.  It's set to NULL if the
+ * range lasts till the end of the tree.
+ */
+void
+btree_downlinks_range_high(BTreeDescr *desc, CommitSeqNo csn,
+						   void *key, BTreeKeyType keyType,
+						   int ndownlinks, OFixedKey *high)
+{
+	OBTreeFindPageContext context;
+	BTreePageItemLocator loc;
+	Page		img = context.img;
+	int			i;
+
+	init_page_find_context(&context, desc, csn,
+						   BTREE_PAGE_FIND_IMAGE |
+						   BTREE_PAGE_FIND_DOWNLINK_LOCATION);
+	find_page(&context, key, keyType, 1);
+
+	if (PAGE_GET_LEVEL(img) == 0)
+	{
+		/* The whole tree is the single leaf */
+		clear_fixed_key(high);
+		return;
+	}
+
+	loc = context.items[context.index].locator;
+	for (i = 0; i < ndownlinks; i++)
+	{
+		BTREE_PAGE_LOCATOR_NEXT(img, &loc);
+		if (!BTREE_PAGE_LOCATOR_IS_VALID(img, &loc))
+			break;
+	}
+
+	if (BTREE_PAGE_LOCATOR_IS_VALID(img, &loc))
+		copy_fixed_page_key(desc, high, img, &loc);
+	else if (!O_PAGE_IS(img, RIGHTMOST))
+		copy_fixed_hikey(desc, high, img);
+	else
+		clear_fixed_key(high);
+}
+
 void
 free_btree_seq_scan(BTreeSeqScan *scan)
 {
@@ -175,13 +175,15 @@ split_item_interator_get(SplitItemIterator *it)
  * as close as possible to `targetLocation`, or if `targetLocation == 0` close
  * to `spaceRatio`.  Also, this function takes advantage of reclaiming unused
  * space according to `csn`.  Returns number of items in new left page and
- * sets the first tuple of right page to `*split_item`.
+ * sets the first tuple of right page to `*split_item` and the last tuple of
+ * the left page to `*last_left_item` (if given).
  */
 OffsetNumber
 btree_page_split_location(BTreeDescr *desc, Page page, OffsetNumber offset,
 						  LocationIndex tuplesize, OTuple tuple, bool replace,
 						  OffsetNumber targetLocation, float4 spaceRatio,
-						  OTuple *split_item, CommitSeqNo csn)
+						  OTuple *split_item, OTuple *last_left_item,
+						  CommitSeqNo csn)
 {
 	int			leftPageSpaceLeft,
 				rightPageSpaceLeft,
@@ -277,6 +279,12 @@ btree_page_split_location(BTreeDescr *desc, Page page, OffsetNumber offset,
 	if (split_item)
 		*split_item = split_item_interator_get(&left_it);
 
+	if (last_left_item)
+	{
+		split_item_interator_prev(&left_it);
+		*last_left_item = split_item_interator_get(&left_it);
+	}
+
 	return minLeftPageItemsCount;
 }
 
@@ -293,7 +301,8 @@ btree_get_split_left_count(BTreeDescr *desc, OInMemoryBlkno blkno,
 	OffsetNumber result;
 	float4		spaceRatio;
 	float4		fillfactorRatio = ((float4) desc->fillfactor) / 100.0f;
-	OTuple		split_item;
+	OTuple		split_item,
+				last_left_item;
 
 	/* The default target is to split the page 50%/50% */
 	targetCount = 0;
@@ -335,18 +344,32 @@ btree_get_split_left_count(BTreeDescr *desc, OInMemoryBlkno blkno,
 		spaceRatio = fillfactorRatio;
 
 	result = btree_page_split_location(desc, page, offset, tuplesize, tuple, replace,
-									   targetCount, spaceRatio, &split_item, csn);
+									   targetCount, spaceRatio, &split_item,
+									   &last_left_item, csn);
 
 	/*
-	 * Fill the split key.  Convert tuple to key if needed.
+	 * Fill the split key.  Convert tuple to key if needed.  On leaf split,
+	 * try to truncate the key to the minimal separator first.
 	 */
 	if (split_key)
 	{
 		bool		allocated = true;
 
 		if (O_PAGE_IS(page, LEAF))
-			split_item = o_btree_tuple_make_key(desc, split_item, NULL,
-												false, &allocated);
+		{
+			OTuple		separator;
+
+			O_TUPLE_SET_NULL(separator);
+			if (desc->ops->make_separator)
+				separator = desc->ops->make_separator(desc, last_left_item,
+													  split_item);
+
+			if (!O_TUPLE_IS_NULL(separator))
+				split_item = separator;
+			else
+				split_item = o_btree_tuple_make_key(desc, split_item, NULL,
+													false, &allocated);
+		}
 
 		*split_key_len = o_btree_len(desc, split_item, OKeyLength);
 		if (!O_PAGE_IS(page, LEAF) || !allocated)
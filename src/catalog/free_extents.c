@@ -14,6 +14,16 @@
  * is reset after reboot of the database engine and the state must
  * be restored after it.
  *
+ * Each tree also keeps a small cache of free extents in its meta page.
+ * Freed extents are merged with adjacent cached extents, and allocations are
+ * served from the best fitting cached extent.  The sys trees are only
+ * accessed on a cache miss, where the remaining part of the fetched extent
+ * refills the cache, and when the cache overflows, where the smaller half of
+ * the cache is written back to the sys trees in a batch.  An extent is either
+ * in the cache or in the sys trees.  The modification of the sys trees
+ * happens under the shared extentCacheLock, foreach_free_extent() takes it
+ * exclusively to see the complete list of free extents.
+ *
  * Copyright (c) 2021-2025, Oriole DB Inc.
  *
  * IDENTIFICATION
@@ -39,15 +49,200 @@
 
 #include "access/transam.h"
 #include "miscadmin.h"
+#include "storage/spin.h"
 #include "utils/wait_event.h"
 
 #define EXTENTS_IX_EQ(ex1, ex2) ((ex1).ixType == (ex2).ixType && \
 								 (ex1).datoid == (ex2).datoid && \
 								 (ex1).relnode == (ex2).relnode)
 
+static FileExtent get_extent_from_trees(BTreeDescr *desc, uint16 len);
+static void free_extent_to_trees(BTreeDescr *desc, uint64 offset,
+								 uint64 length);
+
+/*
+ * Allocates a new extent at the end of the data file.
+ */
+static FileExtent
+get_new_extent(BTreeDescr *desc, uint16 len)
+{
+	BTreeMetaPage *metaPage = BTREE_GET_META(desc);
+	FileExtent	result;
+
+	result.len = len;
+	if (use_device)
+		result.off = orioledb_device_alloc(desc, len * ORIOLEDB_COMP_BLCKSZ) / ORIOLEDB_COMP_BLCKSZ;
+	else
+		result.off = pg_atomic_fetch_add_u64(&metaPage->datafileLength[0], len);
+	return result;
+}
+
+/*
+ * Takes `len` blocks from the best fitting extent of the meta page cache.
+ * Caller must hold extentCacheSpinlock.
+ */
+static bool
+extent_cache_get(BTreeMetaPage *metaPage, uint16 len, uint64 *off)
+{
+	CachedFileExtent *best = NULL;
+	int			i;
+
+	for (i = 0; i < metaPage->extentCacheCount; i++)
+	{
+		CachedFileExtent *extent = &metaPage->extentCache[i];
+
+		if (extent->length < len)
+			continue;
+
+		if (best == NULL || extent->length < best->length)
+		{
+			best = extent;
+			if (best->length == len)
+				break;
+		}
+	}
+
+	if (best == NULL)
+		return false;
+
+	*off = best->offset;
+	best->offset += len;
+	best->length -= len;
+	if (best->length == 0)
+		*best = metaPage->extentCache[--metaPage->extentCacheCount];
+	return true;
+}
+
+/*
+ * Puts the extent to the meta page cache merging it with adjacent cached
+ * extents.  Returns false if the cache is full.  Caller must hold
+ * extentCacheSpinlock.
+ */
+static bool
+extent_cache_put(BTreeMetaPage *metaPage, uint64 offset, uint64 length)
+{
+	CachedFileExtent *left = NULL,
+			   *right = NULL;
+	int			i;
+
+	for (i = 0; i < metaPage->extentCacheCount; i++)
+	{
+		CachedFileExtent *extent = &metaPage->extentCache[i];
+
+		if (extent->offset + extent->length == offset)
+			left = extent;
+		else if (offset + length == extent->offset)
+			right = extent;
+	}
+
+	if (left != NULL)
+	{
+		left->length += length;
+		if (right != NULL)
+		{
+			left->length += right->length;
+			*right = metaPage->extentCache[--metaPage->extentCacheCount];
+		}
+	}
+	else if (right != NULL)
+	{
+		right->offset = offset;
+		right->length += length;
+	}
+	else if (metaPage->extentCacheCount < EXTENT_CACHE_SIZE)
+	{
+		i = metaPage->extentCacheCount++;
+		metaPage->extentCache[i].offset = offset;
+		metaPage->extentCache[i].length = length;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+static int
+cached_extent_length_cmp(const void *a, const void *b)
+{
+	const CachedFileExtent *ea = (const CachedFileExtent *) a;
+	const CachedFileExtent *eb = (const CachedFileExtent *) b;
+
+	/* longer extents go first */
+	if (ea->length != eb->length)
+		return ea->length > eb->length ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Writes back the extents taken from the overflowed meta page cache.  The
+ * longer half is returned to the cache, since they are more likely to fit
+ * further allocations.  Caller must hold extentCacheLock.
+ */
+static void
+extent_cache_write_back(BTreeDescr *desc, CachedFileExtent *extents, int count)
+{
+	BTreeMetaPage *metaPage = BTREE_GET_META(desc);
+	int			i;
+
+	qsort(extents, count, sizeof(CachedFileExtent), cached_extent_length_cmp);
+
+	SpinLockAcquire(&metaPage->extentCacheSpinlock);
+	for (i = 0; i < count / 2; i++)
+	{
+		if (!extent_cache_put(metaPage, extents[i].offset, extents[i].length))
+			break;
+	}
+	SpinLockRelease(&metaPage->extentCacheSpinlock);
+
+	for (; i < count; i++)
+		free_extent_to_trees(desc, extents[i].offset, extents[i].length);
+}
+
 /*
  * Returns free file extent with length = len.
  *
+ * Tries the meta page cache first, then the free extents B-trees.
+ */
+FileExtent
+get_extent(BTreeDescr *desc, uint16 len)
+{
+	BTreeMetaPage *metaPage = BTREE_GET_META(desc);
+	FileExtent	result;
+	uint64		off;
+	bool		found;
+
+	Assert(!orioledb_s3_mode);
+
+	/* a fast check */
+	if (pg_atomic_read_u64(&metaPage->numFreeBlocks) < len)
+	{
+		/* free extent can not be founded, increase file length */
+		return get_new_extent(desc, len);
+	}
+
+	SpinLockAcquire(&metaPage->extentCacheSpinlock);
+	found = extent_cache_get(metaPage, len, &off);
+	SpinLockRelease(&metaPage->extentCacheSpinlock);
+
+	if (found)
+	{
+		pg_atomic_fetch_sub_u64(&metaPage->numFreeBlocks, (uint64) len);
+		result.off = off;
+		result.len = len;
+		return result;
+	}
+
+	LWLockAcquire(&metaPage->extentCacheLock, LW_SHARED);
+	result = get_extent_from_trees(desc, len);
+	LWLockRelease(&metaPage->extentCacheLock);
+
+	return result;
+}
+
+/*
+ * Returns free file extent with length = len from the free extents B-trees.
+ *
  * get_extend()/free_extend() operations optimized for more fast get_extend()
  * execution because as more critical for performance part.
  *
@@ -66,9 +261,12 @@
  * 3. Delete founded extent from the (off, len) B-tree.
  * 4. If found extent is more than needed than return the remaining part into
  * the (len, off) B-tree.
+ *
+ * The remaining part goes to the meta page cache instead of steps 2 and 4 if
+ * the cache has a room for it.
  */
-FileExtent
-get_extent(BTreeDescr *desc, uint16 len)
+static FileExtent
+get_extent_from_trees(BTreeDescr *desc, uint16 len)
 {
 	BTreeMetaPage *metaPage = BTREE_GET_META(desc);
 	BTreeLeafTuphdr *header = NULL;
@@ -81,26 +279,13 @@ get_extent(BTreeDescr *desc, uint16 len)
 	bool		old_enable_stopevents;
 	bool		found = false,
 				end = false,
+				cached = false,
 				modify_result;
 	BTreePageItemLocator *loc;
 	BTreeDescr *len_off_tree = get_sys_tree(SYS_TREES_EXTENTS_LEN_OFF);
 	BTreeDescr *off_len_tree = get_sys_tree(SYS_TREES_EXTENTS_OFF_LEN);
 	OTuple		tmpTup;
 
-	Assert(!orioledb_s3_mode);
-
-	/* a fast check */
-	if (pg_atomic_read_u64(&metaPage->numFreeBlocks) < len)
-	{
-		/* free extent can not be founded, increase file length */
-		result.len = len;
-		if (use_device)
-			result.off = orioledb_device_alloc(desc, len * ORIOLEDB_COMP_BLCKSZ) / ORIOLEDB_COMP_BLCKSZ;
-		else
-			result.off = pg_atomic_fetch_add_u64(&metaPage->datafileLength[0], len);
-		return result;
-	}
-
 	old_enable_stopevents = enable_stopevents;
 	enable_stopevents = false;
 
@@ -174,11 +359,7 @@ get_extent(BTreeDescr *desc, uint16 len)
 	if (!found)
 	{
 		/* free extent not founded, increase file length */
-		result.len = len;
-		if (use_device)
-			result.off = orioledb_device_alloc(desc, len * ORIOLEDB_COMP_BLCKSZ) / ORIOLEDB_COMP_BLCKSZ;
-		else
-			result.off = pg_atomic_fetch_add_u64(&metaPage->datafileLength[0], len);
+		result = get_new_extent(desc, len);
 		enable_stopevents = old_enable_stopevents;
 		return result;
 	}
@@ -213,11 +394,20 @@ get_extent(BTreeDescr *desc, uint16 len)
 	Assert(deleted_tup.extent.length >= len);
 	tup = deleted_tup;
 	tup.extent.length -= len;
+	tup.extent.offset += len;
 
 	if (tup.extent.length > 0)
+	{
+		/* we have a remaining part, try to refill the cache with it */
+		SpinLockAcquire(&metaPage->extentCacheSpinlock);
+		cached = extent_cache_put(metaPage, tup.extent.offset,
+								  tup.extent.length);
+		SpinLockRelease(&metaPage->extentCacheSpinlock);
+	}
+
+	if (tup.extent.length > 0 && !cached)
 	{
 		/* we have a remaining part, insert it into (off, len) B-tree */
-		tup.extent.offset += len;
 		tmpTup.formatFlags = 0;
 		tmpTup.data = (Pointer) &tup;
 		modify_result = o_btree_autonomous_insert(off_len_tree, tmpTup);
@@ -238,7 +428,7 @@ get_extent(BTreeDescr *desc, uint16 len)
 			 deleted_tup.extent.offset, deleted_tup.extent.length);
 	}
 
-	if (tup.extent.length > 0)
+	if (tup.extent.length > 0 && !cached)
 	{
 		/*
 		 * we have a remaining part, insert it into (len, off) B-tree after
@@ -264,9 +454,75 @@ get_extent(BTreeDescr *desc, uint16 len)
 /*
  * Adds the extent to a free extents list.
  *
- * See description of the get_extent() function.
+ * The extent is put to the meta page cache.  If the cache is full, the cache
+ * contents together with the extent are written back.
+ */
+void
+free_extent(BTreeDescr *desc, FileExtent extent)
+{
+	BTreeMetaPage *metaPage = BTREE_GET_META(desc);
+	CachedFileExtent extents[EXTENT_CACHE_SIZE + 1];
+	int			count = 0;
+	bool		cached;
+
+	Assert(FileExtentIsValid(extent));
+
+	LWLockAcquire(&metaPage->extentCacheLock, LW_SHARED);
+
+	SpinLockAcquire(&metaPage->extentCacheSpinlock);
+	cached = extent_cache_put(metaPage, extent.off, extent.len);
+	if (!cached)
+	{
+		count = metaPage->extentCacheCount;
+		memcpy(extents, metaPage->extentCache,
+			   sizeof(CachedFileExtent) * count);
+		metaPage->extentCacheCount = 0;
+	}
+	SpinLockRelease(&metaPage->extentCacheSpinlock);
+
+	if (!cached)
+	{
+		extents[count].offset = extent.off;
+		extents[count].length = extent.len;
+		count++;
+		extent_cache_write_back(desc, extents, count);
+	}
+
+	LWLockRelease(&metaPage->extentCacheLock);
+}
+
+/*
+ * Moves all the cached free extents of the tree to the free extents B-trees.
+ * Should be called before the meta page is released.
+ */
+void
+free_extents_cache_flush(BTreeDescr *desc)
+{
+	BTreeMetaPage *metaPage = BTREE_GET_META(desc);
+	CachedFileExtent extents[EXTENT_CACHE_SIZE];
+	int			count,
+				i;
+
+	LWLockAcquire(&metaPage->extentCacheLock, LW_EXCLUSIVE);
+
+	SpinLockAcquire(&metaPage->extentCacheSpinlock);
+	count = metaPage->extentCacheCount;
+	memcpy(extents, metaPage->extentCache, sizeof(CachedFileExtent) * count);
+	metaPage->extentCacheCount = 0;
+	SpinLockRelease(&metaPage->extentCacheSpinlock);
+
+	for (i = 0; i < count; i++)
+		free_extent_to_trees(desc, extents[i].offset, extents[i].length);
+
+	LWLockRelease(&metaPage->extentCacheLock);
+}
+
+/*
+ * Adds the extent to the free extents B-trees.
+ *
+ * See description of the get_extent_from_trees() function.
  *
- * free_extent() algorithm:
+ * free_extent_to_trees() algorithm:
  *
  * 1. Find neighbors tuples of the extent in the (off, len) B-tree.
  * 2. Remove neighbors from (len, off) and (off, len) B-trees. If remove from
@@ -275,8 +531,8 @@ get_extent(BTreeDescr *desc, uint16 len)
  *
  * TODO: add hints support
  */
-void
-free_extent(BTreeDescr *desc, FileExtent extent)
+static void
+free_extent_to_trees(BTreeDescr *desc, uint64 offset, uint64 length)
 {
 	BTreeIterator *it = NULL;
 	FreeTreeTuple tup,
@@ -294,7 +550,7 @@ free_extent(BTreeDescr *desc, FileExtent extent)
 
 	enable_stopevents = false;
 
-	Assert(FileExtentIsValid(extent));
+	Assert(length > 0);
 
 	memset(&tup, 0, sizeof(FreeTreeTuple));
 	memset(&right, 0, sizeof(FreeTreeTuple));
@@ -308,7 +564,7 @@ free_extent(BTreeDescr *desc, FileExtent extent)
 	{
 		/* reset status */
 		tup.extent.length = 0;
-		tup.extent.offset = (uint64) extent.off + extent.len;
+		tup.extent.offset = offset + length;
 		merge_right = false;
 		merge_left = false;
 		if (it != NULL)
@@ -334,9 +590,9 @@ free_extent(BTreeDescr *desc, FileExtent extent)
 		}
 		else if (cur->extent.offset != tup.extent.offset)
 		{
-			Assert(cur->extent.offset < extent.off);
+			Assert(cur->extent.offset < offset);
 			merge_right = false;
-			merge_left = (cur->extent.offset + cur->extent.length) == extent.off;
+			merge_left = (cur->extent.offset + cur->extent.length) == offset;
 			if (merge_left)
 				left = *cur;
 			pfree(cur);
@@ -351,7 +607,7 @@ free_extent(BTreeDescr *desc, FileExtent extent)
 											false, NULL);
 			cur = (FreeTreeTuple *) tmpTup.data;
 			if (cur != NULL && EXTENTS_IX_EQ(*cur, tup)
-				&& cur->extent.offset + cur->extent.length == extent.off)
+				&& cur->extent.offset + cur->extent.length == offset)
 			{
 				merge_left = true;
 				left = *cur;
@@ -430,13 +686,13 @@ free_extent(BTreeDescr *desc, FileExtent extent)
 		if (merge_left)
 		{
 			tup.extent.offset = left.extent.offset;
-			Assert(tup.extent.offset + left.extent.length == extent.off);
-			tup.extent.length = left.extent.length + extent.len;
+			Assert(tup.extent.offset + left.extent.length == offset);
+			tup.extent.length = left.extent.length + length;
 		}
 		else
 		{
-			tup.extent.offset = extent.off;
-			tup.extent.length = extent.len;
+			tup.extent.offset = offset;
+			tup.extent.length = length;
 		}
 
 		if (merge_right)
@@ -469,20 +725,47 @@ free_extent(BTreeDescr *desc, FileExtent extent)
 	enable_stopevents = old_enable_stopevents;
 }
 
+/*
+ * Calls the callback for the free extent splitting it into FileExtent's.
+ */
+static void
+foreach_extent_split(BTreeDescr *desc, uint64 offset, uint64 length,
+					 ForEachExtentCallback callback, void *arg)
+{
+	FileExtent	cur_extent;
+
+	/* FreeTreeFileExtent.length may be more than FileExtent.len */
+	while (length > UINT16_MAX)
+	{
+		cur_extent.off = offset;
+		cur_extent.len = UINT16_MAX;
+		callback(desc, cur_extent, arg);
+		offset += UINT16_MAX;
+		length -= UINT16_MAX;
+	}
+	cur_extent.off = offset;
+	cur_extent.len = length;
+	callback(desc, cur_extent, arg);
+}
+
 /*
  * Calls the callback for each free file extent for a BTree on given csn.
  *
- * Be careful, there are can be some intersections, see get_extent() algorithm.
+ * Be careful, there are can be some intersections, see
+ * get_extent_from_trees() algorithm.
  */
 void
 foreach_free_extent(BTreeDescr *desc, ForEachExtentCallback callback, void *arg)
 {
 	BTreeIterator *it;
+	BTreeMetaPage *metaPage = BTREE_GET_META(desc);
 	FreeTreeTuple from,
 				to,
 			   *cur;
-	FileExtent	cur_extent;
 	bool		old_enable_stopevents = enable_stopevents;
+	CachedFileExtent extents[EXTENT_CACHE_SIZE];
+	int			count,
+				i;
 	BTreeDescr *off_len_tree = get_sys_tree(SYS_TREES_EXTENTS_OFF_LEN);
 	OTuple		tmpTup;
 	OTuple		toTup;
@@ -504,6 +787,9 @@ foreach_free_extent(BTreeDescr *desc, ForEachExtentCallback callback, void *arg)
 	toTup.formatFlags = 0;
 	Assert(from.relnode < to.relnode);
 
+	/* wait for concurrent movements between the cache and the trees */
+	LWLockAcquire(&metaPage->extentCacheLock, LW_EXCLUSIVE);
+
 	it = o_btree_iterator_create(off_len_tree, (Pointer) &fromTup,
 								 BTreeKeyNonLeafKey,
 								 &o_in_progress_snapshot,
@@ -521,22 +807,24 @@ foreach_free_extent(BTreeDescr *desc, ForEachExtentCallback callback, void *arg)
 		Assert(cur->datoid == desc->oids.datoid);
 		Assert(cur->relnode == desc->oids.relnode);
 
-		/* FreeTreeFileExtent.length may be more than FileExtent.len */
-		while (cur->extent.length > UINT16_MAX)
-		{
-			cur_extent.off = cur->extent.offset;
-			cur_extent.len = UINT16_MAX;
-			callback(desc, cur_extent, arg);
-			cur->extent.offset += UINT16_MAX;
-			cur->extent.length -= UINT16_MAX;
-		}
-		cur_extent.off = cur->extent.offset;
-		cur_extent.len = cur->extent.length;
-		callback(desc, cur_extent, arg);
+		foreach_extent_split(desc, cur->extent.offset, cur->extent.length,
+							 callback, arg);
 		pfree(cur);
 	}
 
 	btree_iterator_free(it);
+
+	/* the cached extents are absent in the trees */
+	SpinLockAcquire(&metaPage->extentCacheSpinlock);
+	count = metaPage->extentCacheCount;
+	memcpy(extents, metaPage->extentCache, sizeof(CachedFileExtent) * count);
+	SpinLockRelease(&metaPage->extentCacheSpinlock);
+
+	for (i = 0; i < count; i++)
+		foreach_extent_split(desc, extents[i].offset, extents[i].length,
+							 callback, arg);
+
+	LWLockRelease(&metaPage->extentCacheLock);
 	enable_stopevents = old_enable_stopevents;
 }
 
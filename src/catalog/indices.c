@@ -16,6 +16,8 @@
 
 #include "btree/build.h"
 #include "btree/io.h"
+#include "btree/iterator.h"
+#include "btree/modify.h"
 #include "btree/undo.h"
 #include "btree/scan.h"
 #include "checkpoint/checkpoint.h"
@@ -24,7 +26,9 @@
 #include "recovery/recovery.h"
 #include "recovery/internal.h"
 #include "recovery/wal.h"
+#include "tableam/handler.h"
 #include "tableam/operations.h"
+#include "tableam/tree.h"
 #include "transam/oxid.h"
 #include "tuple/slot.h"
 #include "tuple/sort.h"
@@ -263,8 +267,9 @@ o_define_index_validate(ORelOids oids, Relation index, IndexInfo *indexInfo, OTa
 	int			nattrs;
 	OIndexType	ix_type;
 
-	if (indexInfo && indexInfo->ii_Concurrent)
-		elog(ERROR, "concurrent indexes are not supported.");
+	if (indexInfo && indexInfo->ii_Concurrent &&
+		index->rd_index->indisprimary)
+		elog(ERROR, "concurrent primary key creation is not supported.");
 
 	if (index->rd_index->indisexclusion)
 		elog(ERROR, "exclusion indices are not supported.");
@@ -1460,6 +1465,250 @@ build_secondary_index(OTable *o_table, OTableDescr *descr, OIndexNumber ix_num,
 	pfree(index_tuples);
 }
 
+/*
+ * Lock the primary row with given key waiting for concurrent modifiers, and
+ * fetch its latest version into the slot.  Returns false if the row doesn't
+ * exist anymore.
+ */
+static bool
+validate_lock_primary_row(Relation heap, OTableDescr *descr,
+						  OBTreeKeyBound *pkey, OXid oxid, CommitSeqNo csn,
+						  TupleTableSlot *slot)
+{
+	OLockCallbackArg larg;
+	OBTreeModifyResult res;
+	BTreeLocationHint hint = {OInvalidInMemoryBlkno, 0};
+
+	larg.rel = heap;
+	larg.descr = descr;
+	larg.oxid = oxid;
+	larg.csn = csn;
+	larg.scanSlot = slot;
+	larg.waitPolicy = LockWaitBlock;
+	larg.wouldBlock = false;
+	larg.modified = false;
+	larg.selfModified = false;
+	larg.deleted = false;
+
+	ExecClearTuple(slot);
+	res = o_tbl_lock(descr, pkey, LockTupleKeyShare, oxid, &larg, &hint);
+	if (res != OBTreeModifyResultLocked || TTS_EMPTY(slot))
+		return false;
+
+	slot_getallattrs(slot);
+	return true;
+}
+
+/*
+ * Checks if the index tuple corresponding to the primary row in the slot
+ * matches the given secondary index key.
+ */
+static bool
+validate_row_matches(OIndexDescr *idx, TupleTableSlot *slot,
+					 Pointer key, BTreeKeyType keyType)
+{
+	OBTreeKeyBound bound;
+
+	if (!o_is_index_predicate_satisfied(idx, slot, idx->econtext))
+		return false;
+
+	tts_orioledb_fill_key_bound(slot, idx, &bound);
+	return o_idx_cmp(&idx->desc, (Pointer) &bound, BTreeKeyBound,
+					 key, keyType) == 0;
+}
+
+static bool
+validate_index_entry_exists(OIndexDescr *idx, TupleTableSlot *slot,
+							MemoryContext tmpcxt)
+{
+	OBTreeKeyBound bound;
+	OTuple		tup;
+	CommitSeqNo tupleCsn;
+
+	tts_orioledb_fill_key_bound(slot, idx, &bound);
+	tup = o_btree_find_tuple_by_key(&idx->desc, (Pointer) &bound,
+									BTreeKeyBound, &o_in_progress_snapshot,
+									&tupleCsn, tmpcxt, NULL);
+	return !O_TUPLE_IS_NULL(tup);
+}
+
+/*
+ * Second pass of CREATE INDEX CONCURRENTLY.
+ *
+ * The index was built from the table contents seen by the build scan while
+ * concurrent transactions were still modifying the table without maintaining
+ * the new index.  At this point the index is marked as ready, so all the new
+ * modifications are reflected in it.  We make the index match the table in
+ * two passes.
+ *
+ * 1. Walk the index and delete the entries which don't correspond to the
+ *    latest version of their primary row.
+ * 2. Walk the primary tree and insert the entries missing from the index.
+ *
+ * Rows are only locked once a mismatch is found: locking waits for the
+ * concurrent modifier to finish, and then we recheck against the settled row
+ * version.
+ */
+void
+o_validate_index_concurrently(Relation heap, Relation index,
+							  ValidateIndexState *state)
+{
+	OTableDescr *descr;
+	OIndexDescr *idx = NULL;
+	OIndexDescr *primary;
+	OSnapshot	oSnapshot;
+	OXid		oxid;
+	BTreeSeqScan *sscan;
+	TupleTableSlot *primarySlot;
+	TupleTableSlot *lockSlot;
+	MemoryContext tmpcxt,
+				oldcxt;
+	OTuple		nullTup;
+	double		ntuples = 0;
+	int			i;
+
+	descr = relation_get_descr(heap);
+	Assert(descr != NULL);
+	primary = GET_PRIMARY(descr);
+
+	for (i = 0; i < descr->nIndices; i++)
+	{
+		if (descr->indices[i]->oids.reloid == index->rd_rel->oid)
+		{
+			idx = descr->indices[i];
+			break;
+		}
+	}
+	if (idx == NULL)
+		elog(ERROR, "orioledb index \"%s\" is not found",
+			 RelationGetRelationName(index));
+
+	fill_current_oxid_osnapshot(&oxid, &oSnapshot);
+	O_TUPLE_SET_NULL(nullTup);
+
+	tmpcxt = AllocSetContextCreate(CurrentMemoryContext,
+								   "orioledb index validate",
+								   ALLOCSET_DEFAULT_SIZES);
+	primarySlot = MakeSingleTupleTableSlot(descr->tupdesc, &TTSOpsOrioleDB);
+	lockSlot = MakeSingleTupleTableSlot(descr->tupdesc, &TTSOpsOrioleDB);
+
+	o_btree_load_shmem(&primary->desc);
+	o_btree_load_shmem(&idx->desc);
+
+	/* Pass 1: remove stale index entries */
+	sscan = make_btree_seq_scan(&idx->desc, &o_in_progress_snapshot, NULL);
+	while (true)
+	{
+		OTuple		itup;
+		OTuple		ptup;
+		OBTreeKeyBound pkey;
+		CommitSeqNo tupleCsn;
+		BTreeLocationHint hint;
+		bool		stale;
+
+		CHECK_FOR_INTERRUPTS();
+		MemoryContextReset(tmpcxt);
+		oldcxt = MemoryContextSwitchTo(tmpcxt);
+
+		itup = btree_seq_scan_getnext(sscan, tmpcxt, &tupleCsn, &hint);
+		if (O_TUPLE_IS_NULL(itup))
+		{
+			MemoryContextSwitchTo(oldcxt);
+			break;
+		}
+		state->itups++;
+
+		o_fill_pindex_tuple_key_bound(&idx->desc, itup, &pkey);
+		ptup = o_btree_find_tuple_by_key(&primary->desc, (Pointer) &pkey,
+										 BTreeKeyBound,
+										 &o_in_progress_snapshot,
+										 &tupleCsn, tmpcxt, NULL);
+		if (O_TUPLE_IS_NULL(ptup))
+			stale = true;
+		else
+		{
+			tts_orioledb_store_tuple(primarySlot, ptup, descr, tupleCsn,
+									 PrimaryIndexNumber, false, NULL);
+			slot_getallattrs(primarySlot);
+			stale = !validate_row_matches(idx, primarySlot,
+										  (Pointer) &itup, BTreeKeyLeafTuple);
+			ExecClearTuple(primarySlot);
+		}
+
+		if (stale &&
+			(!validate_lock_primary_row(heap, descr, &pkey, oxid,
+										oSnapshot.csn, lockSlot) ||
+			 !validate_row_matches(idx, lockSlot,
+								   (Pointer) &itup, BTreeKeyLeafTuple)))
+		{
+			(void) o_btree_modify(&idx->desc, BTreeOperationDelete,
+								  nullTup, BTreeKeyNone,
+								  (Pointer) &itup, BTreeKeyLeafTuple,
+								  oxid, oSnapshot.csn, RowLockUpdate,
+								  NULL, &nullCallbackInfo);
+		}
+		ExecClearTuple(lockSlot);
+		MemoryContextSwitchTo(oldcxt);
+	}
+	free_btree_seq_scan(sscan);
+
+	/* Pass 2: insert missing index entries */
+	sscan = make_btree_seq_scan(&primary->desc, &o_in_progress_snapshot, NULL);
+	while (true)
+	{
+		OBTreeKeyBound pkey;
+		bool		found;
+
+		CHECK_FOR_INTERRUPTS();
+		MemoryContextReset(tmpcxt);
+		oldcxt = MemoryContextSwitchTo(tmpcxt);
+
+		found = scan_getnextslot_allattrs(sscan, descr, primarySlot, &ntuples);
+		if (!found)
+		{
+			MemoryContextSwitchTo(oldcxt);
+			break;
+		}
+		state->htups++;
+
+		if (!o_is_index_predicate_satisfied(idx, primarySlot, idx->econtext) ||
+			validate_index_entry_exists(idx, primarySlot, tmpcxt))
+		{
+			ExecClearTuple(primarySlot);
+			MemoryContextSwitchTo(oldcxt);
+			continue;
+		}
+
+		tts_orioledb_fill_key_bound(primarySlot, primary, &pkey);
+		if (validate_lock_primary_row(heap, descr, &pkey, oxid,
+									  oSnapshot.csn, lockSlot) &&
+			o_is_index_predicate_satisfied(idx, lockSlot, idx->econtext) &&
+			!validate_index_entry_exists(idx, lockSlot, tmpcxt))
+		{
+			if (o_tbl_index_insert(descr, idx, NULL, lockSlot, oxid,
+								   oSnapshot.csn, &nullCallbackInfo) !=
+				OBTreeModifyResultInserted)
+				ereport(ERROR,
+						(errcode(ERRCODE_UNIQUE_VIOLATION),
+						 errmsg("could not create unique index \"%s\"",
+								RelationGetRelationName(index)),
+						 errdetail("Key %s is duplicated.",
+								   tss_orioledb_print_idx_key(lockSlot, idx)),
+						 errtableconstraint(heap,
+											RelationGetRelationName(index))));
+			state->tups_inserted++;
+		}
+		ExecClearTuple(lockSlot);
+		ExecClearTuple(primarySlot);
+		MemoryContextSwitchTo(oldcxt);
+	}
+	free_btree_seq_scan(sscan);
+
+	ExecDropSingleTupleTableSlot(primarySlot);
+	ExecDropSingleTupleTableSlot(lockSlot);
+	MemoryContextDelete(tmpcxt);
+}
+
 /*
  * Perform a worker's portion of a parallel sort for all indexes rebuild
  *
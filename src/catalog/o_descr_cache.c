@@ -0,0 +1,273 @@
+/*-------------------------------------------------------------------------
+ *
+ * o_descr_cache.c
+ *		Shared cache of serialized table and index descriptions.
+ *
+ * Every backend builds its own OTableDescr and OIndexDescr from OTable and
+ * OIndex images stored in the SYS_TREES_O_TABLES and SYS_TREES_O_INDICES
+ * system trees.  Fetching an image means assembling its TOAST chunks from
+ * the system tree.  This cache keeps the serialized images in the shared
+ * memory, so that a backend touching a table first time just copies the
+ * image.
+ *
+ * The cache is a set-associative table.  Entries with the same oids live in
+ * the same bucket.  Each bucket is protected by LWLock and is never resized.
+ * Cached images are immutable: an entry is either valid and matches the
+ * latest image in the system tree or it is invalidated.
+ *
+ * Entries are invalidated via o_invalidate_oids() in the backend modifying
+ * the description and via o_invalidate_descrs() in every backend processing
+ * the invalidation message.  The bucket generation is incremented on each
+ * invalidation.  A backend missing the cache remembers the generation before
+ * reading the system tree, and it puts the image to the cache only if the
+ * generation is unchanged.  So the image fetched concurrently with its
+ * modification never gets to the cache.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/src/catalog/o_descr_cache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "orioledb.h"
+
+#include "catalog/o_descr_cache.h"
+#include "recovery/recovery.h"
+
+#include "common/hashfn.h"
+#include "storage/lwlock.h"
+
+#define O_DESCR_CACHE_WAYS		8
+#define O_DESCR_CACHE_DATA_SIZE	(4096 - MAXALIGN(sizeof(ODescrCacheEntryHeader)))
+
+typedef struct
+{
+	ODescrCacheKey key;
+	bool		valid;
+	uint32		version;
+	uint32		length;
+} ODescrCacheEntryHeader;
+
+typedef struct
+{
+	ODescrCacheEntryHeader header;
+	char		data[O_DESCR_CACHE_DATA_SIZE];
+} ODescrCacheEntry;
+
+typedef struct
+{
+	LWLock		lock;
+	uint64		generation;
+	int			nextVictim;
+	ODescrCacheEntry entries[O_DESCR_CACHE_WAYS];
+} ODescrCacheBucket;
+
+typedef struct
+{
+	int			trancheId;
+	ODescrCacheBucket buckets[FLEXIBLE_ARRAY_MEMBER];
+} ODescrCacheShmem;
+
+int			o_descr_cache_size = 16384;
+
+static ODescrCacheShmem *oDescrCacheShmem = NULL;
+static int	oDescrCacheNBuckets = 0;
+
+static int
+o_descr_cache_nbuckets(void)
+{
+	return ((Size) o_descr_cache_size * 1024) / sizeof(ODescrCacheBucket);
+}
+
+Size
+o_descr_cache_shmem_needs(void)
+{
+	return CACHELINEALIGN(add_size(offsetof(ODescrCacheShmem, buckets),
+								   mul_size(sizeof(ODescrCacheBucket),
+											o_descr_cache_nbuckets())));
+}
+
+void
+o_descr_cache_shmem_init(Pointer ptr, bool found)
+{
+	oDescrCacheShmem = (ODescrCacheShmem *) ptr;
+	oDescrCacheNBuckets = o_descr_cache_nbuckets();
+
+	if (!found)
+	{
+		int			i,
+					j;
+
+		oDescrCacheShmem->trancheId = LWLockNewTrancheId();
+		for (i = 0; i < oDescrCacheNBuckets; i++)
+		{
+			ODescrCacheBucket *bucket = &oDescrCacheShmem->buckets[i];
+
+			LWLockInitialize(&bucket->lock, oDescrCacheShmem->trancheId);
+			bucket->generation = 0;
+			bucket->nextVictim = 0;
+			for (j = 0; j < O_DESCR_CACHE_WAYS; j++)
+				bucket->entries[j].header.valid = false;
+		}
+	}
+	LWLockRegisterTranche(oDescrCacheShmem->trancheId, "ODescrCacheTranche");
+}
+
+static ODescrCacheBucket *
+get_bucket(ORelOids oids)
+{
+	uint32		hash;
+
+	hash = hash_bytes((unsigned char *) &oids, sizeof(ORelOids));
+	return &oDescrCacheShmem->buckets[hash % oDescrCacheNBuckets];
+}
+
+static inline bool
+o_descr_cache_enabled(void)
+{
+	/* Recovery changes the system trees without invalidation messages */
+	return oDescrCacheNBuckets > 0 && !is_recovery_in_progress();
+}
+
+static inline bool
+descr_cache_key_equal(ODescrCacheKey *key1, ODescrCacheKey *key2)
+{
+	return ORelOidsIsEqual(key1->oids, key2->oids) && key1->type == key2->type;
+}
+
+/*
+ * Returns a copy of the cached image or NULL.  On a miss, *generation is set
+ * to be passed to o_descr_cache_put().
+ */
+Pointer
+o_descr_cache_get(ODescrCacheKey *key, Size *length, uint32 *version,
+				  uint64 *generation)
+{
+	ODescrCacheBucket *bucket;
+	Pointer		result = NULL;
+	int			i;
+
+	*generation = 0;
+	if (!o_descr_cache_enabled())
+		return NULL;
+
+	bucket = get_bucket(key->oids);
+	LWLockAcquire(&bucket->lock, LW_SHARED);
+	for (i = 0; i < O_DESCR_CACHE_WAYS; i++)
+	{
+		ODescrCacheEntry *entry = &bucket->entries[i];
+
+		if (entry->header.valid &&
+			descr_cache_key_equal(&entry->header.key, key))
+		{
+			*length = entry->header.length;
+			*version = entry->header.version;
+			result = palloc(entry->header.length);
+			memcpy(result, entry->data, entry->header.length);
+			break;
+		}
+	}
+	*generation = bucket->generation;
+	LWLockRelease(&bucket->lock);
+
+	return result;
+}
+
+/*
+ * Puts the image fetched from the system tree to the cache unless the bucket
+ * was invalidated since o_descr_cache_get() returned `generation`.
+ */
+void
+o_descr_cache_put(ODescrCacheKey *key, Pointer data, Size length,
+				  uint32 version, uint64 generation)
+{
+	ODescrCacheBucket *bucket;
+	ODescrCacheEntry *entry = NULL;
+	int			i;
+
+	if (!o_descr_cache_enabled() || length > O_DESCR_CACHE_DATA_SIZE)
+		return;
+
+	bucket = get_bucket(key->oids);
+	LWLockAcquire(&bucket->lock, LW_EXCLUSIVE);
+	if (bucket->generation != generation)
+	{
+		LWLockRelease(&bucket->lock);
+		return;
+	}
+
+	for (i = 0; i < O_DESCR_CACHE_WAYS; i++)
+	{
+		ODescrCacheEntry *cur = &bucket->entries[i];
+
+		if (!cur->header.valid ||
+			descr_cache_key_equal(&cur->header.key, key))
+		{
+			entry = cur;
+			break;
+		}
+	}
+
+	if (entry == NULL)
+	{
+		entry = &bucket->entries[bucket->nextVictim];
+		bucket->nextVictim = (bucket->nextVictim + 1) % O_DESCR_CACHE_WAYS;
+	}
+
+	memset(&entry->header, 0, sizeof(entry->header));
+	entry->header.key = *key;
+	entry->header.version = version;
+	entry->header.length = length;
+	memcpy(entry->data, data, length);
+	entry->header.valid = true;
+	LWLockRelease(&bucket->lock);
+}
+
+/*
+ * Invalidates cached images of the table or index with given oids.
+ */
+void
+o_descr_cache_invalidate(ORelOids oids)
+{
+	ODescrCacheBucket *bucket;
+	int			i;
+
+	if (oDescrCacheNBuckets == 0)
+		return;
+
+	bucket = get_bucket(oids);
+	LWLockAcquire(&bucket->lock, LW_EXCLUSIVE);
+	for (i = 0; i < O_DESCR_CACHE_WAYS; i++)
+	{
+		ODescrCacheEntry *entry = &bucket->entries[i];
+
+		if (entry->header.valid && ORelOidsIsEqual(entry->header.key.oids, oids))
+			entry->header.valid = false;
+	}
+	bucket->generation++;
+	LWLockRelease(&bucket->lock);
+}
+
+/*
+ * Invalidates the whole cache.
+ */
+void
+o_descr_cache_invalidate_all(void)
+{
+	int			i,
+				j;
+
+	for (i = 0; i < oDescrCacheNBuckets; i++)
+	{
+		ODescrCacheBucket *bucket = &oDescrCacheShmem->buckets[i];
+
+		LWLockAcquire(&bucket->lock, LW_EXCLUSIVE);
+		for (j = 0; j < O_DESCR_CACHE_WAYS; j++)
+			bucket->entries[j].header.valid = false;
+		bucket->generation++;
+		LWLockRelease(&bucket->lock);
+	}
+}
@@ -16,6 +16,7 @@
 
 #include "btree/btree.h"
 #include "catalog/indices.h"
+#include "catalog/o_descr_cache.h"
 #include "catalog/o_indices.h"
 #include "catalog/o_sys_cache.h"
 #include "catalog/o_tables.h"
@@ -1029,6 +1030,51 @@ o_indices_get(ORelOids oids, OIndexType type)
 	return oIndex;
 }
 
+/*
+ * Same as o_indices_get(), but looks into the shared descriptions cache
+ * first.
+ */
+OIndex *
+o_indices_get_cached(ORelOids oids, OIndexType type)
+{
+	ODescrCacheKey cacheKey;
+	OIndexChunkKey key;
+	Size		dataLength;
+	Pointer		data;
+	uint32		version;
+	uint64		generation;
+	OIndex	   *oIndex;
+
+	memset(&cacheKey, 0, sizeof(cacheKey));
+	cacheKey.oids = oids;
+	cacheKey.type = type;
+
+	key.type = type;
+	key.oids = oids;
+	key.chunknum = 0;
+
+	data = o_descr_cache_get(&cacheKey, &dataLength, &version, &generation);
+	if (data != NULL)
+	{
+		oIndex = deserialize_o_index(&key, data, dataLength);
+		pfree(data);
+		return oIndex;
+	}
+
+	data = generic_toast_get_any(&oIndicesToastAPI, (Pointer) &key,
+								 &dataLength, &o_non_deleted_snapshot,
+								 get_sys_tree(SYS_TREES_O_INDICES));
+	if (data == NULL)
+		return NULL;
+
+	oIndex = deserialize_o_index(&key, data, dataLength);
+	if (oIndex->table_persistence != RELPERSISTENCE_TEMP)
+		o_descr_cache_put(&cacheKey, data, dataLength, 0, generation);
+	pfree(data);
+
+	return oIndex;
+}
+
 bool
 o_indices_update(OTable *table, OIndexNumber ixNum, OXid oxid, CommitSeqNo csn)
 {
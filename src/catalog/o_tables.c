@@ -17,6 +17,7 @@
 #include "btree/btree.h"
 #include "btree/undo.h"
 #include "checkpoint/checkpoint.h"
+#include "catalog/o_descr_cache.h"
 #include "catalog/o_indices.h"
 #include "catalog/o_tables.h"
 #include "catalog/o_sys_cache.h"
@@ -995,6 +996,7 @@ o_tables_drop_by_oids(ORelOids oids, OXid oxid, CommitSeqNo csn)
 											   (Pointer) &key, oxid, csn,
 											   sys_tree, table->persistence != RELPERSISTENCE_TEMP);
 	systrees_modify_end(table->persistence != RELPERSISTENCE_TEMP);
+	o_descr_cache_invalidate(oids);
 
 	if (result)
 	{
@@ -1115,6 +1117,58 @@ o_tables_get(ORelOids oids)
 	return o_tables_get_by_oids_and_version(oids, NULL);
 }
 
+/*
+ * Same as o_tables_get(), but looks into the shared descriptions cache first.
+ */
+OTable *
+o_tables_get_cached(ORelOids oids)
+{
+	ODescrCacheKey cacheKey;
+	OTableChunkKey key,
+			   *found_key;
+	Pointer		data;
+	Size		dataLength;
+	uint32		version;
+	uint64		generation;
+	OTable	   *oTable;
+
+	memset(&cacheKey, 0, sizeof(cacheKey));
+	cacheKey.oids = oids;
+	cacheKey.type = oIndexInvalid;
+
+	data = o_descr_cache_get(&cacheKey, &dataLength, &version, &generation);
+	if (data != NULL)
+	{
+		oTable = deserialize_o_table(data, dataLength);
+		oTable->version = version;
+		pfree(data);
+		return oTable;
+	}
+
+	key.oids = oids;
+	key.chunknum = 0;
+	key.version = O_TABLE_INVALID_VERSION;
+
+	found_key = &key;
+	data = generic_toast_get_any_with_key(&oTablesToastAPI, (Pointer) &key,
+										  &dataLength,
+										  &o_non_deleted_snapshot,
+										  get_sys_tree(SYS_TREES_O_TABLES),
+										  (Pointer *) &found_key);
+	if (data == NULL)
+		return NULL;
+
+	oTable = deserialize_o_table(data, dataLength);
+	oTable->version = found_key->version;
+	if (oTable->persistence != RELPERSISTENCE_TEMP)
+		o_descr_cache_put(&cacheKey, data, dataLength, oTable->version,
+						  generation);
+	pfree(data);
+	pfree(found_key);
+
+	return oTable;
+}
+
 /*
  * Find OTable by tree oids
  */
@@ -731,6 +731,10 @@ sys_tree_init(int i, bool init_shmem)
 		header->rootInfo.rootPageChangeCount = O_PAGE_GET_CHANGE_COUNT(O_GET_IN_MEMORY_PAGE(header->rootInfo.rootPageBlkno));
 	}
 	descr->rootInfo = header->rootInfo;
+	descr->rightmostLeaf.blkno = OInvalidInMemoryBlkno;
+	descr->rightmostLeaf.pageChangeCount = InvalidOPageChangeCount;
+	descr->lastLeaf.blkno = OInvalidInMemoryBlkno;
+	descr->lastLeaf.pageChangeCount = InvalidOPageChangeCount;
 
 	descr->type = oIndexPrimary;
 	descr->oids.datoid = SYS_TREES_DATOID;
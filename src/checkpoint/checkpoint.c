@@ -43,6 +43,7 @@
 #include "tableam/toast.h"
 #include "transam/oxid.h"
 #include "transam/undo.h"
+#include "utils/o_stat.h"
 #include "utils/page_pool.h"
 #include "utils/seq_buf.h"
 #include "utils/stopevent.h"
@@ -300,6 +301,7 @@ checkpoint_shmem_init(Pointer ptr, bool found)
 		checkpoint_state->copyBlknoTrancheId = LWLockNewTrancheId();
 		checkpoint_state->oMetaTrancheId = LWLockNewTrancheId();
 		checkpoint_state->punchHolesTrancheId = LWLockNewTrancheId();
+		checkpoint_state->extentCacheTrancheId = LWLockNewTrancheId();
 		LWLockInitialize(&checkpoint_state->oTablesMetaLock,
 						 checkpoint_state->oTablesMetaTrancheId);
 		LWLockInitialize(&checkpoint_state->oSysTreesLock,
@@ -374,6 +376,8 @@ checkpoint_shmem_init(Pointer ptr, bool found)
 						  "orioledb_meta");
 	LWLockRegisterTranche(checkpoint_state->punchHolesTrancheId,
 						  "PunchHolesTranche");
+	LWLockRegisterTranche(checkpoint_state->extentCacheTrancheId,
+						  "ExtentCacheTranche");
 	LWLockRegisterTranche(checkpoint_state->oXidQueueTrancheId,
 						  "OXidQueueTranche");
 	LWLockRegisterTranche(checkpoint_state->oXidQueueFlushTrancheId,
@@ -1399,6 +1403,8 @@ o_perform_checkpoint(XLogRecPtr redo_pos, int flags)
 	elog(LOG, "orioledb checkpoint %u complete",
 		 checkpoint_state->lastCheckpointNumber);
 
+	o_stat_flush();
+
 	if (orioledb_s3_mode)
 		s3_perform_backup(flags, maxLocation);
 
@@ -2470,6 +2476,8 @@ checkpoint_ix(int flags, BTreeDescr *descr)
 		header.datafileLength = pg_atomic_read_u64(&meta_page->datafileLength[0]);
 	header.leafPagesNum = pg_atomic_read_u32(&meta_page->leafPagesNum);
 	header.ctid = pg_atomic_read_u64(&meta_page->ctid);
+	if (meta_page->suffixTruncation)
+		header.flags |= CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION;
 
 	if (!orioledb_s3_mode && !is_compressed)
 	{
@@ -5075,6 +5083,8 @@ evictable_tree_init_meta(BTreeDescr *desc, EvictedTreeData **evicted_data,
 		file_header.numFreeBlocks = 0;
 		file_header.leafPagesNum = 1;
 		file_header.ctid = 0;
+		file_header.flags = orioledb_btree_suffix_truncation ?
+			CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION : 0;
 	}
 	else
 	{
@@ -5122,6 +5132,8 @@ evictable_tree_init_meta(BTreeDescr *desc, EvictedTreeData **evicted_data,
 			file_header.numFreeBlocks = 0;
 			file_header.leafPagesNum = 1;
 			file_header.ctid = 0;
+			file_header.flags = orioledb_btree_suffix_truncation ?
+				CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION : 0;
 		}
 		else					/* if checkpoint file exist */
 		{
@@ -5150,6 +5162,8 @@ evictable_tree_init_meta(BTreeDescr *desc, EvictedTreeData **evicted_data,
 		pg_atomic_write_u64(&meta_page->datafileLength[0], file_header.datafileLength);
 	pg_atomic_write_u32(&meta_page->leafPagesNum, file_header.leafPagesNum);
 	pg_atomic_write_u64(&meta_page->ctid, file_header.ctid);
+	meta_page->suffixTruncation =
+		(file_header.flags & CHECKPOINT_FILE_FLAG_SUFFIX_TRUNCATION) != 0;
 	if (*evicted_data)
 	{
 		meta_page->dirtyFlag1 = (*evicted_data)->dirtyFlag1;
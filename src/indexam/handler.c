@@ -117,7 +117,7 @@ orioledb_get_indexam_handler(void)
 	amroutine->amstorage = false;
 	amroutine->amclusterable = true;
 	amroutine->ampredlocks = true;
-	amroutine->amcanparallel = false;
+	amroutine->amcanparallel = true;
 	amroutine->amcaninclude = true;
 	amroutine->amusemaintenanceworkmem = false;
 	amroutine->amsummarizing = false;
@@ -571,6 +571,17 @@ orioledb_amupdate(Relation rel, bool new_valid, bool old_valid,
 									  new_slot, new_tuple,
 									  old_slot, oxid, oSnapshot.csn);
 
+	/*
+	 * Index being built concurrently might miss the old tuple: it could be
+	 * inserted after the build scan.  Validation will fix the rest.
+	 */
+	if (!result.success && result.action == BTreeOperationUpdate &&
+		old_valid && !rel->rd_index->indisvalid)
+		result = o_update_secondary_index(index_descr, ix_num,
+										  new_valid, false,
+										  new_slot, new_tuple,
+										  old_slot, oxid, oSnapshot.csn);
+
 	for (i = 0; i < index_descr->leafTupdesc->natts; i++)
 	{
 		if (vfree[i])
@@ -705,6 +716,10 @@ orioledb_amdelete(Relation rel, Datum *values, bool *isnull,
 	fill_current_oxid_osnapshot(&oxid, &oSnapshot);
 
 	result = o_tbl_index_delete(index_descr, ix_num, slot, oxid, oSnapshot.csn);
+
+	/* See the comment in orioledb_amupdate() */
+	if (!result.success && !rel->rd_index->indisvalid)
+		result.success = true;
 	for (i = 0; i < index_descr->nonLeafTupdesc->natts; i++)
 	{
 		if (vfree[i])
@@ -779,6 +794,19 @@ IndexBulkDeleteResult *
 orioledb_ambulkdelete(IndexVacuumInfo *info, IndexBulkDeleteResult *stats,
 					  IndexBulkDeleteCallback callback, void *callback_state)
 {
+	/*
+	 * CREATE INDEX CONCURRENTLY collects the index contents here before
+	 * validation.  OrioleDB validates indexes by comparing with the primary
+	 * tree directly (see o_validate_index_concurrently()), so there is
+	 * nothing to collect.
+	 */
+	if (!info->index->rd_index->indisvalid)
+	{
+		if (stats == NULL)
+			stats = (IndexBulkDeleteResult *) palloc0(sizeof(IndexBulkDeleteResult));
+		return stats;
+	}
+
 	elog(ERROR, "Not implemented: %s", PG_FUNCNAME_MACRO);
 	return stats;
 }
@@ -1285,6 +1313,7 @@ orioledb_amrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 	MemoryContextReset(o_scan->cxt);
 	o_scan->iterator = NULL;
 	o_scan->curKeyRangeIsLoaded = false;
+	o_scan->parallelSkip = false;
 	o_scan->numPrefixExactKeys = o_get_num_prefix_exact_keys(scankey, nscankeys);
 	btrescan(scan, scankey, nscankeys, orderbys, norderbys);
 }
@@ -1561,15 +1590,22 @@ orioledb_amestimateparallelscan(int nkeys, int norderbys)
 orioledb_amestimateparallelscan(void)
 #endif
 {
-	return sizeof(uint8);
+	return sizeof(OParallelIndexScanData);
 }
 
 void
 orioledb_aminitparallelscan(void *target)
 {
+	o_parallel_index_scan_init((OParallelIndexScan) target);
 }
 
 void
 orioledb_amparallelrescan(IndexScanDesc scan)
 {
+	ParallelIndexScanDesc parallel_scan = scan->parallel_scan;
+
+	Assert(parallel_scan != NULL);
+	o_parallel_index_scan_init((OParallelIndexScan)
+							   OffsetToPointer(parallel_scan,
+											   parallel_scan->ps_offset));
 }
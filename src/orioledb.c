@@ -18,6 +18,7 @@
 #include "btree/find.h"
 #include "btree/io.h"
 #include "btree/scan.h"
+#include "catalog/o_descr_cache.h"
 #include "catalog/o_tables.h"
 #include "catalog/o_sys_cache.h"
 #include "catalog/sys_trees.h"
@@ -39,10 +40,13 @@
 #include "tuple/toast.h"
 #include "utils/compress.h"
 #include "utils/memdebug.h"
+#include "utils/buffers_region.h"
+#include "utils/o_stat.h"
 #include "utils/page_pool.h"
 #include "utils/stopevent.h"
 #include "utils/ucm.h"
 #include "workers/bgwriter.h"
+#include "workers/prewarm.h"
 
 #include "access/table.h"
 #include "access/xlog_internal.h"
@@ -121,7 +125,9 @@ ODBProcData *oProcData;
 int			default_compress = InvalidOCompress;
 int			default_primary_compress = InvalidOCompress;
 int			default_toast_compress = InvalidOCompress;
+int			wal_compress = InvalidOCompress;
 bool		orioledb_table_description_compress = false;
+bool		orioledb_btree_suffix_truncation = false;
 bool		orioledb_s3_mode = false;
 int			s3_num_workers = 3;
 int			s3_desired_size = 10000;
@@ -133,6 +139,7 @@ char	   *s3_prefix = NULL;
 char	   *s3_accesskey = NULL;
 char	   *s3_secretkey = NULL;
 char	   *s3_cainfo = NULL;
+int			s3_archive_compress = InvalidOCompress;
 
 /* Previous values of hooks to chain call them */
 static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
@@ -188,7 +195,9 @@ static ShmemItem shmemItems[] = {
 	{btree_scan_shmem_needs, btree_scan_init_shmem},
 	{s3_queue_shmem_needs, s3_queue_init_shmem},
 	{s3_workers_shmem_needs, s3_workers_init_shmem},
-	{s3_headers_shmem_needs, s3_headers_shmem_init}
+	{s3_headers_shmem_needs, s3_headers_shmem_init},
+	{o_stat_shmem_needs, o_stat_shmem_init},
+	{o_descr_cache_shmem_needs, o_descr_cache_shmem_init}
 };
 
 
@@ -205,6 +214,7 @@ static void orioledb_get_relation_info_hook(PlannerInfo *root,
 static bool orioledb_skip_tree_height_hook(Relation indexRelation);
 
 PG_FUNCTION_INFO_V1(orioledb_page_stats);
+PG_FUNCTION_INFO_V1(orioledb_get_page_pools);
 PG_FUNCTION_INFO_V1(orioledb_version);
 PG_FUNCTION_INFO_V1(orioledb_commit_hash);
 PG_FUNCTION_INFO_V1(orioledb_ucm_check);
@@ -317,6 +327,17 @@ _PG_init(void)
 							NULL,
 							NULL);
 
+	DefineCustomBoolVariable("orioledb.adaptive_buffers",
+							 "Allows free extents and catalog pools to borrow pages of the main pool.",
+							 NULL,
+							 &ppool_adaptive_buffers,
+							 false,
+							 PGC_SIGHUP,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomIntVariable("orioledb.undo_buffers",
 							"Size of orioledb engine undo log buffers.",
 							NULL,
@@ -450,6 +471,17 @@ _PG_init(void)
 							NULL,
 							NULL);
 
+	DefineCustomBoolVariable("orioledb.recovery_batch_apply",
+							 "Sorts modifications received by a recovery worker by key before applying.",
+							 NULL,
+							 &recovery_batch_apply_guc,
+							 true,
+							 PGC_POSTMASTER,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomIntVariable("orioledb.recovery_idx_pool_size",
 							"Sets the number of recovery index build workers.",
 							NULL,
@@ -529,6 +561,83 @@ _PG_init(void)
 							NULL,
 							NULL);
 
+	DefineCustomBoolVariable("orioledb.autoprewarm",
+							 "Warms up the page pool after restart using the "
+							 "periodically saved list of pages.",
+							 NULL,
+							 &orioledb_autoprewarm,
+							 false,
+							 PGC_POSTMASTER,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomIntVariable("orioledb.autoprewarm_interval",
+							"Sets the interval between dumps of the page pool contents.",
+							"If set to zero, the dump is done only at shutdown.",
+							&autoprewarm_interval,
+							300,
+							0,
+							INT_MAX / 1000,
+							PGC_SIGHUP,
+							GUC_UNIT_S,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable("orioledb.autoprewarm_workers",
+							"Number of processes loading pages during the warm-up.",
+							NULL,
+							&autoprewarm_workers,
+							2,
+							1,
+							MAX_BACKENDS,
+							PGC_POSTMASTER,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable("orioledb.stat_max_trees",
+							"Maximum number of trees to keep cumulative I/O statistics for.",
+							NULL,
+							&o_stat_max_trees,
+							1024,
+							0,
+							INT_MAX / 2,
+							PGC_POSTMASTER,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable("orioledb.wait_sample_interval",
+							"Time every n-th wait for page locks and IO.",
+							NULL,
+							&o_stat_wait_sample_interval,
+							8,
+							0,
+							INT_MAX,
+							PGC_USERSET,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable("orioledb.descr_cache_size",
+							"Size of the shared cache of table and index descriptions.",
+							NULL,
+							&o_descr_cache_size,
+							16384,
+							0,
+							INT_MAX / 2,
+							PGC_POSTMASTER,
+							GUC_UNIT_KB,
+							NULL,
+							NULL,
+							NULL);
+
 	DefineCustomIntVariable("orioledb.max_io_concurrency",
 							"Number of maximum concurrent IO operations.",
 							NULL,
@@ -553,6 +662,54 @@ _PG_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomEnumVariable("orioledb.buffers_huge_pages",
+							 "Use huge pages for orioledb page buffers.",
+							 NULL,
+							 &buffers_huge_pages,
+							 OBuffersHugePagesOff,
+							 buffers_huge_pages_options,
+							 PGC_POSTMASTER,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomIntVariable("orioledb.buffers_huge_page_size",
+							"Size of huge pages for orioledb page buffers.",
+							"0 means the default huge page size of the system.",
+							&buffers_huge_page_size,
+							0,
+							0,
+							INT_MAX,
+							PGC_POSTMASTER,
+							GUC_UNIT_KB,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomEnumVariable("orioledb.buffers_numa",
+							 "NUMA memory policy for orioledb page buffers.",
+							 NULL,
+							 &buffers_numa,
+							 OBuffersNumaOff,
+							 buffers_numa_options,
+							 PGC_POSTMASTER,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomStringVariable("orioledb.buffers_numa_nodes",
+							   "NUMA nodes for orioledb page buffers.",
+							   "Empty string means all the online nodes.",
+							   &buffers_numa_nodes,
+							   "",
+							   PGC_POSTMASTER,
+							   0,
+							   NULL,
+							   NULL,
+							   NULL);
+
 	DefineCustomStringVariable("orioledb.device_filename",
 							   "Data file for mmap.",
 							   NULL,
@@ -616,6 +773,19 @@ _PG_init(void)
 							NULL,
 							NULL);
 
+	DefineCustomIntVariable("orioledb.wal_compress",
+							"Compression level of orioledb WAL containers.",
+							NULL,
+							&wal_compress,
+							-1,
+							-1,
+							o_compress_max_lvl(),
+							PGC_SUSET,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
 	DefineCustomBoolVariable("orioledb.table_description_compress",
 							 "Display compression column in "
 							 "orioledb_table_description",
@@ -628,6 +798,18 @@ _PG_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable("orioledb.btree_suffix_truncation",
+							 "Truncate unneeded trailing attributes of "
+							 "separator keys on B-tree leaf page splits.",
+							 "Applies to trees created after the change.",
+							 &orioledb_btree_suffix_truncation,
+							 false,
+							 PGC_SIGHUP,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable("orioledb.use_sparse_files",
 							 "Punch sparse file holes for free blocks",
 							 NULL,
@@ -780,6 +962,20 @@ _PG_init(void)
 							   NULL,
 							   NULL);
 
+	DefineCustomIntVariable("orioledb.s3_archive_compress",
+							"Compression level of WAL and undo files archived "
+							"to S3.",
+							"-1 means no compression.",
+							&s3_archive_compress,
+							-1,
+							-1,
+							o_compress_max_lvl(),
+							PGC_POSTMASTER,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
 	if (orioledb_s3_mode)
 	{
 		if (!s3_host || !s3_region || !s3_accesskey || !s3_secretkey)
@@ -818,16 +1014,19 @@ _PG_init(void)
 
 	memset(page_pools, 0, OPagePoolTypesCount * sizeof(OPagePool));
 	page_pools_size[OPagePoolFreeTree] = ppool_estimate_space(&page_pools[OPagePoolFreeTree],
+															  OPagePoolFreeTree,
 															  0,
 															  free_tree_buffers_count,
 															  debug_disable_pools_limit);
 
 	page_pools_size[OPagePoolCatalog] = ppool_estimate_space(&page_pools[OPagePoolCatalog],
+															 OPagePoolCatalog,
 															 free_tree_buffers_count,
 															 catalog_buffers_count,
 															 debug_disable_pools_limit);
 
 	page_pools_size[OPagePoolMain] = ppool_estimate_space(&page_pools[OPagePoolMain],
+														  OPagePoolMain,
 														  main_buffers_offset,
 														  main_buffers_count,
 														  debug_disable_pools_limit);
@@ -870,6 +1069,9 @@ _PG_init(void)
 	for (i = 0; i < bgwriter_num_workers; i++)
 		register_bgwriter();
 
+	if (orioledb_autoprewarm)
+		register_autoprewarm();
+
 	if (orioledb_s3_mode)
 	{
 		const char *check_errmsg = NULL;
@@ -917,6 +1119,7 @@ _PG_init(void)
 	set_rel_pathlist_hook = orioledb_set_rel_pathlist_hook;
 	set_plain_rel_pathlist_hook = orioledb_set_plain_rel_pathlist_hook;
 	RegisterXactCallback(undo_xact_callback, NULL);
+	RegisterXactCallback(o_stat_xact_callback, NULL);
 	RegisterSubXactCallback(undo_subxact_callback, NULL);
 	CacheRegisterUsercacheCallback(orioledb_usercache_hook, PointerGetDatum(NULL));
 	CheckPoint_hook = o_perform_checkpoint;
@@ -1031,7 +1234,8 @@ ppools_shmem_needs(void)
 
 	for (i = 0; i < OPagePoolTypesCount; i++)
 		size = add_size(size, page_pools_size[i]);
-	size = add_size(size, orioledb_buffers_size);
+	if (!buffers_region_enabled())
+		size = add_size(size, orioledb_buffers_size);
 	size = add_size(size, page_descs_size);
 	return size;
 }
@@ -1047,8 +1251,15 @@ ppools_shmem_init(Pointer ptr, bool found)
 		page_pools_ptr[i] = ptr;
 		ptr += page_pools_size[i];
 	}
-	o_shared_buffers = ptr;
-	ptr += orioledb_buffers_size;
+	if (buffers_region_enabled())
+	{
+		o_shared_buffers = buffers_region_get(orioledb_buffers_size);
+	}
+	else
+	{
+		o_shared_buffers = ptr;
+		ptr += orioledb_buffers_size;
+	}
 	page_descs = (OrioleDBPageDesc *) ptr;
 
 	for (i = 0; i < OPagePoolTypesCount; i++)
@@ -1103,6 +1314,8 @@ orioledb_on_shmem_exit(int code, Datum arg)
 	if (MyProc)
 		pg_atomic_write_u64(&oProcData[MYPROCNUMBER].xmin, InvalidOXid);
 
+	o_stat_flush();
+
 	if (orioledb_s3_mode)
 		s3_delete_lock_file();
 }
@@ -1428,6 +1641,72 @@ orioledb_page_stats(PG_FUNCTION_ARGS)
 	return (Datum) 0;
 }
 
+static const char *
+ppool_type_name(OPagePoolType type)
+{
+	switch (type)
+	{
+		case OPagePoolMain:
+			return "main";
+		case OPagePoolFreeTree:
+			return "free_tree";
+		case OPagePoolCatalog:
+			return "catalog";
+	}
+	return NULL;
+}
+
+/*
+ * Returns current sizes of the page pools including the pages lent to the
+ * other pools and the pressure counters.
+ */
+Datum
+orioledb_get_page_pools(PG_FUNCTION_ARGS)
+{
+	Datum		values[8];
+	bool		nulls[8];
+	int			i;
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+
+	orioledb_check_shmem();
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	MemSet(nulls, 0, sizeof(nulls));
+	for (i = 0; i < OPagePoolTypesCount; i++)
+	{
+		OPagePool  *pool = &page_pools[i];
+
+		values[0] = PointerGetDatum(cstring_to_text(ppool_type_name((OPagePoolType) i)));
+		values[1] = Int64GetDatum((int64) pool->size);
+		values[2] = Int64GetDatum((int64) pg_atomic_read_u32(&pool->counters->lentPagesCount));
+		values[3] = Int64GetDatum((int64) pg_atomic_read_u32(&pool->counters->borrowedPagesCount));
+		values[4] = Int64GetDatum((int64) ppool_free_pages_count(pool));
+		values[5] = Int64GetDatum((int64) ppool_dirty_pages_count(pool));
+		values[6] = Int64GetDatum((int64) pg_atomic_read_u64(&pool->counters->borrowsCount));
+		values[7] = Int64GetDatum((int64) pg_atomic_read_u64(&pool->counters->evictionsCount));
+		tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
+	}
+
+	return (Datum) 0;
+}
+
 Datum
 orioledb_ucm_check(PG_FUNCTION_ARGS)
 {
@@ -1453,6 +1732,8 @@ o_invalidate_oids(ORelOids oids)
 
 	Assert(ORelOidsIsValid(oids));
 
+	o_descr_cache_invalidate(oids);
+
 	msg.usr.id = SHAREDINVALUSERCACHE_ID;
 	msg.usr.arg1 = oids.datoid;
 	msg.usr.arg2 = oids.reloid;
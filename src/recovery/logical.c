@@ -30,19 +30,315 @@
 #include "access/toast_compression.h"
 #include "access/detoast.h"
 #include "tuple/toast.h"
+#include "utils/hsearch.h"
 
 /*
- * Copy identity attributes from srcSlot to dstSlot.
+ * Subtransactions of the transactions being decoded.
+ *
+ * ReorderBuffer expects every subtransaction to be assigned directly to its
+ * top-level transaction, and expects aborts of subtransactions to be
+ * reported.  This is required to stream in-progress transactions.  OrioleDB
+ * writes no record on subtransaction release and doesn't switch the logical
+ * xid back to the parent.  So, subtransactions of a top-level transaction
+ * form a chain in the order of their start, and WAL_REC_ROLLBACK_TO_SAVEPOINT
+ * aborts the newest not yet aborted entries of the chain up to the one
+ * started under the given parent subtransaction.
+ */
+typedef struct
+{
+	TransactionId xid;			/* hash key */
+	TransactionId topXid;		/* top-level logical xid */
+	TransactionId prevXid;		/* previous entry of the chain */
+	TransactionId lastXid;		/* newest subtransaction, top-level only */
+	SubTransactionId parentSubid;
+	bool		aborted;
+} OLogicalXactEntry;
+
+/*
+ * Conversion buffers of a table.  Keyed by oids, so the table rewrite gets
+ * the new entry.  Buffers are reallocated when the table changes its
+ * attributes in place.
+ */
+typedef struct
+{
+	ORelOids	oids;			/* hash key */
+	int			natts;
+	int			ntoastable;
+	Datum	   *values;
+	bool	   *isnull;
+	char	   *toastPointers;	/* ntoastable * TOAST_POINTER_SIZE */
+} OLogicalRelEntry;
+
+/*
+ * State of the decoding session.  Lives in the memory of the decoding
+ * context.
+ */
+typedef struct
+{
+	LogicalDecodingContext *ctx;
+	HTAB	   *xacts;
+	HTAB	   *rels;
+	TupleDesc	toastTupDesc;	/* heap format of TOAST chunks */
+} OLogicalDecodeState;
+
+static OLogicalDecodeState *decodeState = NULL;
+
+static void
+decode_state_reset(void *arg)
+{
+	decodeState = NULL;
+}
+
+static OLogicalDecodeState *
+get_decode_state(LogicalDecodingContext *ctx)
+{
+	MemoryContext mcxt;
+	MemoryContextCallback *callback;
+	HASHCTL		ctl;
+
+	if (decodeState && decodeState->ctx == ctx)
+		return decodeState;
+
+	mcxt = MemoryContextSwitchTo(ctx->context);
+
+	decodeState = palloc0(sizeof(OLogicalDecodeState));
+	decodeState->ctx = ctx;
+
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(TransactionId);
+	ctl.entrysize = sizeof(OLogicalXactEntry);
+	ctl.hcxt = ctx->context;
+	decodeState->xacts = hash_create("orioledb logical decoding subtransactions",
+									 64, &ctl,
+									 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(ORelOids);
+	ctl.entrysize = sizeof(OLogicalRelEntry);
+	ctl.hcxt = ctx->context;
+	decodeState->rels = hash_create("orioledb logical decoding relations",
+									16, &ctl,
+									HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	callback = palloc(sizeof(*callback));
+	callback->func = decode_state_reset;
+	callback->arg = NULL;
+	MemoryContextRegisterResetCallback(ctx->context, callback);
+
+	MemoryContextSwitchTo(mcxt);
+
+	return decodeState;
+}
+
+/*
+ * Returns heap tupledesc for toast table.  Built once per decoding session.
+ */
+static TupleDesc
+get_decode_toast_tupdesc(LogicalDecodingContext *ctx)
+{
+	OLogicalDecodeState *state = get_decode_state(ctx);
+	MemoryContext mcxt;
+	TupleDesc	tupdesc;
+
+	if (state->toastTupDesc)
+		return state->toastTupDesc;
+
+	mcxt = MemoryContextSwitchTo(ctx->context);
+	tupdesc = CreateTemplateTupleDesc(3);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "chunk_id", OIDOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 2, "chunk_seq", INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 3, "chunk_data", BYTEAOID, -1, 0);
+	/* Ensure that the toast table doesn't itself get toasted */
+	TupleDescAttr(tupdesc, 0)->attstorage = TYPSTORAGE_PLAIN;
+	TupleDescAttr(tupdesc, 1)->attstorage = TYPSTORAGE_PLAIN;
+	TupleDescAttr(tupdesc, 2)->attstorage = TYPSTORAGE_PLAIN;
+	/* Toast field should not be compressed */
+	TupleDescAttr(tupdesc, 0)->attcompression = InvalidCompressionMethod;
+	TupleDescAttr(tupdesc, 1)->attcompression = InvalidCompressionMethod;
+	TupleDescAttr(tupdesc, 2)->attcompression = InvalidCompressionMethod;
+	MemoryContextSwitchTo(mcxt);
+
+	state->toastTupDesc = tupdesc;
+	return tupdesc;
+}
+
+/*
+ * Returns conversion buffers for the table.
+ */
+static OLogicalRelEntry *
+get_decode_rel(LogicalDecodingContext *ctx, OTableDescr *descr)
+{
+	OLogicalDecodeState *state = get_decode_state(ctx);
+	OLogicalRelEntry *entry;
+	bool		found;
+
+	entry = (OLogicalRelEntry *) hash_search(state->rels, &descr->oids,
+											 HASH_ENTER, &found);
+	if (found && entry->natts == descr->tupdesc->natts &&
+		entry->ntoastable == descr->ntoastable)
+		return entry;
+
+	if (found)
+	{
+		pfree(entry->values);
+		pfree(entry->isnull);
+		if (entry->toastPointers)
+			pfree(entry->toastPointers);
+	}
+
+	entry->natts = descr->tupdesc->natts;
+	entry->ntoastable = descr->ntoastable;
+	entry->values = MemoryContextAlloc(ctx->context,
+									   sizeof(Datum) * entry->natts);
+	entry->isnull = MemoryContextAlloc(ctx->context,
+									   sizeof(bool) * entry->natts);
+	entry->toastPointers = entry->ntoastable > 0 ?
+		MemoryContextAllocZero(ctx->context,
+							   TOAST_POINTER_SIZE * entry->ntoastable) :
+		NULL;
+
+	return entry;
+}
+
+static OLogicalXactEntry *
+logical_xact_find(LogicalDecodingContext *ctx, TransactionId xid)
+{
+	return (OLogicalXactEntry *) hash_search(get_decode_state(ctx)->xacts, &xid,
+											 HASH_FIND, NULL);
+}
+
+/*
+ * Returns the logical xid to attribute the changes of `xid` to.  Writer
+ * continues using the xid of the aborted subtransaction until the next
+ * savepoint, but its changes belong to the closest alive ancestor.
+ */
+static TransactionId
+logical_xact_resolve(LogicalDecodingContext *ctx, TransactionId xid)
+{
+	OLogicalXactEntry *entry = logical_xact_find(ctx, xid);
+
+	while (entry && entry->aborted)
+	{
+		xid = entry->prevXid;
+		entry = logical_xact_find(ctx, xid);
+	}
+	return xid;
+}
+
+/*
+ * Returns the top-level logical xid for `xid`.
+ */
+static TransactionId
+logical_xact_top(LogicalDecodingContext *ctx, TransactionId xid)
+{
+	OLogicalXactEntry *entry = logical_xact_find(ctx, xid);
+
+	return entry ? entry->topXid : xid;
+}
+
+/*
+ * Handles start of subtransaction `xid` under `parentXid`.
+ */
+static void
+logical_xact_assign(LogicalDecodingContext *ctx, TransactionId parentXid,
+					TransactionId xid, SubTransactionId parentSubid,
+					XLogRecPtr lsn)
+{
+	HTAB	   *xacts = get_decode_state(ctx)->xacts;
+	OLogicalXactEntry *top,
+			   *entry;
+	TransactionId topXid = logical_xact_top(ctx, parentXid);
+	bool		found;
+
+	top = (OLogicalXactEntry *) hash_search(xacts, &topXid, HASH_ENTER, &found);
+	if (!found)
+	{
+		top->topXid = topXid;
+		top->prevXid = InvalidTransactionId;
+		top->lastXid = topXid;
+		top->parentSubid = InvalidSubTransactionId;
+		top->aborted = false;
+	}
+
+	entry = (OLogicalXactEntry *) hash_search(xacts, &xid, HASH_ENTER, &found);
+	Assert(!found);
+	entry->topXid = topXid;
+	entry->prevXid = top->lastXid;
+	entry->lastXid = InvalidTransactionId;
+	entry->parentSubid = parentSubid;
+	entry->aborted = false;
+	top->lastXid = xid;
+
+	ReorderBufferAssignChild(ctx->reorder, topXid, xid, lsn);
+}
+
+/*
+ * Handles rollback of the subtransaction started under `parentSubid`
+ * together with its descendants.
  */
 static void
-tts_copy_identity(TupleTableSlot *srcSlot, TupleTableSlot *dstSlot,
-				  OIndexDescr *idx)
+logical_xact_rollback(LogicalDecodingContext *ctx, TransactionId xid,
+					  SubTransactionId parentSubid, XLogRecPtr lsn)
+{
+	OLogicalXactEntry *top,
+			   *entry;
+	TransactionId cur;
+
+	top = logical_xact_find(ctx, logical_xact_top(ctx, xid));
+	if (!top)
+		return;
+
+	cur = top->lastXid;
+	while (cur != top->xid)
+	{
+		entry = logical_xact_find(ctx, cur);
+		Assert(entry);
+		if (!entry->aborted)
+		{
+			entry->aborted = true;
+			ReorderBufferAbort(ctx->reorder, entry->xid, lsn, 0);
+			if (entry->parentSubid == parentSubid)
+				break;
+		}
+		cur = entry->prevXid;
+	}
+}
+
+/*
+ * Forgets subtransactions of the finished top-level transaction.
+ */
+static void
+logical_xact_forget(LogicalDecodingContext *ctx, TransactionId topXid)
+{
+	HTAB	   *xacts = get_decode_state(ctx)->xacts;
+	OLogicalXactEntry *top = logical_xact_find(ctx, topXid);
+	TransactionId cur;
+
+	if (!top)
+		return;
+
+	cur = top->lastXid;
+	while (cur != topXid)
+	{
+		OLogicalXactEntry *entry = logical_xact_find(ctx, cur);
+
+		Assert(entry);
+		cur = entry->prevXid;
+		hash_search(xacts, &entry->xid, HASH_REMOVE, NULL);
+	}
+	hash_search(xacts, &topXid, HASH_REMOVE, NULL);
+}
+
+/*
+ * Copy identity attributes from values to dstSlot.
+ */
+static void
+tts_copy_identity(Datum *values, bool *isnull, ItemPointer tid,
+				  TupleTableSlot *dstSlot, OIndexDescr *idx)
 {
 	int			i;
 	int			nattrs = dstSlot->tts_tupleDescriptor->natts;
 
-	slot_getallattrs(srcSlot);
-
 	dstSlot->tts_nvalid = nattrs;
 	for (i = 0; i < nattrs; i++)
 	{
@@ -57,39 +353,81 @@ tts_copy_identity(TupleTableSlot *srcSlot, TupleTableSlot *dstSlot,
 		attnum = idx->fields[i].tableAttnum - 1;
 		if (attnum >= 0)
 		{
-			dstSlot->tts_values[i] = srcSlot->tts_values[i];
-			dstSlot->tts_isnull[i] = srcSlot->tts_isnull[i];
+			dstSlot->tts_values[i] = values[i];
+			dstSlot->tts_isnull[i] = isnull[i];
 		}
 		else if (attnum == -1)
 		{
-			dstSlot->tts_tid = srcSlot->tts_tid;
+			if (tid)
+				dstSlot->tts_tid = *tid;
+			else
+				ItemPointerSetInvalid(&dstSlot->tts_tid);
 		}
 	}
 	dstSlot->tts_flags &= ~TTS_FLAG_EMPTY;
 }
 
+static inline HeapTuple
+record_buffer_heap_tuple(REORDER_BUFFER_TUPLE_TYPE buffer)
+{
+#if PG_VERSION_NUM >= 170000
+	return buffer;
+#else
+	return &buffer->tuple;
+#endif
+}
+
 /*
- * Saves the heap tuple to the reorder buffer.
+ * Forms the heap tuple directly in the reorder buffer memory.  Follows
+ * heap_form_tuple().
  */
 static REORDER_BUFFER_TUPLE_TYPE
-record_buffer_tuple(ReorderBuffer *reorder, HeapTuple htup, bool freeHtup)
+record_buffer_form_tuple(ReorderBuffer *reorder, TupleDesc tupdesc,
+						 Datum *values, bool *isnull)
 {
-	HeapTuple	changeTup;
 	REORDER_BUFFER_TUPLE_TYPE result;
+	HeapTuple	changeTup;
+	HeapTupleHeader td;
+	int			natts = tupdesc->natts;
+	bool		hasnull = false;
+	Size		len,
+				dataLen;
+	int			hoff;
+	int			i;
 
-	result = ReorderBufferGetTupleBuf(reorder, htup->t_len);
+	for (i = 0; i < natts; i++)
+	{
+		if (isnull[i])
+		{
+			hasnull = true;
+			break;
+		}
+	}
 
-#if PG_VERSION_NUM >= 170000
-	changeTup = result;
-#else
-	changeTup = &result->tuple;
-#endif
+	len = offsetof(HeapTupleHeaderData, t_bits);
+	if (hasnull)
+		len += BITMAPLEN(natts);
+	hoff = len = MAXALIGN(len);
+	dataLen = heap_compute_data_size(tupdesc, values, isnull);
+	len += dataLen;
+
+	result = ReorderBufferGetTupleBuf(reorder, len);
+	changeTup = record_buffer_heap_tuple(result);
+	td = changeTup->t_data;
+	memset(td, 0, len);
+
+	changeTup->t_len = len;
+	ItemPointerSetInvalid(&changeTup->t_self);
 	changeTup->t_tableOid = InvalidOid;
-	changeTup->t_len = htup->t_len;
-	changeTup->t_self = htup->t_self;
-	memcpy(changeTup->t_data, htup->t_data, htup->t_len);
-	if (freeHtup)
-		heap_freetuple(htup);
+
+	HeapTupleHeaderSetDatumLength(td, len);
+	HeapTupleHeaderSetTypeId(td, tupdesc->tdtypeid);
+	HeapTupleHeaderSetTypMod(td, tupdesc->tdtypmod);
+	HeapTupleHeaderSetNatts(td, natts);
+	td->t_hoff = hoff;
+
+	heap_fill_tuple(tupdesc, values, isnull, (char *) td + hoff, dataLen,
+					&td->t_infomask, (hasnull ? td->t_bits : NULL));
 
 	return result;
 }
@@ -100,12 +438,14 @@ record_buffer_tuple(ReorderBuffer *reorder, HeapTuple htup, bool freeHtup)
 static REORDER_BUFFER_TUPLE_TYPE
 record_buffer_tuple_slot(ReorderBuffer *reorder, TupleTableSlot *slot)
 {
-	HeapTuple	htup;
-	bool		freeHtup;
+	REORDER_BUFFER_TUPLE_TYPE result;
 
-	htup = ExecFetchSlotHeapTuple(slot, false, &freeHtup);
+	slot_getallattrs(slot);
+	result = record_buffer_form_tuple(reorder, slot->tts_tupleDescriptor,
+									  slot->tts_values, slot->tts_isnull);
+	record_buffer_heap_tuple(result)->t_self = slot->tts_tid;
 
-	return record_buffer_tuple(reorder, htup, freeHtup);
+	return result;
 }
 
 /* entry for a hash table we use to map from xid to our transaction state */
@@ -135,17 +475,18 @@ get_reorder_buffer_txn(ReorderBuffer *rb, TransactionId xid)
 }
 
 /*
- * Convert tuples from the main relation from OrioleDB to haep format with
- * conversion of TOAST pointers to PG format.
+ * Convert tuples from the main relation from OrioleDB to heap format with
+ * conversion of TOAST pointers to PG format.  Values are placed to the
+ * conversion buffers of the table.
  */
-static HeapTuple
-convert_toast_pointers(OTableDescr *descr, OIndexDescr *indexDescr,
-					   OFixedTuple tuple)
+static OLogicalRelEntry *
+convert_toast_pointers(LogicalDecodingContext *ctx, OTableDescr *descr,
+					   OIndexDescr *indexDescr, OFixedTuple tuple)
 {
+	OLogicalRelEntry *rel = get_decode_rel(ctx, descr);
 	int			natts = descr->tupdesc->natts;
-	Datum	   *old_values = palloc0(natts * sizeof(Datum));
-	Datum	   *new_values = palloc0(natts * sizeof(Datum));
-	bool	   *isnull = palloc0(natts * sizeof(bool));
+	Datum	   *values = rel->values;
+	bool	   *isnull = rel->isnull;
 	int			ctid_off = indexDescr->primaryIsCtid ? 1 : 0;
 
 	/*
@@ -153,13 +494,10 @@ convert_toast_pointers(OTableDescr *descr, OIndexDescr *indexDescr,
 	 */
 	Assert(descr->toast);
 	for (int i = 0; i < natts; i++)
-	{
-		old_values[i] = o_fastgetattr(tuple.tuple, i + 1,
-									  descr->tupdesc,
-									  &indexDescr->leafSpec,
-									  &isnull[i]);
-		new_values[i] = old_values[i];
-	}
+		values[i] = o_fastgetattr(tuple.tuple, i + 1,
+								  descr->tupdesc,
+								  &indexDescr->leafSpec,
+								  &isnull[i]);
 
 	/* Convert TOAST pointers */
 	for (int i = 0; i < descr->ntoastable; i++)
@@ -176,7 +514,7 @@ convert_toast_pointers(OTableDescr *descr, OIndexDescr *indexDescr,
 			continue;
 		}
 
-		old_toastptr = (struct varlena *) DatumGetPointer(old_values[toast_attn]);
+		old_toastptr = (struct varlena *) DatumGetPointer(values[toast_attn]);
 		if (old_toastptr == NULL || !VARATT_IS_EXTERNAL(old_toastptr))
 		{
 			elog(DEBUG4, "NON-toast or empty attr %u", toast_attn);
@@ -198,12 +536,12 @@ convert_toast_pointers(OTableDescr *descr, OIndexDescr *indexDescr,
 			 (ve.va_extinfo & VARLENA_EXTSIZE_MASK),
 			 ve.va_toastrelid, ve.va_valueid);
 
-		new_toastptr = palloc0(TOAST_POINTER_SIZE);
+		new_toastptr = (struct varlena *) (rel->toastPointers + i * TOAST_POINTER_SIZE);
 		SET_VARTAG_EXTERNAL(new_toastptr, VARTAG_ONDISK);
 		memcpy(VARDATA_EXTERNAL(new_toastptr), &ve, sizeof(ve));
-		new_values[toast_attn] = PointerGetDatum(new_toastptr);
+		values[toast_attn] = PointerGetDatum(new_toastptr);
 	}
-	return heap_form_tuple(descr->tupdesc, new_values, isnull);
+	return rel;
 }
 
 /*
@@ -216,8 +554,11 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 	XLogRecPtr	startXLogPtr = record->ReadRecPtr;
 	XLogRecPtr	endXLogPtr = record->EndRecPtr;
 	Pointer		startPtr = (Pointer) XLogRecGetData(record);
-	Pointer		endPtr = startPtr + XLogRecGetDataLen(record);
-	Pointer		ptr = startPtr;
+	int			dataLength = XLogRecGetDataLen(record);
+	bool		compressed = (XLogRecGetInfo(record) & ORIOLEDB_XLOG_COMPRESSED) != 0;
+	Pointer		endPtr;
+	Pointer		ptr;
+	int			recno = 0;
 	OTableDescr *descr = NULL;
 	OIndexDescr *indexDescr = NULL;
 	int			sys_tree_num = -1;
@@ -230,8 +571,17 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 	TupleDescData *o_toast_tupDesc = NULL;
 	TupleDescData *heap_toast_tupDesc = NULL;
 
+	if (compressed)
+		startPtr = wal_container_decompress(startPtr, &dataLength);
+	endPtr = startPtr + dataLength;
+	ptr = startPtr;
+
 	while (ptr < endPtr)
 	{
+		XLogRecPtr	recXLogPtr = wal_container_rec_ptr(startXLogPtr,
+													   compressed, recno++,
+													   ptr - startPtr);
+
 		rec_type = *ptr;
 		ptr++;
 
@@ -247,6 +597,7 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 			 rec_type == WAL_REC_ROLLBACK_TO_SAVEPOINT ? "ROLLBACK TO SAVEPOINT" :
 			 rec_type == WAL_REC_INSERT ? "INSERT" :
 			 rec_type == WAL_REC_UPDATE ? "UPDATE" :
+			 rec_type == WAL_REC_UPDATE_DELTA ? "UPDATE DELTA" :
 			 rec_type == WAL_REC_DELETE ? "DELETE" : "_UNKNOWN");
 
 		if (rec_type == WAL_REC_XID)
@@ -256,12 +607,14 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 
 			memcpy(&logicalXid, ptr, sizeof(TransactionId));
 			ptr += sizeof(TransactionId);
+			logicalXid = logical_xact_resolve(ctx, logicalXid);
 		}
 		else if (rec_type == WAL_REC_COMMIT || rec_type == WAL_REC_ROLLBACK)
 		{
 			OXid		xmin;
 			dlist_iter	cur_txn_i;
 			ReorderBufferTXN *txn;
+			TransactionId topXid = logical_xact_top(ctx, logicalXid);
 			CommitSeqNo csn;
 			CSNSnapshotData csnSnapshot;
 
@@ -276,19 +629,19 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 
 			SnapBuildUpdateCSNSnaphot(ctx->snapshot_builder, &csnSnapshot);
 
-			txn = get_reorder_buffer_txn(ctx->reorder, logicalXid);
-			if (txn->toptxn)
-				txn = txn->toptxn;
-
-			dlist_foreach(cur_txn_i, &txn->subtxns)
+			txn = get_reorder_buffer_txn(ctx->reorder, topXid);
+			if (txn)
 			{
-				ReorderBufferTXN *cur_txn;
+				dlist_foreach(cur_txn_i, &txn->subtxns)
+				{
+					ReorderBufferTXN *cur_txn;
 
-				cur_txn = dlist_container(ReorderBufferTXN, node, cur_txn_i.cur);
+					cur_txn = dlist_container(ReorderBufferTXN, node, cur_txn_i.cur);
 
-				ReorderBufferCommitChild(ctx->reorder, txn->xid, cur_txn->xid,
-										 startXLogPtr, endXLogPtr);
+					ReorderBufferCommitChild(ctx->reorder, txn->xid, cur_txn->xid,
+											 startXLogPtr, endXLogPtr);
 
+				}
 			}
 
 			/*
@@ -298,16 +651,17 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 			if (rec_type == WAL_REC_COMMIT &&
 				!SnapBuildXactNeedsSkip(ctx->snapshot_builder, endXLogPtr - 1))
 			{
-				ReorderBufferCommit(ctx->reorder, logicalXid,
+				ReorderBufferCommit(ctx->reorder, topXid,
 									startXLogPtr, endXLogPtr,
 									0, XLogRecGetOrigin(buf->record),
 									buf->origptr);
 			}
 			else
 			{
-				ReorderBufferAbort(ctx->reorder, logicalXid,
+				ReorderBufferAbort(ctx->reorder, topXid,
 								   startXLogPtr, 0);
 			}
+			logical_xact_forget(ctx, topXid);
 			UpdateDecodingStats(ctx);
 
 			oxid = InvalidOXid;
@@ -316,6 +670,7 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 		else if (rec_type == WAL_REC_JOINT_COMMIT)
 		{
 			TransactionId xid;
+			TransactionId topXid = logical_xact_top(ctx, logicalXid);
 			OXid		xmin;
 			CommitSeqNo csn;
 			CSNSnapshotData csnSnapshot;
@@ -335,16 +690,17 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 
 			if (!SnapBuildXactNeedsSkip(ctx->snapshot_builder, endXLogPtr))
 			{
-				ReorderBufferCommit(ctx->reorder, logicalXid,
+				ReorderBufferCommit(ctx->reorder, topXid,
 									startXLogPtr, endXLogPtr,
 									0, XLogRecGetOrigin(buf->record),
 									buf->origptr);
 			}
 			else
 			{
-				ReorderBufferAbort(ctx->reorder, logicalXid,
+				ReorderBufferAbort(ctx->reorder, topXid,
 								   startXLogPtr, 0);
 			}
+			logical_xact_forget(ctx, topXid);
 			UpdateDecodingStats(ctx);
 
 			oxid = InvalidOXid;
@@ -384,19 +740,8 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 				indexDescr = o_fetch_index_descr(cur_oids, ix_type, false, NULL);
 				descr = o_fetch_table_descr(indexDescr->tableOids);
 				o_toast_tupDesc = descr->toast->leafTupdesc;
-				/* Init heap tupledesc for toast table */
-				heap_toast_tupDesc = CreateTemplateTupleDesc(3);
-				TupleDescInitEntry(heap_toast_tupDesc, (AttrNumber) 1, "chunk_id", OIDOID, -1, 0);
-				TupleDescInitEntry(heap_toast_tupDesc, (AttrNumber) 2, "chunk_seq", INT4OID, -1, 0);
-				TupleDescInitEntry(heap_toast_tupDesc, (AttrNumber) 3, "chunk_data", BYTEAOID, -1, 0);
-				/* Ensure that the toast table doesn't itself get toasted */
-				TupleDescAttr(heap_toast_tupDesc, 0)->attstorage = TYPSTORAGE_PLAIN;
-				TupleDescAttr(heap_toast_tupDesc, 1)->attstorage = TYPSTORAGE_PLAIN;
-				TupleDescAttr(heap_toast_tupDesc, 2)->attstorage = TYPSTORAGE_PLAIN;
-				/* Toast field should not be compressed */
-				TupleDescAttr(heap_toast_tupDesc, 0)->attcompression = InvalidCompressionMethod;
-				TupleDescAttr(heap_toast_tupDesc, 1)->attcompression = InvalidCompressionMethod;
-				TupleDescAttr(heap_toast_tupDesc, 2)->attcompression = InvalidCompressionMethod;
+				/* Heap tupledesc for toast table is built once per session */
+				heap_toast_tupDesc = get_decode_toast_tupdesc(ctx);
 
 				/*
 				 * indexDescr = o_fetch_index_descr(cur_oids, ix_type, false,
@@ -453,9 +798,8 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 			memcpy(&parentLogicalXid, ptr, sizeof(TransactionId));
 			ptr += sizeof(TransactionId);
 
-			ReorderBufferAssignChild(ctx->reorder, parentLogicalXid, logicalXid, buf->origptr);
-
-			/* Skip */
+			logical_xact_assign(ctx, parentLogicalXid, logicalXid,
+								parentSubid, buf->origptr);
 		}
 		else if (rec_type == WAL_REC_ROLLBACK_TO_SAVEPOINT)
 		{
@@ -464,15 +808,32 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 			memcpy(&parentSubid, ptr, sizeof(SubTransactionId));
 			ptr += sizeof(SubTransactionId);
 
-			/* Skip */
+			/*
+			 * Aborts of streamed subtransactions are sent to the output
+			 * plugin, others are just dropped from the reorder buffer.
+			 */
+			logical_xact_rollback(ctx, logicalXid, parentSubid, recXLogPtr);
+			logicalXid = logical_xact_resolve(ctx, logicalXid);
 		}
 		else
 		{
 			OFixedTuple tuple;
 			ReorderBufferChange *change;
-			XLogRecPtr	changeXLogPtr = startXLogPtr + (ptr - startPtr);
+			XLogRecPtr	changeXLogPtr = recXLogPtr + 1;
+
+			Assert(rec_type == WAL_REC_INSERT || rec_type == WAL_REC_UPDATE ||
+				   rec_type == WAL_REC_DELETE || rec_type == WAL_REC_UPDATE_DELTA);
 
-			Assert(rec_type == WAL_REC_INSERT || rec_type == WAL_REC_UPDATE || rec_type == WAL_REC_DELETE);
+			/*
+			 * Delta update records lack the unchanged attributes, and there
+			 * is no old row version to take them from.  They are never
+			 * written with wal_level = logical.
+			 */
+			if (rec_type == WAL_REC_UPDATE_DELTA)
+				ereport(ERROR,
+						(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+						 errmsg("could not decode orioledb delta update record"),
+						 errdetail("Delta update records are written only when \"wal_level\" is lower than \"logical\".")));
 
 			ReorderBufferProcessXid(ctx->reorder, logicalXid, changeXLogPtr);
 
@@ -539,13 +900,11 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 									new_chunk_size; /* without header */
 						Pointer		old_chunk;
 						Pointer		new_chunk = NULL;
-						HeapTuple	toasttup;
 						Datum		t_values[3];
 						bool		t_isnull[3];
 						bool		attnum_isnull,
 									chunk_seq_isnull;
 						int			pk_natts;
-						bool		need_to_free = false;
 
 						Assert(o_toast_tupDesc);
 						pk_natts = o_toast_tupDesc->natts - TOAST_LEAF_FIELDS_NUM;
@@ -562,7 +921,9 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 						 * ReorderBufferToastReplace() expects first toasted
 						 * chunk without the header of the whole toasted value
 						 * and reconstructs it itself. Cut this extra header
-						 * from OrioleDB toasted chunk.
+						 * from OrioleDB toasted chunk.  The tuple is our own
+						 * copy, so just overwrite the extra header with the
+						 * header of the shortened chunk.
 						 */
 						if (chunk_seq == 0)
 						{
@@ -571,11 +932,8 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 							Assert(VARATT_IS_4B(VARDATA(old_chunk)));
 							extra_header_size = VARHDRSZ;
 							new_chunk_size = old_chunk_size - extra_header_size;
-							need_to_free = true;
-							new_chunk = palloc0(new_chunk_size + VARHDRSZ);
-							memcpy(new_chunk, old_chunk, VARHDRSZ);
+							new_chunk = old_chunk + extra_header_size;
 							SET_VARSIZE(new_chunk, new_chunk_size + VARHDRSZ);
-							memcpy(VARDATA(new_chunk), VARDATA(old_chunk) + extra_header_size, new_chunk_size);
 						}
 						else
 						{
@@ -596,15 +954,10 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 							 length, pk_natts);
 
 						Assert(heap_toast_tupDesc);
-						toasttup = heap_form_tuple(heap_toast_tupDesc, t_values, t_isnull);
-						change->data.tp.newtuple = record_buffer_tuple(ctx->reorder, toasttup, true);
+						change->data.tp.newtuple = record_buffer_form_tuple(ctx->reorder,
+																			heap_toast_tupDesc,
+																			t_values, t_isnull);
 						change->data.tp.clear_toast_afterwards = false;
-
-						if (need_to_free && new_chunk)
-						{
-							pfree(new_chunk);
-							need_to_free = false;
-						}
 					}
 					else
 					{
@@ -616,10 +969,13 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 						 */
 						if (descr->ntoastable > 0)
 						{
-							HeapTuple	newheaptuple;
+							OLogicalRelEntry *rel;
 
-							newheaptuple = convert_toast_pointers(descr, indexDescr, tuple);
-							change->data.tp.newtuple = record_buffer_tuple(ctx->reorder, newheaptuple, true);
+							rel = convert_toast_pointers(ctx, descr, indexDescr, tuple);
+							change->data.tp.newtuple = record_buffer_form_tuple(ctx->reorder,
+																				descr->tupdesc,
+																				rel->values,
+																				rel->isnull);
 							Assert(change->data.tp.newtuple);
 						}
 						else	/* Tuple without TOASTed attrs */
@@ -664,11 +1020,15 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 					 */
 					if (descr->ntoastable > 0)
 					{
-						HeapTuple	newheaptuple;
-
-						newheaptuple = convert_toast_pointers(descr, indexDescr, tuple);
-						ExecForceStoreHeapTuple(newheaptuple, descr->newTuple, false);
-						change->data.tp.newtuple = record_buffer_tuple(ctx->reorder, newheaptuple, true);
+						OLogicalRelEntry *rel;
+
+						rel = convert_toast_pointers(ctx, descr, indexDescr, tuple);
+						change->data.tp.newtuple = record_buffer_form_tuple(ctx->reorder,
+																			descr->tupdesc,
+																			rel->values,
+																			rel->isnull);
+						tts_copy_identity(rel->values, rel->isnull, NULL,
+										  descr->oldTuple, GET_PRIMARY(descr));
 					}
 					else		/* Tuple without TOASTed attrs */
 					{
@@ -678,9 +1038,11 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 												 NULL);
 
 						change->data.tp.newtuple = record_buffer_tuple_slot(ctx->reorder, descr->newTuple);
+						tts_copy_identity(descr->newTuple->tts_values,
+										  descr->newTuple->tts_isnull,
+										  &descr->newTuple->tts_tid,
+										  descr->oldTuple, GET_PRIMARY(descr));
 					}
-					tts_copy_identity(descr->newTuple, descr->oldTuple,
-									  GET_PRIMARY(descr));
 					change->data.tp.oldtuple = record_buffer_tuple_slot(ctx->reorder, descr->oldTuple);
 
 					ReorderBufferQueueChange(ctx->reorder, logicalXid,
@@ -720,10 +1082,13 @@ orioledb_decode(LogicalDecodingContext *ctx, XLogRecordBuffer *buf)
 						 */
 						if (descr->ntoastable > 0)
 						{
-							HeapTuple	oldheaptuple;
+							OLogicalRelEntry *rel;
 
-							oldheaptuple = convert_toast_pointers(descr, indexDescr, tuple);
-							change->data.tp.oldtuple = record_buffer_tuple(ctx->reorder, oldheaptuple, true);
+							rel = convert_toast_pointers(ctx, descr, indexDescr, tuple);
+							change->data.tp.oldtuple = record_buffer_form_tuple(ctx->reorder,
+																				descr->tupdesc,
+																				rel->values,
+																				rel->isnull);
 						}
 						else	/* Tuple without TOASTed attrs */
 						{
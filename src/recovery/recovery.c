@@ -37,6 +37,7 @@
 #include "access/hash.h"
 #include "access/xlog_internal.h"
 #include "access/xlogrecovery.h"
+#include "funcapi.h"
 #include "lib/ilist.h"
 #include "lib/pairingheap.h"
 #include "miscadmin.h"
@@ -48,6 +49,7 @@
 #include "storage/shm_mq.h"
 #include "storage/standby.h"
 #include "utils/memutils.h"
+#include "utils/pg_lsn.h"
 #include "utils/typcache.h"
 
 #include <unistd.h>
@@ -130,6 +132,7 @@ typedef struct
 
 
 PG_FUNCTION_INFO_V1(orioledb_recovery_synchronized);
+PG_FUNCTION_INFO_V1(orioledb_get_recovery_workers);
 
 /*
  * Comparator for undo retain min-heap.
@@ -242,6 +245,11 @@ int			recovery_queue_size_guc;
 
 int			recovery_parallel_indices_rebuild_limit_guc;
 
+/*
+ * GUC value, sort modifications by key in the recovery workers.
+ */
+bool		recovery_batch_apply_guc = true;
+
 /*
  * Are TOAST trees consistent with primary indices.
  */
@@ -280,7 +288,7 @@ static void flush_current_undo_stack(void);
 static void o_handle_startup_proc_interrupts_hook(void);
 static void abort_recovery(RecoveryWorkerState *workers_pool, bool send_to_idx_pool);
 
-static void replay_container(Pointer ptr, Pointer endPtr,
+static void replay_container(Pointer ptr, Pointer endPtr, bool compressed,
 							 bool single, XLogRecPtr xlogRecPtr);
 
 static void worker_send_modify(int worker_id, BTreeDescr *desc, uint16 recType,
@@ -400,6 +408,10 @@ recovery_shmem_init(Pointer ptr, bool found)
 			pg_atomic_init_u64(&worker_ptrs[i].commitPtr, InvalidXLogRecPtr);
 			pg_atomic_init_u64(&worker_ptrs[i].retainPtr, InvalidXLogRecPtr);
 			worker_ptrs[i].flushedUndoLocCompletedCheckpointNumber = 0;
+			pg_atomic_init_u64(&worker_ptrs[i].appliedModifies, 0);
+			pg_atomic_init_u64(&worker_ptrs[i].sortedBatches, 0);
+			pg_atomic_init_u64(&worker_ptrs[i].sortedModifies, 0);
+			pg_atomic_init_u64(&worker_ptrs[i].applyTimeUs, 0);
 		}
 		pg_atomic_init_u64(recovery_ptr, InvalidXLogRecPtr);
 		pg_atomic_init_u64(recovery_main_retain_ptr, InvalidXLogRecPtr);
@@ -653,9 +665,12 @@ orioledb_redo(XLogReaderState *record)
 {
 	Pointer		msg_start = (Pointer) XLogRecGetData(record);
 	int			msg_len = XLogRecGetDataLen(record);
+	bool		compressed;
 	bool		recovery_single;
 
-	Assert((XLogRecGetInfo(record) & ~XLR_INFO_MASK) == ORIOLEDB_XLOG_CONTAINER);
+	Assert((XLogRecGetInfo(record) & ~(XLR_INFO_MASK | ORIOLEDB_XLOG_COMPRESSED)) ==
+		   ORIOLEDB_XLOG_CONTAINER);
+	compressed = (XLogRecGetInfo(record) & ORIOLEDB_XLOG_COMPRESSED) != 0;
 	recovery_single = *recovery_single_process;
 
 	if (record->ReadRecPtr >= checkpoint_state->controlToastConsistentPtr)
@@ -667,7 +682,9 @@ orioledb_redo(XLogReaderState *record)
 
 	if (record->ReadRecPtr >= checkpoint_state->controlReplayStartPtr)
 	{
-		replay_container(msg_start, msg_start + msg_len,
+		if (compressed)
+			msg_start = wal_container_decompress(msg_start, &msg_len);
+		replay_container(msg_start, msg_start + msg_len, compressed,
 						 recovery_single, record->ReadRecPtr);
 	}
 
@@ -1570,6 +1587,52 @@ recovery_rec_update(BTreeDescr *desc, OTuple tuple, bool *allocated, int *size)
 	return tuple;
 }
 
+/*
+ * Makes the delta update record: the key followed by the delta of the tuple
+ * relative to the old tuple.  Returns null tuple if the record wouldn't be
+ * shorter than the whole tuple.
+ */
+OTuple
+recovery_rec_update_delta(BTreeDescr *desc, OTuple tuple, OTuple oldTuple,
+						  bool *allocated, int *size)
+{
+	OIndexDescr *id = (OIndexDescr *) desc->arg;
+	OTuple		key,
+				result;
+	bool		key_pfree;
+	int			tuple_len,
+				key_len,
+				delta_len;
+
+	Assert(desc->type == oIndexPrimary && !IS_SYS_TREE_OIDS(desc->oids));
+
+	tuple_len = o_btree_len(desc, tuple, OTupleLength);
+	key = o_btree_tuple_make_key(desc, tuple, NULL, true, &key_pfree);
+	key_len = o_btree_len(desc, key, OKeyLength);
+
+	result.formatFlags = key.formatFlags;
+	result.data = (Pointer) palloc(tuple_len);
+	memcpy(result.data, key.data, key_len);
+	if (key_pfree)
+		pfree(key.data);
+
+	delta_len = o_tuple_make_delta(id->leafTupdesc, &id->leafSpec,
+								   oldTuple, tuple, result.data + key_len,
+								   tuple_len - key_len - 1);
+	if (delta_len < 0)
+	{
+		pfree(result.data);
+		O_TUPLE_SET_NULL(result);
+		*allocated = false;
+		*size = 0;
+		return result;
+	}
+
+	*allocated = true;
+	*size = key_len + delta_len;
+	return result;
+}
+
 OTuple
 recovery_rec_delete(BTreeDescr *desc, OTuple tuple, bool *allocated, int *size)
 {
@@ -1611,6 +1674,54 @@ orioledb_recovery_synchronized(PG_FUNCTION_ARGS)
 	PG_RETURN_BOOL(true);
 }
 
+/*
+ * Returns the apply statistics of the recovery workers.
+ */
+Datum
+orioledb_get_recovery_workers(PG_FUNCTION_ARGS)
+{
+	Datum		values[6];
+	bool		nulls[6];
+	int			i;
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+
+	orioledb_check_shmem();
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	MemSet(nulls, 0, sizeof(nulls));
+	for (i = 0; i < recovery_pool_size_guc; i++)
+	{
+		RecoveryWorkerPtrs *ptrs = &worker_ptrs[i];
+
+		values[0] = Int32GetDatum(i);
+		values[1] = LSNGetDatum(pg_atomic_read_u64(&ptrs->commitPtr));
+		values[2] = Int64GetDatum((int64) pg_atomic_read_u64(&ptrs->appliedModifies));
+		values[3] = Int64GetDatum((int64) pg_atomic_read_u64(&ptrs->sortedBatches));
+		values[4] = Int64GetDatum((int64) pg_atomic_read_u64(&ptrs->sortedModifies));
+		values[5] = Float8GetDatum((double) pg_atomic_read_u64(&ptrs->applyTimeUs) / 1000.0);
+		tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
+	}
+
+	return (Datum) 0;
+}
+
 static void
 update_run_xmin(void)
 {
@@ -2449,10 +2560,11 @@ handle_o_tables_meta_unlock(ORelOids oids, Oid oldRelnode)
 }
 
 /*
- * Replays a single orioledb WAL container.
+ * Replays a single orioledb WAL container.  Compressed container should be
+ * already decompressed by the caller.
  */
 static void
-replay_container(Pointer startPtr, Pointer endPtr,
+replay_container(Pointer startPtr, Pointer endPtr, bool compressed,
 				 bool single, XLogRecPtr xlogRecPtr)
 {
 	OTableDescr *descr = NULL;
@@ -2467,10 +2579,12 @@ replay_container(Pointer startPtr, Pointer endPtr,
 	int			sys_tree_num = -1;
 	Pointer		ptr = startPtr;
 	XLogRecPtr	xlogPtr;
+	int			recno = 0;
 
 	while (ptr < endPtr)
 	{
-		xlogPtr = xlogRecPtr + (ptr - startPtr);
+		xlogPtr = wal_container_rec_ptr(xlogRecPtr, compressed, recno++,
+										ptr - startPtr);
 		rec_type = *ptr;
 		ptr++;
 
@@ -2662,7 +2776,8 @@ replay_container(Pointer startPtr, Pointer endPtr,
 		{
 			OFixedTuple tuple;
 
-			Assert(rec_type == WAL_REC_INSERT || rec_type == WAL_REC_UPDATE || rec_type == WAL_REC_DELETE);
+			Assert(rec_type == WAL_REC_INSERT || rec_type == WAL_REC_UPDATE ||
+				   rec_type == WAL_REC_DELETE || rec_type == WAL_REC_UPDATE_DELTA);
 
 			tuple.tuple.formatFlags = *ptr;
 			ptr++;
@@ -3245,6 +3360,12 @@ spread_idx_modify(BTreeDescr *desc, uint16 recType, OTuple rec)
 			worker_send_modify(GET_WORKER_ID(hash), desc, recType,
 							   rec, key_len);
 			break;
+		case RECOVERY_UPDATE_DELTA:
+			key_len = o_btree_len(desc, rec, OKeyLength);
+			hash = o_btree_hash(desc, rec, BTreeKeyNonLeafKey);
+			worker_send_modify(GET_WORKER_ID(hash), desc, recType, rec,
+							   key_len + o_tuple_delta_length(rec.data + key_len));
+			break;
 		default:
 			Assert(false);
 	}
@@ -3264,6 +3385,8 @@ recovery_msg_from_wal_record(uint8 wal_record)
 			return RECOVERY_DELETE;
 		case WAL_REC_UPDATE:
 			return RECOVERY_UPDATE;
+		case WAL_REC_UPDATE_DELTA:
+			return RECOVERY_UPDATE_DELTA;
 		default:
 			Assert(false);
 			elog(ERROR, "Wrong WAL record modify type %d", wal_record);
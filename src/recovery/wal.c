@@ -20,12 +20,18 @@
 #include "recovery/wal.h"
 #include "tableam/descr.h"
 #include "transam/oxid.h"
+#include "utils/compress.h"
+#include "utils/o_stat.h"
 
+#include "portability/instr_time.h"
 #include "replication/message.h"
 #include "storage/proc.h"
 
 static char local_wal_buffer[LOCAL_WAL_BUFFER_SIZE];
 static int	local_wal_buffer_offset = 0;
+static int	local_wal_buffer_nrecords = 0;
+static char compressed_wal_buffer[LOCAL_WAL_BUFFER_SIZE];
+static char decompressed_wal_buffer[LOCAL_WAL_BUFFER_SIZE];
 static bool local_wal_has_material_changes = false;
 static ORelOids local_oids = {InvalidOid, InvalidOid, InvalidOid};
 static OIndexType local_type = oIndexInvalid;
@@ -59,7 +65,8 @@ add_modify_wal_record(uint8 rec_type, BTreeDescr *desc,
 	}
 
 	Assert(!is_recovery_process());
-	Assert(rec_type == WAL_REC_INSERT || rec_type == WAL_REC_UPDATE || rec_type == WAL_REC_DELETE);
+	Assert(rec_type == WAL_REC_INSERT || rec_type == WAL_REC_UPDATE ||
+		   rec_type == WAL_REC_DELETE || rec_type == WAL_REC_UPDATE_DELTA);
 
 	required_length = sizeof(WALRecModify) + length;
 
@@ -94,6 +101,7 @@ add_local_modify(uint8 record_type, OTuple record, OffsetNumber length)
 	local_wal_buffer_offset += sizeof(*wal_rec);
 	memcpy(&local_wal_buffer[local_wal_buffer_offset], record.data, length);
 	local_wal_buffer_offset += length;
+	local_wal_buffer_nrecords++;
 	local_wal_has_material_changes = true;
 }
 
@@ -107,6 +115,7 @@ wal_commit(OXid oxid, TransactionId logicalXid)
 	if (!local_wal_has_material_changes)
 	{
 		local_wal_buffer_offset = 0;
+		local_wal_buffer_nrecords = 0;
 		local_type = oIndexInvalid;
 		local_oids.datoid = InvalidOid;
 		local_oids.reloid = InvalidOid;
@@ -165,6 +174,7 @@ wal_rollback(OXid oxid, TransactionId logicalXid)
 	if (!local_wal_has_material_changes)
 	{
 		local_wal_buffer_offset = 0;
+		local_wal_buffer_nrecords = 0;
 		local_type = oIndexInvalid;
 		local_oids.datoid = InvalidOid;
 		local_oids.reloid = InvalidOid;
@@ -204,6 +214,7 @@ add_finish_wal_record(uint8 rec_type, OXid xmin)
 	memcpy(rec->csn, &csn, sizeof(csn));
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 }
 
 static void
@@ -225,6 +236,7 @@ add_joint_commit_wal_record(TransactionId xid, OXid xmin)
 	csn = pg_atomic_read_u64(&TRANSAM_VARIABLES->nextCommitSeqNo);
 	memcpy(rec->csn, &csn, sizeof(csn));
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 }
 
 /*
@@ -245,6 +257,7 @@ add_xid_wal_record(OXid oxid, TransactionId logicalXid)
 	memcpy(rec->logicalXid, &logicalXid, sizeof(TransactionId));
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 }
 
 static void
@@ -275,6 +288,7 @@ add_rel_wal_record(ORelOids oids, OIndexType type)
 	memcpy(rec->relnode, &oids.relnode, sizeof(Oid));
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 
 	local_type = type;
 	local_oids = oids;
@@ -296,6 +310,7 @@ add_o_tables_meta_lock_wal_record(void)
 	rec->recType = WAL_REC_O_TABLES_META_LOCK;
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 }
 
 void
@@ -318,6 +333,7 @@ add_o_tables_meta_unlock_wal_record(ORelOids oids, Oid oldRelnode)
 	memcpy(rec->new_relnode, &oids.relnode, sizeof(Oid));
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 }
 
 void
@@ -341,6 +357,7 @@ add_savepoint_wal_record(SubTransactionId parentSubid,
 	memcpy(rec->logicalXid, &logicalXid, sizeof(TransactionId));
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 }
 
 void
@@ -360,6 +377,7 @@ add_rollback_to_savepoint_wal_record(SubTransactionId parentSubid)
 	memcpy(rec->parentSubid, &parentSubid, sizeof(SubTransactionId));
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 }
 
 bool
@@ -382,11 +400,13 @@ flush_local_wal(bool commit)
 
 	if (commit)
 		pg_atomic_write_u64(&GET_CUR_PROCDATA()->commitInProgressXlogLocation, OWalTmpCommitPos);
-	location = log_logical_wal_container(local_wal_buffer, length);
+	location = log_logical_wal_container(local_wal_buffer, length,
+										 local_wal_buffer_nrecords);
 	if (commit)
 		pg_atomic_write_u64(&GET_CUR_PROCDATA()->commitInProgressXlogLocation, location);
 
 	local_wal_buffer_offset = 0;
+	local_wal_buffer_nrecords = 0;
 	local_type = oIndexInvalid;
 	local_oids.datoid = InvalidOid;
 	local_oids.reloid = InvalidOid;
@@ -402,9 +422,11 @@ flush_local_wal_if_needed(int required_length)
 	Assert(!is_recovery_process());
 	if (local_wal_buffer_offset + required_length > LOCAL_WAL_BUFFER_SIZE)
 	{
-		log_logical_wal_container(local_wal_buffer, local_wal_buffer_offset);
+		log_logical_wal_container(local_wal_buffer, local_wal_buffer_offset,
+								  local_wal_buffer_nrecords);
 
 		local_wal_buffer_offset = 0;
+		local_wal_buffer_nrecords = 0;
 		local_type = oIndexInvalid;
 		local_oids.datoid = InvalidOid;
 		local_oids.reloid = InvalidOid;
@@ -413,12 +435,110 @@ flush_local_wal_if_needed(int required_length)
 	}
 }
 
+/*
+ * Compresses the container of `nrecords` records.  Returns NULL if the
+ * compression doesn't save space.
+ */
+static Pointer
+wal_container_compress(Pointer ptr, int length, int nrecords,
+					   int *resultLength)
+{
+	WALContainerCompressed *header;
+	Pointer		data;
+	size_t		dataLength;
+	int			totalLength;
+	uint16		len;
+	instr_time	start_time,
+				duration;
+
+	INSTR_TIME_SET_CURRENT(start_time);
+	data = o_compress_buffer(ptr, length, &dataLength, wal_compress);
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start_time);
+	o_stat_global_count(OStatWalCompressTime,
+						INSTR_TIME_GET_MICROSEC(duration));
+
+	/* Keep the numbered record positions inside the container */
+	totalLength = Max(sizeof(WALContainerCompressed) + dataLength,
+					  2 * nrecords);
+	if (totalLength >= length)
+		return NULL;
+
+	header = (WALContainerCompressed *) compressed_wal_buffer;
+	len = length;
+	memcpy(header->rawLength, &len, sizeof(len));
+	len = dataLength;
+	memcpy(header->compressedLength, &len, sizeof(len));
+	memcpy(compressed_wal_buffer + sizeof(WALContainerCompressed),
+		   data, dataLength);
+	memset(compressed_wal_buffer + sizeof(WALContainerCompressed) + dataLength,
+		   0, totalLength - sizeof(WALContainerCompressed) - dataLength);
+
+	*resultLength = totalLength;
+	return compressed_wal_buffer;
+}
+
 XLogRecPtr
-log_logical_wal_container(Pointer ptr, int length)
+log_logical_wal_container(Pointer ptr, int length, int nrecords)
 {
+	uint8		info = ORIOLEDB_XLOG_CONTAINER;
+
+	o_stat_global_count(OStatWalBytes, length);
+
+	if (OCompressIsValid(wal_compress) && length >= WAL_COMPRESS_MIN_LENGTH)
+	{
+		Pointer		compressed;
+		int			compressedLength;
+
+		compressed = wal_container_compress(ptr, length, nrecords,
+											&compressedLength);
+		if (compressed)
+		{
+			ptr = compressed;
+			length = compressedLength;
+			info |= ORIOLEDB_XLOG_COMPRESSED;
+		}
+	}
+
+	o_stat_global_count(OStatWalBytesWritten, length);
+
 	XLogBeginInsert();
 	XLogRegisterData(ptr, length);
-	return XLogInsert(ORIOLEDB_RMGR_ID, ORIOLEDB_XLOG_CONTAINER);
+	return XLogInsert(ORIOLEDB_RMGR_ID, info);
+}
+
+/*
+ * Decompresses the container data.  Returns pointer to the static buffer
+ * valid till the next call, and sets `length` to the raw container length.
+ */
+Pointer
+wal_container_decompress(Pointer data, int *length)
+{
+	WALContainerCompressed *header = (WALContainerCompressed *) data;
+	uint16		rawLength,
+				compressedLength;
+	instr_time	start_time,
+				duration;
+
+	memcpy(&rawLength, header->rawLength, sizeof(rawLength));
+	memcpy(&compressedLength, header->compressedLength,
+		   sizeof(compressedLength));
+
+	if (rawLength > LOCAL_WAL_BUFFER_SIZE ||
+		sizeof(WALContainerCompressed) + compressedLength > *length)
+		elog(ERROR, "invalid compressed orioledb WAL container");
+
+	INSTR_TIME_SET_CURRENT(start_time);
+	o_decompress_buffer(data + sizeof(WALContainerCompressed),
+						compressedLength,
+						decompressed_wal_buffer, rawLength);
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start_time);
+	o_stat_global_count(OStatWalDecompressTime,
+						INSTR_TIME_GET_MICROSEC(duration));
+
+	*length = rawLength;
+	return decompressed_wal_buffer;
 }
 
 /*
@@ -453,6 +573,30 @@ o_wal_update(BTreeDescr *desc, OTuple tuple)
 		pfree(wal_record.data);
 }
 
+/*
+ * Makes WAL update record containing only the attributes changed relative to
+ * the old tuple.  Falls back to the regular update record if the delta isn't
+ * shorter than the whole tuple.
+ */
+void
+o_wal_update_delta(BTreeDescr *desc, OTuple tuple, OTuple oldTuple)
+{
+	OTuple		wal_record;
+	bool		call_pfree;
+	int			size;
+
+	wal_record = recovery_rec_update_delta(desc, tuple, oldTuple,
+										   &call_pfree, &size);
+	if (O_TUPLE_IS_NULL(wal_record))
+	{
+		o_wal_update(desc, tuple);
+		return;
+	}
+	add_modify_wal_record(WAL_REC_UPDATE_DELTA, desc, wal_record, size);
+	if (call_pfree)
+		pfree(wal_record.data);
+}
+
 /*
  * Makes WAL delete record.
  */
@@ -501,6 +645,7 @@ add_truncate_wal_record(ORelOids oids)
 	memcpy(rec->relnode, &oids.relnode, sizeof(Oid));
 
 	local_wal_buffer_offset += sizeof(*rec);
+	local_wal_buffer_nrecords++;
 
 	local_type = oIndexInvalid;
 	local_oids.datoid = InvalidOid;
@@ -14,6 +14,7 @@
 
 #include "orioledb.h"
 
+#include "btree/iterator.h"
 #include "btree/modify.h"
 #include "catalog/indices.h"
 #include "catalog/o_sys_cache.h"
@@ -27,6 +28,7 @@
 #include "tuple/slot.h"
 
 #include "miscadmin.h"
+#include "portability/instr_time.h"
 #include "postmaster/bgworker.h"
 #include "storage/ipc.h"
 #include "storage/latch.h"
@@ -43,9 +45,25 @@
 #define QUEUE_READ_USLEEP_MULTIPLER	(2)
 #define QUEUE_READ_USLEEP_MAX		(1024 * QUEUE_READ_USLEEP_BASE)
 
+/* Every modify message takes at least two MAXALIGN'ed parts */
+#define RECOVERY_BATCH_MAX_ITEMS	(RECOVERY_QUEUE_BUF_SIZE / (2 * MAXIMUM_ALIGNOF))
+
+/*
+ * Modify message waiting in the batch.  `order` keeps the original order of
+ * the modifications of the same key.
+ */
+typedef struct
+{
+	OTuple		tuple;
+	uint16		type;
+	int			order;
+} RecoveryModifyItem;
+
 static bool detached = false;
 static CommitSeqNo my_ptr;
 static bool recovery_initialized = false;
+static RecoveryModifyItem batch_items[RECOVERY_BATCH_MAX_ITEMS];
+static int	batch_items_count = 0;
 
 static void recovery_queue_process(shm_mq_handle *queue, int id);
 static inline Pointer recovery_queue_read(shm_mq_handle *queue, Size *data_size, int id);
@@ -57,6 +75,9 @@ static void apply_tbl_delete(OTableDescr *descr, OTuple key,
 							 OXid oxid, CommitSeqNo csn);
 static void apply_tbl_update(OTableDescr *descr, OTuple tuple,
 							 OXid oxid, CommitSeqNo csn);
+static bool table_has_unique_secondary(OTableDescr *descr);
+static void apply_modify_batch(OTableDescr *descr, OIndexDescr *indexDescr,
+							   int id);
 
 typedef struct
 {
@@ -200,6 +221,9 @@ recovery_worker_main(Datum main_arg)
 		pqsignal(SIGTERM, handle_sigterm);
 		BackgroundWorkerUnblockSignals();
 
+		/* Modifications are applied sorted by key, see apply_modify_batch() */
+		o_btree_use_last_leaf_hint = recovery_batch_apply_guc;
+
 		shm_mq_set_receiver(GET_WORKER_QUEUE(id), MyProc);
 		recovery_worker_queue = shm_mq_attach(GET_WORKER_QUEUE(id), NULL, NULL);
 
@@ -273,19 +297,34 @@ recovery_queue_process(shm_mq_handle *queue, int id)
 	Size		data_size,
 				data_pos;
 	bool		finished = false;
+	bool		batchable = false;
 	OXid		oxid;
 
 	while (!finished)
 	{
+		instr_time	start_time,
+					duration;
+		uint64		applied = 0;
+
 		data = recovery_queue_read(queue, &data_size, id);
 		if (detached)
 			break;
 
+		INSTR_TIME_SET_CURRENT(start_time);
 		Assert(data != NULL);
 		data_pos = 0;
 		while (data_pos < data_size)
 		{
 			recovery_header = (RecoveryMsgHeader *) (data + data_pos);
+
+			/*
+			 * Batch contains the modifications of the same relation and
+			 * transaction, which go in a row.  Apply it before anything else.
+			 */
+			if (!(recovery_header->type & RECOVERY_MODIFY) ||
+				(recovery_header->type & (RECOVERY_MODIFY_OXID | RECOVERY_MODIFY_OIDS)))
+				apply_modify_batch(descr, indexDescr, id);
+
 			if (recovery_header->type & RECOVERY_MODIFY)
 			{
 				OTuple		tuple;
@@ -322,6 +361,9 @@ recovery_queue_process(shm_mq_handle *queue, int id)
 														 false,
 														 NULL);
 					}
+					batchable = recovery_batch_apply_guc &&
+						indexDescr != NULL &&
+						!(descr && table_has_unique_secondary(descr));
 				}
 
 				memcpy(&tuple_len, data + data_pos, sizeof(int));
@@ -334,9 +376,25 @@ recovery_queue_process(shm_mq_handle *queue, int id)
 					Assert(ORelOidsIsValid(oids));
 
 					tuple.data = data + data_pos;
-					apply_modify_record(descr, indexDescr,
-										(recovery_header->type & RECOVERY_MODIFY),
-										tuple);
+					if (batchable)
+					{
+						RecoveryModifyItem *item;
+
+						if (batch_items_count >= RECOVERY_BATCH_MAX_ITEMS)
+							apply_modify_batch(descr, indexDescr, id);
+						item = &batch_items[batch_items_count];
+						item->tuple = tuple;
+						item->type = recovery_header->type & RECOVERY_MODIFY;
+						item->order = batch_items_count;
+						batch_items_count++;
+					}
+					else
+					{
+						apply_modify_record(descr, indexDescr,
+											(recovery_header->type & RECOVERY_MODIFY),
+											tuple);
+					}
+					applied++;
 				}
 				data_pos += tuple_len;
 			}
@@ -483,12 +541,126 @@ recovery_queue_process(shm_mq_handle *queue, int id)
 			}
 			data_pos = MAXALIGN(data_pos);
 		}
+		/* Batch points to the message data, apply before the next read */
+		apply_modify_batch(descr, indexDescr, id);
+
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, start_time);
+		pg_atomic_fetch_add_u64(&worker_ptrs[id].applyTimeUs,
+								INSTR_TIME_GET_MICROSEC(duration));
+		if (applied > 0)
+			pg_atomic_fetch_add_u64(&worker_ptrs[id].appliedModifies, applied);
+
 		update_recovery_undo_loc_flush(false, id);
 	}
 	if (descr)
 		table_descr_dec_refcnt(descr);
 }
 
+/*
+ * Do the table secondary indices require the modifications to be applied in
+ * the original order?  Unique secondary index key doesn't include the primary
+ * key.  So, the modifications of different rows might touch the same entry of
+ * unique secondary index.
+ */
+static bool
+table_has_unique_secondary(OTableDescr *descr)
+{
+	int			i;
+
+	for (i = 0; i < descr->nIndices; i++)
+	{
+		if (i != PrimaryIndexNumber && descr->indices[i]->unique)
+			return true;
+	}
+	return false;
+}
+
+/* Delete and delta update records start with the key */
+#define RECOVERY_ITEM_KEY_TYPE(type) \
+	(((type) & (RECOVERY_DELETE | RECOVERY_UPDATE_DELTA)) ? \
+	 BTreeKeyNonLeafKey : BTreeKeyLeafTuple)
+
+static int
+recovery_modify_item_cmp(const void *a, const void *b, void *arg)
+{
+	RecoveryModifyItem *item1 = (RecoveryModifyItem *) a;
+	RecoveryModifyItem *item2 = (RecoveryModifyItem *) b;
+	BTreeDescr *desc = (BTreeDescr *) arg;
+	int			cmp;
+
+	cmp = o_btree_cmp(desc,
+					  &item1->tuple, RECOVERY_ITEM_KEY_TYPE(item1->type),
+					  &item2->tuple, RECOVERY_ITEM_KEY_TYPE(item2->type));
+	if (cmp != 0)
+		return cmp;
+
+	if (item1->order < item2->order)
+		return -1;
+	else if (item1->order > item2->order)
+		return 1;
+	return 0;
+}
+
+/*
+ * Applies the batch of modifications sorted by key.  The modifications of
+ * different keys within a transaction are independent.  Applied in the key
+ * order, they mostly go to the leaf modified just before, and the descent
+ * from the root is skipped (see o_btree_use_last_leaf_hint).  The
+ * modifications of the same key keep their order.
+ */
+static void
+apply_modify_batch(OTableDescr *descr, OIndexDescr *indexDescr, int id)
+{
+	int			i;
+
+	if (batch_items_count == 0)
+		return;
+
+	if (batch_items_count > 1)
+	{
+		qsort_arg(batch_items, batch_items_count, sizeof(RecoveryModifyItem),
+				  recovery_modify_item_cmp, &indexDescr->desc);
+		pg_atomic_fetch_add_u64(&worker_ptrs[id].sortedBatches, 1);
+		pg_atomic_fetch_add_u64(&worker_ptrs[id].sortedModifies,
+								batch_items_count);
+	}
+
+	for (i = 0; i < batch_items_count; i++)
+		apply_modify_record(descr, indexDescr, batch_items[i].type,
+							batch_items[i].tuple);
+	batch_items_count = 0;
+}
+
+/*
+ * Forms the whole tuple from the delta update record and the current version
+ * of the row.  Returns null tuple if the row doesn't exist: it might be
+ * deleted in the tree image newer than the record.  The row deletion is
+ * replayed afterwards anyway.
+ */
+static OTuple
+recovery_delta_get_tuple(OIndexDescr *id, OTuple rec)
+{
+	OTuple		base,
+				result;
+	int			key_len;
+
+	o_btree_load_shmem(&id->desc);
+	base = o_btree_find_tuple_by_key(&id->desc, (Pointer) &rec,
+									 BTreeKeyNonLeafKey,
+									 &o_in_progress_snapshot, NULL,
+									 CurrentMemoryContext, NULL);
+	if (O_TUPLE_IS_NULL(base))
+		return base;
+
+	key_len = o_btree_len(&id->desc, rec, OKeyLength);
+	result = o_tuple_apply_delta(id->leafTupdesc, &id->leafSpec, base,
+								 rec.data + key_len);
+	pfree(base.data);
+
+	return result;
+}
+
 /*
  * Apply the modify WAL record.
  */
@@ -497,6 +669,16 @@ apply_modify_record(OTableDescr *descr, OIndexDescr *id, uint16 type,
 					OTuple p)
 {
 	OXid		oxid;
+	bool		delta = false;
+
+	if (type == RECOVERY_UPDATE_DELTA)
+	{
+		p = recovery_delta_get_tuple(id, p);
+		if (O_TUPLE_IS_NULL(p))
+			return;
+		type = RECOVERY_UPDATE;
+		delta = true;
+	}
 
 	oxid = get_current_oxid();
 
@@ -515,6 +697,9 @@ apply_modify_record(OTableDescr *descr, OIndexDescr *id, uint16 type,
 		o_btree_load_shmem(&id->desc);
 		apply_btree_modify_record(&id->desc, type, p, oxid, COMMITSEQNO_INPROGRESS);
 	}
+
+	if (delta)
+		pfree(p.data);
 }
 
 /*
@@ -21,6 +21,7 @@
 #include "s3/headers.h"
 #include "s3/requests.h"
 #include "s3/worker.h"
+#include "utils/o_stat.h"
 
 #include "utils/wait_event.h"
 
@@ -221,6 +222,18 @@ static int64 s3_backup_scan_dir(S3BackupState *state,
 								const char *spcoid);
 static List *get_tablespaces(StringInfo tblspcmapfile);
 
+/*
+ * Returns the growth of the global counter since the start value.  Counters
+ * might be reset concurrently, then it's just an estimate.
+ */
+static uint64
+stat_delta(OStatCounter counter, uint64 start)
+{
+	uint64		cur = o_stat_global_read(counter);
+
+	return cur >= start ? cur - start : cur;
+}
+
 /*
  * Actually do a base backup for the specified tablespaces.
  *
@@ -237,6 +250,9 @@ s3_perform_backup(int flags, S3TaskLocation maxLocation)
 	tablespaceinfo *newti;
 	S3FileChecksum *fileChecksums;
 	S3TaskLocation location;
+	uint64		filesHashed = o_stat_global_read(OStatS3FilesHashed),
+				bytesHashed = o_stat_global_read(OStatS3BytesHashed),
+				filesSkipped = o_stat_global_read(OStatS3FilesSkipped);
 
 	backup_started_in_recovery = RecoveryInProgress();
 
@@ -315,6 +331,13 @@ s3_perform_backup(int flags, S3TaskLocation maxLocation)
 	maxLocation = Max(maxLocation, location);
 
 	s3_queue_wait_for_location(maxLocation);
+
+	filesHashed = stat_delta(OStatS3FilesHashed, filesHashed);
+	bytesHashed = stat_delta(OStatS3BytesHashed, bytesHashed);
+	filesSkipped = stat_delta(OStatS3FilesSkipped, filesSkipped);
+	elog(LOG, "orioledb s3 checkpoint %u: %llu files hashed (%llu bytes), %llu unchanged files skipped",
+		 chkpNum, (unsigned long long) filesHashed,
+		 (unsigned long long) bytesHashed, (unsigned long long) filesSkipped);
 }
 
 static int64
@@ -861,19 +884,25 @@ accumulate_small_file(S3BackupState *state, const char *path, int size)
 	S3TaskLocation location = 0;
 	Pointer		data;
 	uint64		dataSize;
+	S3FileStat	fileStat;
+
+	if (state->checksumState->fileChecksumsLen == state->checksumState->fileChecksumsMaxLen)
+		flushS3ChecksumState(state->checksumState,
+							 SMALL_FILE_CHECKSUMS_TMP_FILENAME);
 
-	/* First check if the file changed */
+	/* Skip reading the file if its attributes didn't change */
+	if (getS3FileChecksumUnchanged(state->checksumState, path, &fileStat))
+		return 0;
+
+	/* Otherwise check if the file contents changed */
 	data = read_file(path, &dataSize);
 
 	if (data != NULL)
 	{
 		S3FileChecksum *entry;
 
-		if (state->checksumState->fileChecksumsLen == state->checksumState->fileChecksumsMaxLen)
-			flushS3ChecksumState(state->checksumState,
-								 SMALL_FILE_CHECKSUMS_TMP_FILENAME);
-
-		entry = getS3FileChecksum(state->checksumState, path, data, dataSize);
+		entry = getS3FileChecksum(state->checksumState, path, data, dataSize,
+								  &fileStat);
 
 		/*
 		 * If the file didn't change just exit the function and return 0.  We
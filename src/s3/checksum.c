@@ -16,6 +16,10 @@
 #include "orioledb.h"
 
 #include "s3/checksum.h"
+#include "utils/o_stat.h"
+
+#include <sys/stat.h>
+#include <time.h>
 
 #include "common/string.h"
 #include "storage/fd.h"
@@ -101,9 +105,16 @@ initHashTable(S3ChecksumState *state, const char *filename)
 	while (pg_get_line_buf(file, &buf))
 	{
 		S3FileChecksum fileEntry;
-
-		if (sscanf(buf.data, "FILE: %1023[^,], CHECKSUM: %64[^,], CHECKPOINT: %d",
-				   fileEntry.filename, fileEntry.checksum, &fileEntry.checkpointNumber) == 3)
+		unsigned long long size = 0,
+					inode = 0;
+		long long	mtime = 0;
+		int			nfields;
+
+		/* File attributes are optional */
+		nfields = sscanf(buf.data, "FILE: %1023[^,], CHECKSUM: %64[^,], CHECKPOINT: %u, SIZE: %llu, MTIME: %lld, INODE: %llu",
+						 fileEntry.filename, fileEntry.checksum, &fileEntry.checkpointNumber,
+						 &size, &mtime, &inode);
+		if (nfields == 3 || nfields == 6)
 		{
 			char		key[MAXPGPATH];
 			S3FileChecksum *newEntry;
@@ -132,6 +143,9 @@ initHashTable(S3ChecksumState *state, const char *filename)
 			strlcpy(newEntry->checksum, fileEntry.checksum, sizeof(fileEntry.checksum));
 			newEntry->checkpointNumber = fileEntry.checkpointNumber;
 			newEntry->changed = false;
+			newEntry->stat.size = size;
+			newEntry->stat.mtime = mtime;
+			newEntry->stat.inode = inode;
 		}
 		else
 			ereport(ERROR,
@@ -172,9 +186,13 @@ flushS3ChecksumState(S3ChecksumState *state, const char *filename)
 
 	for (int i = 0; i < state->fileChecksumsLen; i++)
 	{
-		if (fprintf(file, "FILE: %s, CHECKSUM: %s, CHECKPOINT: %u\n",
-					state->fileChecksums[i].filename, state->fileChecksums[i].checksum,
-					state->fileChecksums[i].checkpointNumber) < 0)
+		S3FileChecksum *entry = &state->fileChecksums[i];
+
+		if (fprintf(file, "FILE: %s, CHECKSUM: %s, CHECKPOINT: %u, SIZE: %llu, MTIME: %lld, INODE: %llu\n",
+					entry->filename, entry->checksum, entry->checkpointNumber,
+					(unsigned long long) entry->stat.size,
+					(long long) entry->stat.mtime,
+					(unsigned long long) entry->stat.inode) < 0)
 			ereport(ERROR,
 					(errcode_for_file_access(),
 					 errmsg("could not write file \"%s\": %m",
@@ -190,35 +208,108 @@ flushS3ChecksumState(S3ChecksumState *state, const char *filename)
 	state->fileChecksumsLen = 0;
 }
 
+/*
+ * Find the entry of the previous checkpoint.
+ */
+static S3FileChecksum *
+getPrevEntry(S3ChecksumState *state, const char *filename)
+{
+	char		key[MAXPGPATH];
+
+	/*
+	 * hashTable might not have been initialized before if a checksum file
+	 * hasn't been found.
+	 */
+	if (state->hashTable == NULL)
+		return NULL;
+
+	MemSet(key, 0, sizeof(key));
+	strlcpy(key, filename, MAXPGPATH);
+
+	return (S3FileChecksum *) hash_search(state->hashTable, key,
+										  HASH_FIND, NULL);
+}
+
+static void
+storeEntry(S3ChecksumState *state, S3FileChecksum *entry)
+{
+	if (state->fileChecksumsLen >= state->fileChecksumsMaxLen)
+		elog(ERROR, "size of S3FileChecksum buffer is smaller than requested, "
+			 "current size is %d", state->fileChecksumsMaxLen);
+
+	memcpy(state->fileChecksums + state->fileChecksumsLen, entry, sizeof(S3FileChecksum));
+	state->fileChecksumsLen += 1;
+}
+
+/*
+ * Check if a PostgreSQL file is unchanged since last checkpoint judging by
+ * its size, modification time and inode.  If so, store and return the entry
+ * of the previous checkpoint without reading the file.  Otherwise, return
+ * NULL and fill *fileStat for getS3FileChecksum().
+ *
+ * The modification time has a granularity of one second.  So, attributes of
+ * files modified within the last two seconds aren't trusted: they might be
+ * modified once again without changing the attributes.
+ */
+S3FileChecksum *
+getS3FileChecksumUnchanged(S3ChecksumState *state, const char *filename,
+						   S3FileStat *fileStat)
+{
+	S3FileChecksum *prevEntry;
+	S3FileChecksum *newEntry;
+	struct stat st;
+	time_t		now = time(NULL);
+
+	MemSet(fileStat, 0, sizeof(*fileStat));
+	if (stat(filename, &st) != 0)
+		return NULL;
+
+	fileStat->size = st.st_size;
+	fileStat->inode = st.st_ino;
+	if (st.st_mtime < now - 1)
+		fileStat->mtime = st.st_mtime;
+
+	prevEntry = getPrevEntry(state, filename);
+	if (prevEntry == NULL || prevEntry->stat.mtime == 0 ||
+		fileStat->mtime == 0 ||
+		prevEntry->stat.mtime != fileStat->mtime ||
+		prevEntry->stat.size != fileStat->size ||
+		prevEntry->stat.inode != fileStat->inode)
+		return NULL;
+
+	newEntry = (S3FileChecksum *) palloc0(sizeof(S3FileChecksum));
+	memcpy(newEntry, prevEntry, sizeof(S3FileChecksum));
+	newEntry->changed = false;
+	storeEntry(state, newEntry);
+
+	o_stat_global_count(OStatS3FilesSkipped, 1);
+
+	return newEntry;
+}
+
 /*
  * Check if a PostgreSQL file changed since last checkpoint and return
- * S3FileChecksum.
+ * S3FileChecksum.  fileStat holds attributes of the file taken before reading
+ * its data, might be NULL if they are unknown.
  */
 S3FileChecksum *
 getS3FileChecksum(S3ChecksumState *state, const char *filename,
-				  Pointer data, uint64 size)
+				  Pointer data, uint64 size, S3FileStat *fileStat)
 {
-	S3FileChecksum *prevEntry = NULL;
+	S3FileChecksum *prevEntry;
 	S3FileChecksum *newEntry;
 	unsigned char checksumbuf[SHA256_DIGEST_LENGTH];
 	char		checksumstringbuf[O_SHA256_DIGEST_STRING_LENGTH];
 
+	prevEntry = getPrevEntry(state, filename);
+
 	/*
-	 * hashTable might not have been initialized before if a checksum file
-	 * hasn't been found.
+	 * OpenSSL picks the hardware-accelerated implementation of SHA256 when
+	 * CPU supports it.
 	 */
-	if (state->hashTable != NULL)
-	{
-		char		key[MAXPGPATH];
-
-		MemSet(key, 0, sizeof(key));
-		strlcpy(key, filename, MAXPGPATH);
-
-		prevEntry = (S3FileChecksum *) hash_search(state->hashTable, key,
-												   HASH_FIND, NULL);
-	}
-
 	(void) SHA256((unsigned char *) data, size, checksumbuf);
+	o_stat_global_count(OStatS3FilesHashed, 1);
+	o_stat_global_count(OStatS3BytesHashed, size);
 
 	hex_encode((char *) checksumbuf, sizeof(checksumbuf), checksumstringbuf);
 	checksumstringbuf[O_SHA256_DIGEST_STRING_LENGTH - 1] = '\0';
@@ -227,6 +318,8 @@ getS3FileChecksum(S3ChecksumState *state, const char *filename,
 
 	strlcpy(newEntry->filename, filename, sizeof(newEntry->filename));
 	strlcpy(newEntry->checksum, checksumstringbuf, sizeof(newEntry->checksum));
+	if (fileStat)
+		newEntry->stat = *fileStat;
 
 	if (prevEntry == NULL ||
 		strncmp(prevEntry->checksum, newEntry->checksum, sizeof(newEntry->checksum)) != 0)
@@ -243,12 +336,7 @@ getS3FileChecksum(S3ChecksumState *state, const char *filename,
 	}
 
 	/* Store new entry into the checksum state */
-	if (state->fileChecksumsLen >= state->fileChecksumsMaxLen)
-		elog(ERROR, "size of S3FileChecksum buffer is smaller than requested, "
-			 "current size is %d", state->fileChecksumsMaxLen);
-
-	memcpy(state->fileChecksums + state->fileChecksumsLen, newEntry, sizeof(S3FileChecksum));
-	state->fileChecksumsLen += 1;
+	storeEntry(state, newEntry);
 
 	return newEntry;
 }
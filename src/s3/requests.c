@@ -19,6 +19,7 @@
 #include "orioledb.h"
 
 #include "s3/requests.h"
+#include "utils/compress.h"
 
 #include "common/base64.h"
 #include "lib/stringinfo.h"
@@ -619,6 +620,43 @@ s3_put_file(char *objectname, char *filename, bool ifNoneMatch)
 	return res;
 }
 
+/*
+ * Put the whole file as S3 object compressed with zstd of the given level.
+ * The object name gets S3_COMPRESSED_SUFFIX appended, which marks the object
+ * as compressed for the restore.
+ */
+long
+s3_put_file_compressed(char *objectname, char *filename, OCompress lvl)
+{
+	Pointer		data;
+	uint64		dataSize = 0;
+	long		res = -1;
+
+	Assert(OCompressIsValid(lvl));
+
+	data = read_file(filename, &dataSize);
+	if (data)
+	{
+		Pointer		compressed;
+		size_t		compressedSize;
+		char	   *compressedName;
+
+		compressed = o_compress_data(data, dataSize, &compressedSize, lvl);
+		pfree(data);
+
+		compressedName = psprintf("%s" S3_COMPRESSED_SUFFIX, objectname);
+		elog(DEBUG1, "S3 compressed put %s %s: " UINT64_FORMAT " -> %zu bytes",
+			 compressedName, filename, dataSize, compressedSize);
+
+		res = s3_put_object_with_contents(compressedName, compressed,
+										  compressedSize, NULL, false);
+		pfree(compressedName);
+		pfree(compressed);
+	}
+
+	return res;
+}
+
 /*
  * Get the whole file from S3 object.
  */
@@ -21,6 +21,7 @@
 #include "s3/queue.h"
 #include "s3/requests.h"
 #include "s3/worker.h"
+#include "utils/o_stat.h"
 
 #include "access/xlog_internal.h"
 #include "miscadmin.h"
@@ -276,6 +277,19 @@ flush_worker_checksum_state(void)
 	flushS3ChecksumState(checksum_state, filename);
 }
 
+/*
+ * Puts WAL or undo file to S3.  Compresses it according to
+ * orioledb.s3_archive_compress.
+ */
+static void
+s3_put_archive_file(char *objectname, char *filename)
+{
+	if (OCompressIsValid(s3_archive_compress))
+		s3_put_file_compressed(objectname, filename, s3_archive_compress);
+	else
+		s3_put_file(objectname, filename, false);
+}
+
 /*
  * Process the task at given location.
  */
@@ -377,6 +391,7 @@ s3process_task(uint64 taskLocation)
 		tag.segNum = task->typeSpecific.filePart.segNum;
 
 		s3_header_mark_part_loaded(tag, task->typeSpecific.filePart.partNum);
+		o_stat_count(tag.datoid, tag.relnode, OStatS3PartLoads, 1);
 
 		pfree(filename);
 		pfree(objectname);
@@ -456,7 +471,7 @@ s3process_task(uint64 taskLocation)
 		filename = psprintf(XLOGDIR "/%s", task->typeSpecific.walFilename);
 		objectname = psprintf("wal/%s", task->typeSpecific.walFilename);
 
-		s3_put_file(objectname, filename, false);
+		s3_put_archive_file(objectname, filename);
 
 		pfree(filename);
 		pfree(objectname);
@@ -500,7 +515,7 @@ s3process_task(uint64 taskLocation)
 			objectname = NULL;
 		}
 
-		s3_put_file(objectname, filename, false);
+		s3_put_archive_file(objectname, filename);
 
 		pfree(filename);
 		pfree(objectname);
@@ -529,6 +544,7 @@ s3process_task(uint64 taskLocation)
 		char	   *filename = task->typeSpecific.writePGFile.filename;
 		Pointer		data;
 		uint64		size;
+		S3FileStat	fileStat;
 
 		if (filename[0] == '.' && filename[1] == '/')
 			filename += 2;
@@ -539,26 +555,31 @@ s3process_task(uint64 taskLocation)
 
 		elog(DEBUG1, "S3 PG file put %s %s", objectname, filename);
 
-		data = read_file(filename, &size);
+		pg_atomic_test_set_flag(&workers_ctl->workersInProgress[worker_num]);
 
-		if (data != NULL)
-		{
-			S3FileChecksum *entry;
+		if (checksum_state == NULL)
+			checksum_state = makeS3ChecksumState(task->typeSpecific.writePGFile.chkpNum,
+												 get_worker_file_checksums(),
+												 WORKERS_FILE_CHECKSUMS_MAX_LEN,
+												 FILE_CHECKSUMS_FILENAME);
 
-			pg_atomic_test_set_flag(&workers_ctl->workersInProgress[worker_num]);
+		Assert(checksum_state->checkpointNumber == task->typeSpecific.writePGFile.chkpNum);
 
-			if (checksum_state == NULL)
-				checksum_state = makeS3ChecksumState(task->typeSpecific.writePGFile.chkpNum,
-													 get_worker_file_checksums(),
-													 WORKERS_FILE_CHECKSUMS_MAX_LEN,
-													 FILE_CHECKSUMS_FILENAME);
+		if (checksum_state->fileChecksumsLen == WORKERS_FILE_CHECKSUMS_MAX_LEN)
+			flush_worker_checksum_state();
 
-			Assert(checksum_state->checkpointNumber == task->typeSpecific.writePGFile.chkpNum);
+		/* Skip reading the file if its attributes didn't change */
+		if (getS3FileChecksumUnchanged(checksum_state, filename, &fileStat))
+			data = NULL;
+		else
+			data = read_file(filename, &size);
 
-			if (checksum_state->fileChecksumsLen == WORKERS_FILE_CHECKSUMS_MAX_LEN)
-				flush_worker_checksum_state();
+		if (data != NULL)
+		{
+			S3FileChecksum *entry;
 
-			entry = getS3FileChecksum(checksum_state, filename, data, size);
+			entry = getS3FileChecksum(checksum_state, filename, data, size,
+									  &fileStat);
 
 			if (entry->changed)
 				(void) s3_put_object_with_contents(objectname, data, size,
@@ -996,6 +1017,9 @@ s3worker_main(Datum main_arg)
 					checksum_state = NULL;
 				}
 
+				/* Make hashing statistics visible to the checkpointer */
+				o_stat_flush();
+
 				pg_atomic_clear_flag(&workers_ctl->workersInProgress[worker_num]);
 				ConditionVariableBroadcast(&workers_ctl->fileChecksumsFlushedCV);
 			}
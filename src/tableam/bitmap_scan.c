@@ -26,7 +26,10 @@
 #include "executor/nodeIndexscan.h"
 #include "lib/rbtree.h"
 #include "nodes/execnodes.h"
+#include "storage/condition_variable.h"
+#include "storage/spin.h"
 #include "utils/memutils.h"
+#include "utils/wait_event.h"
 
 #include <math.h>
 
@@ -41,6 +44,27 @@ typedef struct OBitmapScan
 	BTreeSeqScan *seq_scan;
 } OBitmapScan;
 
+typedef enum
+{
+	OParallelBitmapInitial,
+	OParallelBitmapInProgress,
+	OParallelBitmapFinished
+} OParallelBitmapState;
+
+/*
+ * Shared state of parallel bitmap scan.  The first participant builds the
+ * key bitmap and publishes it in DSA.  Then all the participants scan the
+ * primary index in parallel skipping the key ranges missing in the bitmap.
+ */
+struct OParallelBitmapScanData
+{
+	slock_t		mutex;
+	OParallelBitmapState state;
+	ConditionVariable cv;
+	dsa_pointer bitmap;
+	ParallelOScanDescData poscan;
+};
+
 static bool o_bitmap_is_range_valid(OTuple low, OTuple high, void *arg);
 static bool o_bitmap_get_next_key(OFixedKey *key, bool inclusive, void *arg);
 
@@ -380,6 +404,60 @@ o_exec_bitmapqual(OBitmapHeapPlanState *bitmap_state, PlanState *planstate)
 	return result;
 }
 
+/*
+ * Returns the key bitmap of parallel scan.  The first participant builds it,
+ * others wait for the bitmap and take a copy.
+ */
+static RBTree *
+o_parallel_bitmap_get(OBitmapHeapPlanState *bitmap_state,
+					  PlanState *bitmapqualplanstate)
+{
+	OParallelBitmapScan *pstate = bitmap_state->pstate;
+	dsa_area   *dsa = bitmap_state->scan->ss->ps.state->es_query_dsa;
+	RBTree	   *bitmap;
+	bool		build = false;
+
+	Assert(dsa != NULL);
+
+	SpinLockAcquire(&pstate->mutex);
+	if (pstate->state == OParallelBitmapInitial)
+	{
+		pstate->state = OParallelBitmapInProgress;
+		build = true;
+	}
+	SpinLockRelease(&pstate->mutex);
+
+	if (build)
+	{
+		bitmap = o_exec_bitmapqual(bitmap_state, bitmapqualplanstate);
+		pstate->bitmap = dsa_allocate(dsa, o_keybitmap_serialized_size(bitmap));
+		o_keybitmap_serialize(bitmap, dsa_get_address(dsa, pstate->bitmap));
+
+		SpinLockAcquire(&pstate->mutex);
+		pstate->state = OParallelBitmapFinished;
+		SpinLockRelease(&pstate->mutex);
+		ConditionVariableBroadcast(&pstate->cv);
+		return bitmap;
+	}
+
+	ConditionVariablePrepareToSleep(&pstate->cv);
+	while (true)
+	{
+		bool		finished;
+
+		SpinLockAcquire(&pstate->mutex);
+		finished = (pstate->state == OParallelBitmapFinished);
+		SpinLockRelease(&pstate->mutex);
+
+		if (finished)
+			break;
+		ConditionVariableSleep(&pstate->cv, WAIT_EVENT_PARALLEL_BITMAP_SCAN);
+	}
+	ConditionVariableCancelSleep();
+
+	return o_keybitmap_deserialize(dsa_get_address(dsa, pstate->bitmap));
+}
+
 OBitmapScan *
 o_make_bitmap_scan(OBitmapHeapPlanState *bitmap_state, ScanState *ss,
 				   PlanState *bitmapqualplanstate, Relation rel,
@@ -387,6 +465,7 @@ o_make_bitmap_scan(OBitmapHeapPlanState *bitmap_state, ScanState *ss,
 				   MemoryContext cxt)
 {
 	OBitmapScan *scan = palloc0(sizeof(OBitmapScan));
+	ParallelOScanDesc poscan = NULL;
 
 	scan->typeoid = typeoid;
 	scan->oSnapshot = *oSnapshot;
@@ -394,10 +473,21 @@ o_make_bitmap_scan(OBitmapHeapPlanState *bitmap_state, ScanState *ss,
 	scan->ss = ss;
 	scan->tbl_desc = relation_get_descr(rel);
 	bitmap_state->scan = scan;
-	scan->saved_bitmap = o_exec_bitmapqual(bitmap_state, bitmapqualplanstate);
+	if (bitmap_state->pstate)
+	{
+		scan->saved_bitmap = o_parallel_bitmap_get(bitmap_state,
+												   bitmapqualplanstate);
+		poscan = &bitmap_state->pstate->poscan;
+	}
+	else
+	{
+		scan->saved_bitmap = o_exec_bitmapqual(bitmap_state,
+											   bitmapqualplanstate);
+	}
 	scan->seq_scan = make_btree_seq_scan_cb(&GET_PRIMARY(scan->tbl_desc)->desc,
 											&scan->oSnapshot,
-											&bitmap_seq_scan_callbacks, scan);
+											&bitmap_seq_scan_callbacks, scan,
+											poscan);
 	return scan;
 }
 
@@ -470,6 +560,51 @@ o_free_bitmap_scan(OBitmapScan *scan)
 	pfree(scan);
 }
 
+Size
+o_bitmap_scan_estimate_dsm(void)
+{
+	return sizeof(OParallelBitmapScan);
+}
+
+void
+o_bitmap_scan_initialize_dsm(OBitmapHeapPlanState *bitmap_state,
+							 void *coordinate)
+{
+	OParallelBitmapScan *pstate = (OParallelBitmapScan *) coordinate;
+
+	SpinLockInit(&pstate->mutex);
+	pstate->state = OParallelBitmapInitial;
+	ConditionVariableInit(&pstate->cv);
+	pstate->bitmap = InvalidDsaPointer;
+	orioledb_parallelscan_initialize_inner((ParallelTableScanDesc) &pstate->poscan);
+	bitmap_state->pstate = pstate;
+}
+
+void
+o_bitmap_scan_reinitialize_dsm(OBitmapHeapPlanState *bitmap_state,
+							   Relation rel, dsa_area *dsa)
+{
+	OParallelBitmapScan *pstate = bitmap_state->pstate;
+
+	/* If there's no DSA, there are no workers; nothing to do */
+	if (dsa == NULL)
+		return;
+
+	if (DsaPointerIsValid(pstate->bitmap))
+		dsa_free(dsa, pstate->bitmap);
+	pstate->bitmap = InvalidDsaPointer;
+	pstate->state = OParallelBitmapInitial;
+	orioledb_parallelscan_reinitialize(rel,
+									   (ParallelTableScanDesc) &pstate->poscan);
+}
+
+void
+o_bitmap_scan_initialize_worker(OBitmapHeapPlanState *bitmap_state,
+								void *coordinate)
+{
+	bitmap_state->pstate = (OParallelBitmapScan *) coordinate;
+}
+
 static bool
 o_bitmap_is_range_valid(OTuple low, OTuple high, void *arg)
 {
@@ -19,6 +19,7 @@
 #include "btree/modify.h"
 #include "checkpoint/checkpoint.h"
 #include "catalog/free_extents.h"
+#include "catalog/o_descr_cache.h"
 #include "catalog/o_indices.h"
 #include "catalog/o_sys_cache.h"
 #include "catalog/o_tables.h"
@@ -28,6 +29,7 @@
 #include "tableam/tree.h"
 #include "tuple/slot.h"
 #include "transam/undo.h"
+#include "utils/o_stat.h"
 #include "utils/page_pool.h"
 #include "utils/stopevent.h"
 
@@ -499,6 +501,11 @@ index_descr_free(OIndexDescr *tree)
 		ExecDropSingleTupleTableSlot(tree->new_leaf_slot);
 	if (tree->index_slot)
 		ExecDropSingleTupleTableSlot(tree->index_slot);
+	if (tree->leafDeform)
+	{
+		pfree(tree->leafDeform);
+		tree->leafDeform = NULL;
+	}
 	if (tree->leafTupdesc)
 		FreeTupleDesc(tree->leafTupdesc);
 	if (tree->nonLeafTupdesc)
@@ -599,6 +606,23 @@ o_free_tmp_table_descr(OTableDescr *descr)
 }
 
 
+/*
+ * Returns the deforming program for leaf tuples of the index.  The program is
+ * built on the first use and lives as long as the index descriptor.
+ */
+OTupleDeformProgram *
+o_index_get_leaf_deform(OIndexDescr *descr)
+{
+	if (!descr->leafDeform)
+	{
+		MemoryContext mcxt = MemoryContextSwitchTo(descrCxt);
+
+		descr->leafDeform = o_tuple_deform_program_build(descr->leafTupdesc);
+		MemoryContextSwitchTo(mcxt);
+	}
+	return descr->leafDeform;
+}
+
 static void
 table_descr_delete_from_hash(OTableDescr *descr)
 {
@@ -695,7 +719,7 @@ create_table_descr(ORelOids oids)
 	old_enable_stopevents = enable_stopevents;
 	enable_stopevents = false;
 
-	o_table = o_tables_get(oids);
+	o_table = o_tables_get_cached(oids);
 
 	if (o_table == NULL)
 	{
@@ -818,6 +842,7 @@ o_invalidate_descrs(Oid datoid, Oid reloid, Oid relfilenode)
 	if (!OidIsValid(datoid) || !OidIsValid(reloid) || !OidIsValid(relfilenode))
 	{
 		Assert(!OidIsValid(datoid) && !OidIsValid(reloid) && !OidIsValid(relfilenode));
+		o_descr_cache_invalidate_all();
 		hash_seq_init(&scan_status, oTableDescrHash);
 		while ((tableDescr = (OTableDescr *) hash_seq_search(&scan_status)) != NULL)
 		{
@@ -844,6 +869,7 @@ o_invalidate_descrs(Oid datoid, Oid reloid, Oid relfilenode)
 		ORelOids	oids = {datoid, reloid, relfilenode};
 		bool		found;
 
+		o_descr_cache_invalidate(oids);
 		tableDescr = hash_search(oTableDescrHash, &oids, HASH_FIND, &found);
 		if (found)
 		{
@@ -930,6 +956,7 @@ cleanup_btree(Oid datoid, Oid relnode, bool files)
 								  shared->rootInfo.rootPageChangeCount);
 		pfree(shared);
 	}
+	o_stat_drop_tree(datoid, relnode);
 	if (files)
 		cleanup_btree_files(key.datoid, key.relnode);
 }
@@ -961,7 +988,7 @@ get_index_descr(ORelOids ixOids, OIndexType ixType, bool miss_ok)
 	if (found)
 		return result;
 
-	oIndex = o_indices_get(ixOids, ixType);
+	oIndex = o_indices_get_cached(ixOids, ixType);
 	Assert(oIndex || miss_ok);
 	if (!oIndex && miss_ok)
 	{
@@ -986,7 +1013,7 @@ recreate_index_descr(OIndexDescr *descr)
 	int			refcnt;
 	MemoryContext mcxt;
 
-	oIndex = o_indices_get(descr->oids, descr->desc.type);
+	oIndex = o_indices_get_cached(descr->oids, descr->desc.type);
 	if (!oIndex)
 	{
 		descr->valid = false;
@@ -1478,7 +1505,7 @@ recreate_table_descr(OTableDescr *descr)
 	old_enable_stopevents = enable_stopevents;
 	enable_stopevents = false;
 
-	o_table = o_tables_get(descr->oids);
+	o_table = o_tables_get_cached(descr->oids);
 	if (!o_table)
 		return false;
 
@@ -58,7 +58,7 @@ extern void log_btree(BTreeDescr *desc);
 
 static void
 o_tuple_print(TupleDesc tupDesc, OTupleFixedFormatSpec *spec,
-			  FmgrInfo *outputFns, StringInfo buf, OTuple tup,
+			  FmgrInfo *outputFns, StringInfo buf, OTuple tup, int natts,
 			  Datum *values, bool *nulls, bool printVersion)
 {
 	Form_pg_attribute atti;
@@ -70,7 +70,7 @@ o_tuple_print(TupleDesc tupDesc, OTupleFixedFormatSpec *spec,
 	if (printVersion)
 		appendStringInfo(buf, "(%u) ", o_tuple_get_version(tup));
 
-	for (i = 0; i < tupDesc->natts; i++)
+	for (i = 0; i < natts; i++)
 	{
 		if (i > 0)
 			appendStringInfo(buf, ", ");
@@ -107,7 +107,8 @@ idx_key_print(BTreeDescr *desc, StringInfo buf, OTuple tup, Pointer arg)
 	TuplePrintOpaque *opaque = (TuplePrintOpaque *) arg;
 
 	o_tuple_print(opaque->keyDesc, opaque->keySpec, opaque->keyOutputFns, buf,
-				  tup, opaque->values, opaque->nulls, false);
+				  tup, o_key_natts(tup, opaque->keyDesc),
+				  opaque->values, opaque->nulls, false);
 }
 
 static void
@@ -116,7 +117,8 @@ idx_tup_print(BTreeDescr *desc, StringInfo buf, OTuple tup, Pointer arg)
 	TuplePrintOpaque *opaque = (TuplePrintOpaque *) arg;
 
 	o_tuple_print(opaque->desc, opaque->spec, opaque->outputFns, buf,
-				  tup, opaque->values, opaque->nulls, opaque->printRowVersion);
+				  tup, opaque->desc->natts,
+				  opaque->values, opaque->nulls, opaque->printRowVersion);
 }
 
 void
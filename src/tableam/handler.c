@@ -921,7 +921,7 @@ orioledb_index_validate_scan(Relation heapRelation,
 							 Snapshot snapshot,
 							 ValidateIndexState *state)
 {
-	elog(ERROR, "Not implemented: %s", PG_FUNCNAME_MACRO);
+	o_validate_index_concurrently(heapRelation, indexRelation, state);
 }
 
 
@@ -1768,6 +1768,11 @@ orioledb_default_reloptions(Datum reloptions, bool validate, relopt_kind kind)
 								   NULL, validate_toast_compress, NULL,
 								   offsetof(ORelOptions,
 											toast_compress_offset));
+		add_local_bool_reloption(&relopts, "wal_update_delta",
+								 "Writes only changed attributes of updated "
+								 "rows to WAL",
+								 false,
+								 offsetof(ORelOptions, wal_update_delta));
 		MemoryContextSwitchTo(oldcxt);
 		relopts_set = true;
 	}
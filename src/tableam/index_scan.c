@@ -16,6 +16,7 @@
 
 #include "btree/io.h"
 #include "btree/iterator.h"
+#include "btree/scan.h"
 #include "tableam/bitmap_scan.h"
 #include "tableam/index_scan.h"
 #include "tableam/descr.h"
@@ -25,8 +26,12 @@
 
 #include "access/nbtree.h"
 #include "access/skey.h"
+#include "catalog/pg_type.h"
+#include "executor/executor.h"
 #include "executor/nodeIndexscan.h"
+#include "nodes/nodeFuncs.h"
 #include "parser/parse_coerce.h"
+#include "utils/lsyscache.h"
 
 void
 init_index_scan_state(OPlanState *o_plan_state, OScanState *ostate, Relation index,
@@ -259,6 +264,159 @@ o_bt_advance_array_keys_increment(OScanState *ostate, ScanDirection dir)
 }
 #endif
 
+void
+o_parallel_index_scan_init(OParallelIndexScan pscan)
+{
+	SpinLockInit(&pscan->mutex);
+	pscan->status = OParallelIndexScanNotStarted;
+	pscan->version = 0;
+	clear_fixed_shmem_key(&pscan->nextKey);
+}
+
+static OParallelIndexScan
+get_parallel_index_scan(OScanState *ostate)
+{
+	ParallelIndexScanDesc parallel_scan = ostate->scandesc.parallel_scan;
+
+	Assert(parallel_scan != NULL);
+	return (OParallelIndexScan) OffsetToPointer(parallel_scan,
+												parallel_scan->ps_offset);
+}
+
+/*
+ * Claims the whole parallel scan for the current participant.  Used when the
+ * key range can't be split into chunks: for backward scans, scans with array
+ * keys and exact key lookups.
+ */
+static bool
+o_parallel_index_claim_all(OScanState *ostate)
+{
+	OParallelIndexScan pscan = get_parallel_index_scan(ostate);
+	bool		result = false;
+
+	SpinLockAcquire(&pscan->mutex);
+	if (pscan->status == OParallelIndexScanNotStarted)
+	{
+		pscan->status = OParallelIndexScanFinished;
+		pscan->version++;
+		result = true;
+	}
+	SpinLockRelease(&pscan->mutex);
+
+	return result;
+}
+
+/*
+ * Marks the parallel scan finished, once the participant reached the end of
+ * the key range.  The remaining chunks have nothing to return.
+ */
+static void
+o_parallel_index_finish(OScanState *ostate)
+{
+	OParallelIndexScan pscan = get_parallel_index_scan(ostate);
+
+	SpinLockAcquire(&pscan->mutex);
+	pscan->status = OParallelIndexScanFinished;
+	pscan->version++;
+	SpinLockRelease(&pscan->mutex);
+}
+
+/*
+ * Claims the next chunk of the key range and makes the iterator over it.
+ * Returns false when all the chunks are claimed.
+ *
+ * The chunk bounds are found without holding the lock.  The claim succeeds
+ * only if no other participant claimed a chunk meanwhile, otherwise we retry
+ * from the updated low key.
+ */
+static bool
+o_parallel_index_next_chunk(OIndexDescr *indexDescr, OScanState *ostate,
+							MemoryContext tupleCxt)
+{
+	OParallelIndexScan pscan = get_parallel_index_scan(ostate);
+	BTreeDescr *desc = &indexDescr->desc;
+	OParallelIndexScanStatus status = OParallelIndexScanNotStarted;
+	OFixedKey	low;
+	OFixedShmemKey nextKey;
+	uint64		version;
+	bool		last = false;
+	bool		claimed = false;
+	MemoryContext oldcontext;
+
+	if (ostate->iterator != NULL)
+	{
+		btree_iterator_free(ostate->iterator);
+		ostate->iterator = NULL;
+	}
+
+	while (!claimed)
+	{
+		SpinLockAcquire(&pscan->mutex);
+		status = pscan->status;
+		version = pscan->version;
+		if (status == OParallelIndexScanInProgress)
+			copy_from_fixed_shmem_key(&low, &pscan->nextKey);
+		SpinLockRelease(&pscan->mutex);
+
+		if (status == OParallelIndexScanFinished)
+			return false;
+
+		if (status == OParallelIndexScanNotStarted)
+			btree_downlinks_range_high(desc, ostate->oSnapshot.csn,
+									   &ostate->curKeyRange.low, BTreeKeyBound,
+									   O_PARALLEL_INDEX_SCAN_CHUNK,
+									   &ostate->chunkHigh);
+		else
+			btree_downlinks_range_high(desc, ostate->oSnapshot.csn,
+									   &low.tuple, BTreeKeyNonLeafKey,
+									   O_PARALLEL_INDEX_SCAN_CHUNK,
+									   &ostate->chunkHigh);
+
+		last = O_TUPLE_IS_NULL(ostate->chunkHigh.tuple) ||
+			o_btree_cmp(desc, &ostate->curKeyRange.high, BTreeKeyBound,
+						&ostate->chunkHigh.tuple, BTreeKeyNonLeafKey) < 0;
+		if (!last)
+			copy_fixed_shmem_key(desc, &nextKey, ostate->chunkHigh.tuple);
+
+		SpinLockAcquire(&pscan->mutex);
+		if (pscan->version == version)
+		{
+			if (last)
+			{
+				pscan->status = OParallelIndexScanFinished;
+			}
+			else
+			{
+				pscan->status = OParallelIndexScanInProgress;
+				pscan->nextKey = nextKey;
+			}
+			pscan->version++;
+			claimed = true;
+		}
+		SpinLockRelease(&pscan->mutex);
+	}
+
+	if (last)
+		clear_fixed_key(&ostate->chunkHigh);
+
+	oldcontext = MemoryContextSwitchTo(ostate->cxt);
+	if (status == OParallelIndexScanNotStarted)
+		ostate->iterator = o_btree_iterator_create(desc,
+												   (Pointer) &ostate->curKeyRange.low,
+												   BTreeKeyBound,
+												   &ostate->oSnapshot,
+												   ForwardScanDirection);
+	else
+		ostate->iterator = o_btree_iterator_create(desc, (Pointer) &low.tuple,
+												   BTreeKeyNonLeafKey,
+												   &ostate->oSnapshot,
+												   ForwardScanDirection);
+	o_btree_iterator_set_tuple_ctx(ostate->iterator, tupleCxt);
+	MemoryContextSwitchTo(oldcontext);
+
+	return true;
+}
+
 static bool
 switch_to_next_range(OIndexDescr *indexDescr, OScanState *ostate,
 					 MemoryContext tupleCxt)
@@ -268,6 +426,21 @@ switch_to_next_range(OIndexDescr *indexDescr, OScanState *ostate,
 	BTScanOpaque so = (BTScanOpaque) scan->opaque;
 	MemoryContext oldcontext;
 	bool		result = true;
+	bool		firstRange = !ostate->curKeyRangeIsLoaded;
+
+	if (ostate->parallelSkip)
+		return false;
+
+	if (firstRange && scan->parallel_scan != NULL)
+	{
+		ostate->parallelChunks = so->numArrayKeys == 0 &&
+			ScanDirectionIsForward(ostate->scanDir);
+		if (!ostate->parallelChunks && !o_parallel_index_claim_all(ostate))
+		{
+			ostate->parallelSkip = true;
+			return false;
+		}
+	}
 
 #if PG_VERSION_NUM >= 170000
 
@@ -325,6 +498,22 @@ switch_to_next_range(OIndexDescr *indexDescr, OScanState *ostate,
 											indexDescr->nonLeafTupdesc->natts,
 											indexDescr->fields);
 
+	if (ostate->parallelChunks)
+	{
+		MemoryContextSwitchTo(oldcontext);
+		if (ostate->exact)
+		{
+			/* Exact key lookup is done by a single participant */
+			if (!o_parallel_index_claim_all(ostate))
+			{
+				ostate->parallelSkip = true;
+				return false;
+			}
+			return true;
+		}
+		return o_parallel_index_next_chunk(indexDescr, ostate, tupleCxt);
+	}
+
 	if (!ostate->exact)
 	{
 		bound = (ostate->scanDir == ForwardScanDirection
@@ -389,7 +578,28 @@ o_iterate_index(OIndexDescr *indexDescr, OScanState *ostate,
 											 true, hint);
 
 				if (O_TUPLE_IS_NULL(tup))
+				{
+					if (ostate->parallelChunks)
+						o_parallel_index_finish(ostate);
 					tup_is_valid = true;
+				}
+				else if (ostate->parallelChunks &&
+						 !O_TUPLE_IS_NULL(ostate->chunkHigh.tuple) &&
+						 o_btree_cmp(&indexDescr->desc,
+									 &tup, BTreeKeyLeafTuple,
+									 &ostate->chunkHigh.tuple,
+									 BTreeKeyNonLeafKey) >= 0)
+				{
+					/* Current chunk is over, continue with the next one */
+					if (o_parallel_index_next_chunk(indexDescr, ostate,
+													tupleCxt))
+						tup_is_valid = false;
+					else
+					{
+						O_TUPLE_SET_NULL(tup);
+						tup_is_valid = true;
+					}
+				}
 				else
 				{
 					tup_is_valid = is_tuple_valid(tup, indexDescr,
@@ -492,18 +702,201 @@ o_index_scan_getnext(OTableDescr *descr, OScanState *ostate,
 	return tup;
 }
 
+/*
+ * Checks if the clause is a "column op constant" qual, which can be evaluated
+ * on the tuple before deforming.  Only fixed-length columns are considered:
+ * they can't be TOASTed.  The operator must be strict and leakproof, because
+ * it's evaluated ahead of the other quals.
+ */
+static bool
+o_fill_tuple_qual(Expr *clause, Index scanrelid, TupleDesc tupdesc,
+				  OTupleQual *qual)
+{
+	OpExpr	   *op;
+	Node	   *left,
+			   *right;
+	Var		   *var;
+	Const	   *con;
+	Form_pg_attribute att;
+
+	if (!IsA(clause, OpExpr))
+		return false;
+
+	op = (OpExpr *) clause;
+	if (list_length(op->args) != 2 || op->opresulttype != BOOLOID ||
+		op->opretset)
+		return false;
+
+	left = (Node *) linitial(op->args);
+	right = (Node *) lsecond(op->args);
+	if (IsA(left, Var) && IsA(right, Const))
+	{
+		var = (Var *) left;
+		con = (Const *) right;
+		qual->varOnLeft = true;
+	}
+	else if (IsA(left, Const) && IsA(right, Var))
+	{
+		var = (Var *) right;
+		con = (Const *) left;
+		qual->varOnLeft = false;
+	}
+	else
+		return false;
+
+	if (var->varno != scanrelid || var->varlevelsup != 0 ||
+		var->varattno <= 0 || var->varattno > tupdesc->natts ||
+		con->constisnull)
+		return false;
+
+	att = TupleDescAttr(tupdesc, var->varattno - 1);
+	if (att->attisdropped || att->attlen <= 0 ||
+		att->atttypid != var->vartype)
+		return false;
+
+	set_opfuncid(op);
+	if (!func_strict(op->opfuncid) || !get_func_leakproof(op->opfuncid))
+		return false;
+
+	qual->attnum = var->varattno;
+	qual->collation = op->inputcollid;
+	qual->constval = con->constvalue;
+	fmgr_info(op->opfuncid, &qual->finfo);
+
+	return true;
+}
+
+/*
+ * Splits the scan quals into the ones evaluated on the tuple before storing
+ * it into the slot and the rest remaining in ps.qual.  Should be called only
+ * when the scan returns the primary index tuples in the table attributes
+ * order.
+ */
+void
+o_init_tuple_quals(OScanState *ostate, ScanState *ss)
+{
+	Scan	   *scan = (Scan *) ss->ps.plan;
+	TupleDesc	tupdesc = RelationGetDescr(ss->ss_currentRelation);
+	List	   *restQuals = NIL;
+	ListCell   *lc;
+
+	ostate->numTupleQuals = 0;
+	if (scan->plan.qual == NIL)
+		return;
+
+	ostate->tupleQuals = (OTupleQual *) palloc(sizeof(OTupleQual) *
+											   list_length(scan->plan.qual));
+	foreach(lc, scan->plan.qual)
+	{
+		Expr	   *clause = (Expr *) lfirst(lc);
+
+		if (o_fill_tuple_qual(clause, scan->scanrelid, tupdesc,
+							  &ostate->tupleQuals[ostate->numTupleQuals]))
+			ostate->numTupleQuals++;
+		else
+			restQuals = lappend(restQuals, clause);
+	}
+
+	if (ostate->numTupleQuals == 0)
+	{
+		pfree(ostate->tupleQuals);
+		ostate->tupleQuals = NULL;
+		return;
+	}
+
+	ostate->fullQual = ss->ps.qual;
+	ss->ps.qual = ExecInitQual(restQuals, &ss->ps);
+}
+
+/* o_fastgetattr() which also handles attributes missing in the tuple */
+static inline Datum
+o_tuple_getattr(OTuple tuple, int attnum, TupleDesc desc,
+				OTupleFixedFormatSpec *spec, bool *isnull)
+{
+	int			natts;
+
+	if (tuple.formatFlags & O_TUPLE_FLAGS_FIXED_FORMAT)
+		natts = spec->natts;
+	else
+		natts = ((OTupleHeader) tuple.data)->natts;
+
+	if (attnum > natts)
+		return getmissingattr(desc, attnum, isnull);
+
+	return o_fastgetattr(tuple, attnum, desc, spec, isnull);
+}
+
+/* evaluates tuple quals on the primary index tuple */
+static bool
+o_exec_tuple_quals(OScanState *ostate, OTableDescr *descr, OTuple tuple,
+				   ExprContext *econtext)
+{
+	OIndexDescr *primary = GET_PRIMARY(descr);
+	int			ctid_off = primary->primaryIsCtid ? 1 : 0;
+	MemoryContext mcxt;
+	bool		result = true;
+	int			i;
+
+	mcxt = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+	for (i = 0; i < ostate->numTupleQuals && result; i++)
+	{
+		OTupleQual *qual = &ostate->tupleQuals[i];
+		LOCAL_FCINFO(fcinfo, 2);
+		Datum		value;
+		Datum		res;
+		bool		isnull;
+
+		value = o_tuple_getattr(tuple, qual->attnum + ctid_off,
+								primary->leafTupdesc, &primary->leafSpec,
+								&isnull);
+
+		/* operator is strict */
+		if (isnull)
+		{
+			result = false;
+			break;
+		}
+
+		InitFunctionCallInfoData(*fcinfo, &qual->finfo, 2, qual->collation,
+								 NULL, NULL);
+		fcinfo->args[0].value = qual->varOnLeft ? value : qual->constval;
+		fcinfo->args[0].isnull = false;
+		fcinfo->args[1].value = qual->varOnLeft ? qual->constval : value;
+		fcinfo->args[1].isnull = false;
+		res = FunctionCallInvoke(fcinfo);
+
+		result = !fcinfo->isnull && DatumGetBool(res);
+	}
+	MemoryContextSwitchTo(mcxt);
+
+	return result;
+}
+
+/* accounts attributes deformed in the slot before it gets overwritten */
+static inline void
+o_count_deformed(OScanState *ostate, TupleTableSlot *slot)
+{
+	if (!TTS_EMPTY(slot) && slot->tts_nvalid > 0)
+	{
+		ostate->rowsDeformed++;
+		ostate->attrsDeformed += slot->tts_nvalid;
+	}
+}
+
 /* fetches next tuple for oIterateDirectModify */
 TupleTableSlot *
 o_exec_fetch(OScanState *ostate, ScanState *ss)
 {
 	OTableDescr *descr = relation_get_descr(ss->ss_currentRelation);
-	TupleTableSlot *slot;
+	TupleTableSlot *slot = ss->ss_ScanTupleSlot;
 	OTuple		tuple;
 	bool		scan_primary = ostate->ixNum == PrimaryIndexNumber ||
 		!ostate->onlyCurIx;
-	MemoryContext tupleCxt = ss->ss_ScanTupleSlot->tts_mcxt;
+	MemoryContext tupleCxt = slot->tts_mcxt;
 
-	do
+	o_count_deformed(ostate, slot);
+
+	while (true)
 	{
 		BTreeLocationHint hint = {OInvalidInMemoryBlkno, 0};
 		CommitSeqNo tupleCsn;
@@ -514,22 +907,54 @@ o_exec_fetch(OScanState *ostate, ScanState *ss)
 		tuple = o_index_scan_getnext(descr, ostate, &tupleCsn, scan_primary, tupleCxt, &hint);
 
 		if (O_TUPLE_IS_NULL(tuple))
+			return ExecClearTuple(slot);
+
+		/* Check simple quals before storing the tuple into the slot */
+		if (ostate->numTupleQuals > 0 &&
+			!o_exec_tuple_quals(ostate, descr, tuple, ss->ps.ps_ExprContext))
 		{
-			slot = ExecClearTuple(ss->ss_ScanTupleSlot);
-		}
-		else
-		{
-			tts_orioledb_store_tuple(ss->ss_ScanTupleSlot, tuple,
-									 descr, tupleCsn,
-									 scan_primary ? PrimaryIndexNumber : ostate->ixNum,
-									 true, &hint);
-			slot = ss->ss_ScanTupleSlot;
+			ostate->rowsSkipped++;
+			InstrCountFiltered1(&ss->ps, 1);
+			pfree(tuple.data);
+			continue;
 		}
-	} while (!TupIsNull(slot) &&
-			 !o_exec_qual(ss->ps.ps_ExprContext,
-						  ss->ps.qual, slot));
 
-	return slot;
+		tts_orioledb_store_tuple(slot, tuple,
+								 descr, tupleCsn,
+								 scan_primary ? PrimaryIndexNumber : ostate->ixNum,
+								 true, &hint);
+
+		if (o_exec_qual(ss->ps.ps_ExprContext, ss->ps.qual, slot))
+			return slot;
+
+		InstrCountFiltered1(&ss->ps, 1);
+		o_count_deformed(ostate, slot);
+	}
+}
+
+/* adds late materialization counters to EXPLAIN ANALYZE VERBOSE */
+void
+o_explain_deform_counters(OScanState *ostate, ScanState *ss, ExplainState *es)
+{
+	TupleTableSlot *slot = ss->ss_ScanTupleSlot;
+	uint64		rowsDeformed = ostate->rowsDeformed;
+	uint64		attrsDeformed = ostate->attrsDeformed;
+
+	if (!es->analyze || !es->verbose)
+		return;
+
+	/* the slot may still contain the last returned row */
+	if (!TTS_EMPTY(slot) && slot->tts_nvalid > 0)
+	{
+		rowsDeformed++;
+		attrsDeformed += slot->tts_nvalid;
+	}
+
+	if (ostate->numTupleQuals > 0)
+		ExplainPropertyUInteger("Rows Skipped Before Deforming", NULL,
+								ostate->rowsSkipped, es);
+	ExplainPropertyUInteger("Rows Deformed", NULL, rowsDeformed, es);
+	ExplainPropertyUInteger("Attributes Deformed", NULL, attrsDeformed, es);
 }
 
 /* checks quals for a tuple slot */
@@ -433,6 +433,91 @@ o_keybitmap_union(RBTree *a, RBTree *b)
 	}
 }
 
+/*
+ * Serialized key bitmap is the number of nodes followed by the nodes in key
+ * order.  Every node is its key, the flag whether it has a bitmap, and the
+ * bitmap itself if any.
+ */
+Size
+o_keybitmap_serialized_size(RBTree *rbtree)
+{
+	RBTreeIterator iter;
+	OKeyBitmapRBTNode *node;
+	Size		size = sizeof(uint64);
+
+	rbt_begin_iterate(rbtree, LeftRightWalk, &iter);
+	while ((node = (OKeyBitmapRBTNode *) rbt_iterate(&iter)) != NULL)
+	{
+		size += sizeof(uint64) + sizeof(bool);
+		if (node->bitmap)
+			size += BITMAP_SIZE;
+	}
+	return size;
+}
+
+void
+o_keybitmap_serialize(RBTree *rbtree, Pointer ptr)
+{
+	RBTreeIterator iter;
+	OKeyBitmapRBTNode *node;
+	Pointer		nnodesPtr = ptr;
+	uint64		nnodes = 0;
+
+	ptr += sizeof(uint64);
+	rbt_begin_iterate(rbtree, LeftRightWalk, &iter);
+	while ((node = (OKeyBitmapRBTNode *) rbt_iterate(&iter)) != NULL)
+	{
+		bool		hasBitmap = (node->bitmap != NULL);
+
+		memcpy(ptr, &node->key, sizeof(uint64));
+		ptr += sizeof(uint64);
+		memcpy(ptr, &hasBitmap, sizeof(bool));
+		ptr += sizeof(bool);
+		if (hasBitmap)
+		{
+			memcpy(ptr, node->bitmap, BITMAP_SIZE);
+			ptr += BITMAP_SIZE;
+		}
+		nnodes++;
+	}
+	memcpy(nnodesPtr, &nnodes, sizeof(uint64));
+}
+
+RBTree *
+o_keybitmap_deserialize(Pointer ptr)
+{
+	RBTree	   *rbtree = o_keybitmap_create();
+	uint64		nnodes,
+				i;
+
+	memcpy(&nnodes, ptr, sizeof(uint64));
+	ptr += sizeof(uint64);
+	for (i = 0; i < nnodes; i++)
+	{
+		OKeyBitmapRBTNode node;
+		bool		hasBitmap;
+		bool		is_new;
+
+		memcpy(&node.key, ptr, sizeof(uint64));
+		ptr += sizeof(uint64);
+		memcpy(&hasBitmap, ptr, sizeof(bool));
+		ptr += sizeof(bool);
+		if (hasBitmap)
+		{
+			node.bitmap = palloc(BITMAP_SIZE);
+			memcpy(node.bitmap, ptr, BITMAP_SIZE);
+			ptr += BITMAP_SIZE;
+		}
+		else
+			node.bitmap = NULL;
+
+		/* Keys are unique, so the new tree node takes the bitmap */
+		(void) rbt_insert(rbtree, &node.rbtnode, &is_new);
+		Assert(is_new);
+	}
+	return rbtree;
+}
+
 static int
 bm_rbt_comparator(const RBTNode *a, const RBTNode *b, void *arg)
 {
@@ -30,6 +30,7 @@
 
 #include "access/heapam.h"
 #include "access/tableam.h"
+#include "access/xlog.h"
 #include "catalog/index.h"
 #include "catalog/storage.h"
 #include "commands/vacuum.h"
@@ -491,6 +492,25 @@ o_tbl_insert_with_arbiter(Relation rel,
 	return NULL;
 }
 
+/*
+ * Checks if the update of the table might be WAL-logged as a delta relative
+ * to the old tuple.  Logical decoding needs the whole new tuple, so delta is
+ * never used with wal_level = logical.
+ */
+static bool
+wal_update_delta_enabled(Relation rel, OTableDescr *descr,
+						 TupleTableSlot *oldSlot)
+{
+	ORelOptions *options = (ORelOptions *) rel->rd_options;
+	OTableSlot *oldOSlot = (OTableSlot *) oldSlot;
+
+	if (!options || !options->wal_update_delta || XLogLogicalInfoActive())
+		return false;
+
+	return !O_TUPLE_IS_NULL(oldOSlot->tuple) && oldOSlot->descr == descr &&
+		oldOSlot->ixnum == PrimaryIndexNumber && oldOSlot->leafTuple;
+}
+
 OTableModifyResult
 o_tbl_update(OTableDescr *descr, TupleTableSlot *slot,
 			 OBTreeKeyBound *oldPkey, Relation rel, OXid oxid,
@@ -572,7 +592,11 @@ o_tbl_update(OTableDescr *descr, TupleTableSlot *slot,
 			{
 				OTuple		final_tup = tts_orioledb_form_tuple(slot, descr);
 
-				o_wal_update(&primary->desc, final_tup);
+				if (wal_update_delta_enabled(rel, descr, oldSlot))
+					o_wal_update_delta(&primary->desc, final_tup,
+									   ((OTableSlot *) oldSlot)->tuple);
+				else
+					o_wal_update(&primary->desc, final_tup);
 			}
 		}
 		else if (mres.action == BTreeOperationDelete)
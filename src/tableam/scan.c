@@ -27,6 +27,7 @@
 #include "tuple/slot.h"
 #include "utils/stopevent.h"
 
+#include "access/parallel.h"
 #include "access/relation.h"
 #include "access/table.h"
 #include "common/hashfn.h"
@@ -92,6 +93,17 @@ static void o_begin_custom_scan(CustomScanState *node, EState *estate, int eflag
 static TupleTableSlot *o_exec_custom_scan(CustomScanState *node);
 static void o_end_custom_scan(CustomScanState *node);
 static void o_rescan_custom_scan(CustomScanState *node);
+static Size o_estimate_dsm_custom_scan(CustomScanState *node,
+										ParallelContext *pcxt);
+static void o_initialize_dsm_custom_scan(CustomScanState *node,
+										 ParallelContext *pcxt,
+										 void *coordinate);
+static void o_reinitialize_dsm_custom_scan(CustomScanState *node,
+										   ParallelContext *pcxt,
+										   void *coordinate);
+static void o_initialize_worker_custom_scan(CustomScanState *node,
+											shm_toc *toc,
+											void *coordinate);
 static void o_explain_custom_scan(CustomScanState *node, List *ancestors,
 								  ExplainState *es);
 static Node *o_create_custom_scan_state(CustomScan *cscan);
@@ -117,10 +129,10 @@ static CustomExecMethods o_scan_exec_methods =
 	o_rescan_custom_scan,
 	NULL,
 	NULL,
-	NULL,
-	NULL,
-	NULL,
-	NULL,
+	o_estimate_dsm_custom_scan,
+	o_initialize_dsm_custom_scan,
+	o_reinitialize_dsm_custom_scan,
+	o_initialize_worker_custom_scan,
 	NULL,
 	o_explain_custom_scan
 };
@@ -382,12 +394,32 @@ orioledb_set_rel_pathlist_hook(PlannerInfo *root, RelOptInfo *rel,
 			while (i < list_length(rel->partial_pathlist))
 			{
 				Path	   *path = list_nth(rel->partial_pathlist, i);
+				bool		keep = IsA(path, Path);
 
 				/*
-				 * TODO: Remove when parallel bitmap heap scan will be
-				 * implemented
+				 * Parallel index scans of secondary indexes are executed by
+				 * the index access method.  Primary index scans are
+				 * transformed into custom scans, which aren't parallel-aware.
+				 * Parallel bitmap heap scans are transformed into
+				 * parallel-aware custom scans.
 				 */
-				if (!IsA(path, Path))
+				if (IsA(path, IndexPath))
+				{
+					IndexPath  *ix_path = (IndexPath *) path;
+
+					keep = GET_PRIMARY(descr)->oids.reloid != ix_path->indexinfo->indexoid;
+				}
+				else if (IsA(path, BitmapHeapPath))
+				{
+					Path	   *custom_path = transform_path(path, descr);
+
+					rel->partial_pathlist = list_delete_nth_cell(rel->partial_pathlist, i);
+					rel->partial_pathlist = list_insert_nth(rel->partial_pathlist, i,
+															custom_path);
+					keep = true;
+				}
+
+				if (!keep)
 					rel->partial_pathlist = list_delete_nth_cell(rel->partial_pathlist, i);
 				else
 					i++;
@@ -621,6 +653,14 @@ o_begin_custom_scan(CustomScanState *node, EState *estate, int eflags)
 
 		ix_plan_state->iss_RuntimeContext = CreateExprContext(estate);
 
+		/*
+		 * Evaluate simple quals on the primary index tuples before deforming
+		 * them.  Index-only scans have their own scan tuple layout.
+		 */
+		if (((CustomScan *) node->ss.ps.plan)->custom_scan_tlist == NIL &&
+			(ix_num == PrimaryIndexNumber || !scan_state->onlyCurIx))
+			o_init_tuple_quals(scan_state, &node->ss);
+
 		/*
 		 * If no run-time keys to calculate or they are ready, go ahead and
 		 * pass the scankeys to the index AM.
@@ -717,7 +757,10 @@ o_exec_custom_scan(CustomScanState *node)
 					return NULL;
 
 				if (!o_exec_qual(node->ss.ps.ps_ExprContext,
-								 node->ss.ps.qual, slot))
+								 ix_plan_state->ostate.fullQual ?
+								 ix_plan_state->ostate.fullQual :
+								 node->ss.ps.qual,
+								 slot))
 					return NULL;
 
 				slot = o_exec_project(node->ss.ps.ps_ProjInfo,
@@ -853,6 +896,53 @@ o_end_custom_scan(CustomScanState *node)
 	ea_counters = NULL;
 }
 
+/*
+ * Parallel custom scan.  Only bitmap heap scans are parallel-aware.
+ */
+static Size
+o_estimate_dsm_custom_scan(CustomScanState *node, ParallelContext *pcxt)
+{
+	OCustomScanState *ocstate = (OCustomScanState *) node;
+
+	if (ocstate->o_plan_state->type == O_BitmapHeapPlan)
+		return o_bitmap_scan_estimate_dsm();
+	return 0;
+}
+
+static void
+o_initialize_dsm_custom_scan(CustomScanState *node, ParallelContext *pcxt,
+							 void *coordinate)
+{
+	OCustomScanState *ocstate = (OCustomScanState *) node;
+
+	if (ocstate->o_plan_state->type == O_BitmapHeapPlan)
+		o_bitmap_scan_initialize_dsm((OBitmapHeapPlanState *) ocstate->o_plan_state,
+									 coordinate);
+}
+
+static void
+o_reinitialize_dsm_custom_scan(CustomScanState *node, ParallelContext *pcxt,
+							   void *coordinate)
+{
+	OCustomScanState *ocstate = (OCustomScanState *) node;
+
+	if (ocstate->o_plan_state->type == O_BitmapHeapPlan)
+		o_bitmap_scan_reinitialize_dsm((OBitmapHeapPlanState *) ocstate->o_plan_state,
+									   node->ss.ss_currentRelation,
+									   node->ss.ps.state->es_query_dsa);
+}
+
+static void
+o_initialize_worker_custom_scan(CustomScanState *node, shm_toc *toc,
+								void *coordinate)
+{
+	OCustomScanState *ocstate = (OCustomScanState *) node;
+
+	if (ocstate->o_plan_state->type == O_BitmapHeapPlan)
+		o_bitmap_scan_initialize_worker((OBitmapHeapPlanState *) ocstate->o_plan_state,
+										coordinate);
+}
+
 typedef struct OExplainContext
 {
 	List	   *ancestors;
@@ -1048,9 +1138,10 @@ o_explain_custom_scan(CustomScanState *node, List *ancestors, ExplainState *es)
 		if (ix_plan_state->stripped_indexquals)
 			show_instrumentation_count("Rows Removed by Index Recheck", 2,
 									   &node->ss.ps, es);
-		if (node->ss.ps.qual)
+		if (node->ss.ps.qual || ix_plan_state->ostate.numTupleQuals > 0)
 			show_instrumentation_count("Rows Removed by Filter", 1,
 									   &node->ss.ps, es);
+		o_explain_deform_counters(&ix_plan_state->ostate, &node->ss, es);
 	}
 	else if (ocstate->o_plan_state->type == O_BitmapHeapPlan)
 	{
@@ -18,6 +18,7 @@
 
 #include "btree/btree.h"
 #include "btree/io.h"
+#include "btree/page_contents.h"
 #include "catalog/o_sys_cache.h"
 #include "catalog/sys_trees.h"
 #include "recovery/recovery.h"
@@ -48,6 +49,8 @@ static OTuple o_tuple_make_key(BTreeDescr *desc, OTuple tuple,
 static OTuple o_create_key_tuple(BTreeDescr *desc, OTuple tuple,
 								 Pointer data, OIndexType type,
 								 bool keep_version);
+static OTuple o_idx_make_separator(BTreeDescr *desc, OTuple left,
+								   OTuple right);
 static bool pk_needs_undo(BTreeDescr *desc, BTreeOperationType action,
 						  OTuple oldTuple, OTupleXactInfo oldXactInfo,
 						  bool oldDeleted, OTuple newTuple, OXid newOxid);
@@ -59,7 +62,8 @@ static BTreeOps primaryOps = {
 	.needs_undo = pk_needs_undo,
 	.cmp = o_idx_cmp,
 	.hash = o_idx_hash,
-	.unique_hash = o_idx_unique_hash
+	.unique_hash = o_idx_unique_hash,
+	.make_separator = o_idx_make_separator
 },
 
 			secondaryOps = {
@@ -69,7 +73,8 @@ static BTreeOps primaryOps = {
 	.needs_undo = NULL,
 	.cmp = o_idx_cmp,
 	.hash = o_idx_hash,
-	.unique_hash = o_idx_unique_hash
+	.unique_hash = o_idx_unique_hash,
+	.make_separator = o_idx_make_separator
 },
 
 			toastOps = {
@@ -106,6 +111,10 @@ index_btree_desc_init(BTreeDescr *desc, OCompress compress, int fillfactor,
 	desc->rootInfo.rootPageBlkno = OInvalidInMemoryBlkno;
 	desc->rootInfo.metaPageBlkno = OInvalidInMemoryBlkno;
 	desc->rootInfo.rootPageChangeCount = 0;
+	desc->rightmostLeaf.blkno = OInvalidInMemoryBlkno;
+	desc->rightmostLeaf.pageChangeCount = InvalidOPageChangeCount;
+	desc->lastLeaf.blkno = OInvalidInMemoryBlkno;
+	desc->lastLeaf.pageChangeCount = InvalidOPageChangeCount;
 	btree_init_smgr(desc);
 	desc->freeBuf.file = -1;
 	desc->nextChkp[0].file = -1;
@@ -439,6 +448,70 @@ o_sidx_tuple_make_key(BTreeDescr *desc, OTuple tuple, Pointer data,
 	return o_create_key_tuple(desc, tuple, data, oIndexRegular, keep_version);
 }
 
+/*
+ * Makes suffix-truncated separator key for the split between `left` and
+ * `right` leaf tuples.  The separator consists of leading `right` attributes
+ * up to the first one differing from `left`.  Omitted attributes are minus
+ * infinity for comparison, so `left` < separator <= `right`.
+ */
+static OTuple
+o_idx_make_separator(BTreeDescr *desc, OTuple left, OTuple right)
+{
+	OIndexDescr *id = o_get_tree_def(desc);
+	OTupleFixedFormatSpec spec = {0};
+	Datum		values[INDEX_MAX_KEYS];
+	bool		isnull[INDEX_MAX_KEYS];
+	TupleDesc	tupdesc;
+	OTuple		result;
+	int			i,
+				n = id->nonLeafTupdesc->natts,
+				natts = n,
+				len;
+
+	O_TUPLE_SET_NULL(result);
+	if (!BTREE_GET_META(desc)->suffixTruncation || n <= 1)
+		return result;
+
+	for (i = 0; i < n; i++)
+	{
+		int			attnum = OIndexKeyAttnumToTupleAttnum(BTreeKeyLeafTuple,
+														  id, i + 1);
+		Datum		leftValue;
+		bool		leftIsnull;
+
+		values[i] = o_fastgetattr(right, attnum, id->leafTupdesc,
+								  &id->leafSpec, &isnull[i]);
+		if (OIgnoreColumn(id, i))
+			continue;
+
+		leftValue = o_fastgetattr(left, attnum, id->leafTupdesc,
+								  &id->leafSpec, &leftIsnull);
+		if (leftIsnull != isnull[i] ||
+			(!leftIsnull &&
+			 o_call_comparator(id->fields[i].comparator,
+							   leftValue, values[i]) != 0))
+		{
+			natts = i + 1;
+			break;
+		}
+	}
+
+	if (natts >= n)
+		return result;
+
+	/*
+	 * Zero-attribute spec forces the variable format, which keeps the number
+	 * of attributes in the tuple header.
+	 */
+	tupdesc = CreateTupleDescCopy(id->nonLeafTupdesc);
+	tupdesc->natts = natts;
+	len = o_new_tuple_size(tupdesc, &spec, NULL, 0, values, isnull, NULL);
+	result.data = (Pointer) palloc0(len);
+	o_tuple_fill(tupdesc, &spec, &result, len, NULL, 0, values, isnull, NULL);
+	pfree(tupdesc);
+
+	return result;
+}
 
 static inline bool
 o_bound_is_coercible(OBTreeValueBound *bound, OIndexField *field)
@@ -455,6 +528,7 @@ o_fill_key_bound(OIndexDescr *id, OTuple tuple,
 	TupleDesc	tupdesc;
 	OTupleFixedFormatSpec *spec;
 	int			i,
+				natts,
 				attnum;
 	bool		isnull;
 
@@ -471,15 +545,23 @@ o_fill_key_bound(OIndexDescr *id, OTuple tuple,
 		tupdesc = id->nonLeafTupdesc;
 		spec = &id->nonLeafSpec;
 	}
+	natts = (keyType == BTreeKeyNonLeafKey) ? o_key_natts(tuple, tupdesc) :
+		id->nonLeafTupdesc->natts;
 	for (i = 0; i < id->nonLeafTupdesc->natts; i++)
 	{
 		attnum = OIndexKeyAttnumToTupleAttnum(keyType, id, i + 1);
-		bound->keys[i].value = o_fastgetattr(tuple, attnum, tupdesc, spec, &isnull);
 		bound->keys[i].type = tupdesc->attrs[attnum - 1].atttypid;
+		bound->keys[i].comparator = id->fields[i].comparator;
+		if (i >= natts)
+		{
+			bound->keys[i].value = (Datum) 0;
+			bound->keys[i].flags = O_VALUE_BOUND_UNBOUNDED | O_VALUE_BOUND_LOWER;
+			continue;
+		}
+		bound->keys[i].value = o_fastgetattr(tuple, attnum, tupdesc, spec, &isnull);
 		bound->keys[i].flags = O_VALUE_BOUND_PLAIN_VALUE;
 		if (isnull)
 			bound->keys[i].flags |= O_VALUE_BOUND_NULL;
-		bound->keys[i].comparator = id->fields[i].comparator;
 	}
 }
 
@@ -617,6 +699,8 @@ o_idx_cmp_tuples(OIndexDescr *id,
 			   *spec2;
 	int			i,
 				n,
+				natts1,
+				natts2,
 				attnum1,
 				attnum2;
 	Datum		value1,
@@ -649,8 +733,16 @@ o_idx_cmp_tuples(OIndexDescr *id,
 	}
 
 	n = id->nonLeafTupdesc->natts;
+	natts1 = (keyType1 == BTreeKeyNonLeafKey) ?
+		o_key_natts(*tuple1, tupdesc1) : n;
+	natts2 = (keyType2 == BTreeKeyNonLeafKey) ?
+		o_key_natts(*tuple2, tupdesc2) : n;
 	for (i = 0; i < n; i++)
 	{
+		/* Truncated attributes are minus infinity */
+		if (i >= natts1 || i >= natts2)
+			return (i >= natts1 ? -1 : 0) + (i >= natts2 ? 1 : 0);
+
 		if (!OIgnoreColumn(id, i))
 		{
 			OIndexField *field = &id->fields[i];
@@ -690,6 +782,7 @@ o_idx_cmp_key_bound_to_tuple(OIndexDescr *id,
 	OTupleFixedFormatSpec *spec;
 	int			i,
 				n,
+				natts,
 				attnum;
 	Datum		value;
 	bool		isnull;
@@ -700,11 +793,13 @@ o_idx_cmp_key_bound_to_tuple(OIndexDescr *id,
 	{
 		tupdesc = id->leafTupdesc;
 		spec = &id->leafSpec;
+		natts = id->nonLeafTupdesc->natts;
 	}
 	else
 	{
 		tupdesc = id->nonLeafTupdesc;
 		spec = &id->nonLeafSpec;
+		natts = o_key_natts(*tuple2, tupdesc);
 	}
 	if (keyType1 == BTreeKeyBound)
 	{
@@ -727,6 +822,10 @@ o_idx_cmp_key_bound_to_tuple(OIndexDescr *id,
 			if (flags & O_VALUE_BOUND_UNBOUNDED)
 				return (flags & O_VALUE_BOUND_LOWER) ? -1 : 1;
 
+			/* Truncated key attribute is minus infinity */
+			if (i >= natts)
+				return 1;
+
 			attnum = OIndexKeyAttnumToTupleAttnum(keyType2, id, i + 1);
 			value = o_fastgetattr(*tuple2, attnum, tupdesc, spec, &isnull);
 
@@ -1035,7 +1134,7 @@ o_key_to_jsonb(BTreeDescr *desc, OTuple key, JsonbParseState **state)
 	(void) pushJsonbValue(state, WJB_BEGIN_OBJECT, NULL);
 	o_key_to_jsonb_internal(id->nonLeafTupdesc,
 							&id->nonLeafSpec,
-							id->nonLeafTupdesc->natts,
+							o_key_natts(key, id->nonLeafTupdesc),
 							key, state);
 	return pushJsonbValue(state, WJB_END_OBJECT, NULL);
 }
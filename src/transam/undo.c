@@ -23,9 +23,11 @@
 #include "recovery/wal.h"
 #include "tableam/descr.h"
 #include "tableam/handler.h"
+#include "tableam/toast.h"
 #include "transam/oxid.h"
 #include "transam/undo.h"
 #include "utils/o_buffers.h"
+#include "utils/o_stat.h"
 #include "utils/page_pool.h"
 #include "utils/snapshot.h"
 #include "utils/stopevent.h"
@@ -862,7 +864,10 @@ write_undo_range(OBuffersDesc *desc, Pointer buf, UndoLogType undoType,
 				 UndoLocation minLoc, UndoLocation maxLoc)
 {
 	if (maxLoc > minLoc)
+	{
 		o_buffers_write(desc, buf, (uint32) undoType, minLoc, maxLoc - minLoc);
+		o_stat_global_count(OStatUndoBytesWritten, maxLoc - minLoc);
+	}
 }
 
 static void
@@ -1094,6 +1099,7 @@ get_undo_record(UndoLogType undoType, UndoLocation *undoLocation, Size size)
 	Assert(size == MAXALIGN(size));
 	Assert(undoType != UndoLogNone);
 
+	o_stat_global_count(OStatUndoBytes, size);
 	set_my_reserved_location(undoType);
 
 	pg_write_barrier();
@@ -1302,7 +1308,10 @@ undo_xact_callback(XactEvent event, void *arg)
 	ea_counters = NULL;
 
 	if (event == XACT_EVENT_COMMIT || event == XACT_EVENT_ABORT)
+	{
 		seq_scans_cleanup();
+		o_detoast_reset_row();
+	}
 
 	if (!OXidIsValid(oxid) || isParallelWorker)
 	{
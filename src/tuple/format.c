@@ -158,6 +158,141 @@ o_tuple_read_next_field(OTupleReaderState *state, bool *isnull)
 	return fetchatt(att, state->tp + off);
 }
 
+/*
+ * Builds the deforming program for the tuple descriptor.  The program is
+ * allocated in the current memory context.
+ */
+OTupleDeformProgram *
+o_tuple_deform_program_build(TupleDesc desc)
+{
+	OTupleDeformProgram *program;
+	int32		off = 0;
+	int			i;
+
+	program = (OTupleDeformProgram *) palloc(offsetof(OTupleDeformProgram, steps) +
+											 sizeof(OTupleDeformStep) * desc->natts);
+	program->natts = desc->natts;
+
+	for (i = 0; i < desc->natts; i++)
+	{
+		Form_pg_attribute att = TupleDescAttr(desc, i);
+		OTupleDeformStep *step = &program->steps[i];
+
+		step->attlen = att->attlen;
+		step->attbyval = att->attbyval;
+		step->alignto = (uint8) att_align_nominal(1, att->attalign);
+
+		/*
+		 * The same rules as o_tuple_next_field_offset() uses for attcacheoff:
+		 * offsets are known until the first variable-length value, which
+		 * itself has known offset only if it doesn't need alignment.  Also
+		 * fill attcacheoff the same way as readers do.
+		 */
+		if (off < 0)
+			step->fixedoff = -1;
+		else if (att->attlen > 0)
+		{
+			off = att_align_nominal(off, att->attalign);
+			step->fixedoff = off;
+			off += att->attlen;
+		}
+		else
+		{
+			if (att->attlen == -1 && off == att_align_nominal(off, att->attalign))
+				step->fixedoff = off;
+			else
+				step->fixedoff = -1;
+			off = -1;
+		}
+
+		if (step->fixedoff >= 0)
+			att->attcacheoff = step->fixedoff;
+	}
+
+	return program;
+}
+
+/*
+ * Reads next 'count' fields of the tuple into 'values' and 'isnull' arrays
+ * using the precomputed program.  Gives the same result as the sequence of
+ * o_tuple_read_next_field() calls, but avoids per-attribute lookups into the
+ * tuple descriptor.  Returns true if any of the fields is an in-tuple TOAST
+ * pointer.
+ */
+bool
+o_tuple_deform(OTupleDeformProgram *program, OTupleReaderState *state,
+			   int count, Datum *values, bool *isnull)
+{
+	char	   *tp = state->tp;
+	uint32		off = state->off;
+	bool		slow = state->slow;
+	bool		hastoast = false;
+	int			attnum = state->attnum;
+	int			natts = Min(state->natts, program->natts);
+	int			i;
+
+	Assert(state->desc->natts == program->natts);
+
+	for (i = 0; i < count && attnum < natts; i++, attnum++)
+	{
+		OTupleDeformStep *step = &program->steps[attnum];
+		char	   *ptr;
+
+		if (state->hasnulls && att_isnull(attnum, state->bp))
+		{
+			values[i] = (Datum) 0;
+			isnull[i] = true;
+			slow = true;
+			continue;
+		}
+		isnull[i] = false;
+
+		if (!slow && step->fixedoff >= 0)
+			off = step->fixedoff;
+		else if (step->attlen == -1)
+		{
+			/* see att_align_pointer(): no padding before short varlena */
+			if (!VARATT_NOT_PAD_BYTE(tp + off))
+				off = TYPEALIGN(step->alignto, off);
+		}
+		else
+			off = TYPEALIGN(step->alignto, off);
+
+		ptr = tp + off;
+
+		if (step->attlen > 0)
+		{
+			values[i] = step->attbyval ? fetch_att(ptr, true, step->attlen) :
+				PointerGetDatum(ptr);
+			off += step->attlen;
+			continue;
+		}
+
+		values[i] = PointerGetDatum(ptr);
+		if (IS_TOAST_POINTER(ptr))
+		{
+			if (!VARATT_IS_EXTERNAL_ORIOLEDB(ptr))
+				hastoast = true;
+			off += sizeof(OToastValue);
+		}
+		else if (step->attlen == -1)
+			off += VARSIZE_ANY(ptr);
+		else
+			off += strlen(ptr) + 1;
+		slow = true;
+	}
+
+	state->off = off;
+	state->slow = slow;
+	state->attnum = attnum;
+
+	/* the rest of fields are missing in the tuple */
+	for (; i < count; i++)
+		values[i] = o_tuple_read_next_field(state, &isnull[i]);
+
+	return hastoast;
+}
+
 static Pointer
 o_tuple_read_next_field_ptr(OTupleReaderState *state)
 {
@@ -836,3 +971,268 @@ o_tuple_set_ctid(OTuple tuple, ItemPointer iptr)
 		*((ItemPointer) (data + SizeOfOTupleHeader)) = *iptr;
 	}
 }
+
+/*
+ * Fills pointers to raw values of tuple attributes and their lengths.  NULL
+ * pointer stands for null value.  Returns the number of attributes
+ * physically present in the tuple.
+ */
+static int
+o_tuple_get_raw_fields(TupleDesc desc, OTupleFixedFormatSpec *spec,
+					   OTuple tuple, Pointer *ptrs, uint16 *lens)
+{
+	OTupleReaderState state;
+	int			natts;
+	int			i;
+
+	o_tuple_init_reader(&state, tuple, desc, spec);
+	natts = Min(state.natts, desc->natts);
+
+	for (i = 0; i < natts; i++)
+	{
+		uint32		off;
+
+		if (state.hasnulls && att_isnull(i, state.bp))
+		{
+			ptrs[i] = NULL;
+			lens[i] = 0;
+			state.slow = true;
+			state.attnum++;
+			continue;
+		}
+
+		off = o_tuple_next_field_offset(&state, TupleDescAttr(desc, i));
+		ptrs[i] = state.tp + off;
+		lens[i] = state.off - off;
+	}
+
+	return natts;
+}
+
+/*
+ * Aligns the offset of raw attribute value the same way o_tuple_fill() does.
+ * Short varlenas including TOAST pointers are never aligned.
+ */
+static inline uint32
+o_tuple_align_raw_field(Form_pg_attribute att, Pointer ptr, uint32 off)
+{
+	if (att->attlen > 0 ||
+		(att->attlen == -1 && !VARATT_IS_1B(ptr)))
+		return att_align_nominal(off, att->attalign);
+	return off;
+}
+
+/*
+ * Writes the delta of newTuple relative to oldTuple into the buffer of
+ * maxLen bytes.  Attributes are compared by their raw values, so TOAST
+ * pointers are copied as is.  Returns the length of the delta or -1 if it
+ * doesn't fit the buffer.
+ */
+int
+o_tuple_make_delta(TupleDesc desc, OTupleFixedFormatSpec *spec,
+				   OTuple oldTuple, OTuple newTuple,
+				   Pointer delta, int maxLen)
+{
+	OTupleDeltaHeader header;
+	Pointer    *oldPtrs,
+			   *newPtrs;
+	uint16	   *oldLens,
+			   *newLens;
+	bits8	   *changed,
+			   *notnull;
+	int			oldNatts,
+				newNatts,
+				bitmapLen,
+				len,
+				i;
+
+	oldPtrs = (Pointer *) palloc(sizeof(Pointer) * desc->natts);
+	newPtrs = (Pointer *) palloc(sizeof(Pointer) * desc->natts);
+	oldLens = (uint16 *) palloc(sizeof(uint16) * desc->natts);
+	newLens = (uint16 *) palloc(sizeof(uint16) * desc->natts);
+
+	oldNatts = o_tuple_get_raw_fields(desc, spec, oldTuple, oldPtrs, oldLens);
+	newNatts = o_tuple_get_raw_fields(desc, spec, newTuple, newPtrs, newLens);
+
+	bitmapLen = BITMAPLEN(newNatts);
+	len = sizeof(OTupleDeltaHeader) + 2 * bitmapLen;
+	if (len > maxLen)
+	{
+		len = -1;
+		goto done;
+	}
+
+	changed = (bits8 *) (delta + sizeof(OTupleDeltaHeader));
+	notnull = changed + bitmapLen;
+	memset(changed, 0, 2 * bitmapLen);
+
+	for (i = 0; i < newNatts; i++)
+	{
+		if (i < oldNatts)
+		{
+			if (oldPtrs[i] == NULL && newPtrs[i] == NULL)
+				continue;
+			if (oldPtrs[i] != NULL && newPtrs[i] != NULL &&
+				oldLens[i] == newLens[i] &&
+				memcmp(oldPtrs[i], newPtrs[i], newLens[i]) == 0)
+				continue;
+		}
+
+		changed[i >> 3] |= 1 << (i & 0x07);
+		if (newPtrs[i] == NULL)
+			continue;
+
+		notnull[i >> 3] |= 1 << (i & 0x07);
+		if (len + sizeof(uint16) + newLens[i] > maxLen)
+		{
+			len = -1;
+			goto done;
+		}
+		memcpy(delta + len, &newLens[i], sizeof(uint16));
+		len += sizeof(uint16);
+		memcpy(delta + len, newPtrs[i], newLens[i]);
+		len += newLens[i];
+	}
+
+	header.version = o_tuple_get_version(newTuple);
+	header.natts = newNatts;
+	header.len = len;
+	memcpy(delta, &header, sizeof(OTupleDeltaHeader));
+
+done:
+	pfree(oldPtrs);
+	pfree(newPtrs);
+	pfree(oldLens);
+	pfree(newLens);
+
+	return len;
+}
+
+int
+o_tuple_delta_length(Pointer delta)
+{
+	OTupleDeltaHeader header;
+
+	memcpy(&header, delta, sizeof(OTupleDeltaHeader));
+	return header.len;
+}
+
+/*
+ * Forms the new tuple from the base tuple and the delta made by
+ * o_tuple_make_delta().  Unchanged attributes are copied from the base tuple.
+ */
+OTuple
+o_tuple_apply_delta(TupleDesc desc, OTupleFixedFormatSpec *spec,
+					OTuple base, Pointer delta)
+{
+	OTupleDeltaHeader header;
+	OTuple		result;
+	Pointer    *ptrs;
+	uint16	   *lens;
+	bits8	   *changed,
+			   *notnull;
+	Pointer		ptr;
+	int			baseNatts,
+				bitmapLen,
+				i;
+	uint32		hoff,
+				off;
+	bool		hasnull = false;
+
+	memcpy(&header, delta, sizeof(OTupleDeltaHeader));
+	Assert(header.natts <= desc->natts);
+
+	ptrs = (Pointer *) palloc(sizeof(Pointer) * desc->natts);
+	lens = (uint16 *) palloc(sizeof(uint16) * desc->natts);
+	baseNatts = o_tuple_get_raw_fields(desc, spec, base, ptrs, lens);
+
+	bitmapLen = BITMAPLEN(header.natts);
+	changed = (bits8 *) (delta + sizeof(OTupleDeltaHeader));
+	notnull = changed + bitmapLen;
+	ptr = (Pointer) (notnull + bitmapLen);
+
+	for (i = 0; i < header.natts; i++)
+	{
+		if (changed[i >> 3] & (1 << (i & 0x07)))
+		{
+			if (notnull[i >> 3] & (1 << (i & 0x07)))
+			{
+				memcpy(&lens[i], ptr, sizeof(uint16));
+				ptr += sizeof(uint16);
+				ptrs[i] = ptr;
+				ptr += lens[i];
+			}
+			else
+			{
+				ptrs[i] = NULL;
+				lens[i] = 0;
+			}
+		}
+		else if (i >= baseNatts)
+			elog(ERROR, "attribute %d is missing in both tuple and its delta",
+				 i + 1);
+
+		if (ptrs[i] == NULL)
+			hasnull = true;
+	}
+	Assert(ptr == delta + header.len);
+
+	if (header.version == 0 && !hasnull && header.natts == spec->natts)
+	{
+		hoff = 0;
+		result.formatFlags = O_TUPLE_FLAGS_FIXED_FORMAT;
+	}
+	else
+	{
+		hoff = SizeOfOTupleHeader;
+		if (hasnull)
+			hoff += MAXALIGN(BITMAPLEN(header.natts));
+		result.formatFlags = 0;
+	}
+
+	off = 0;
+	for (i = 0; i < header.natts; i++)
+	{
+		if (ptrs[i] == NULL)
+			continue;
+		off = o_tuple_align_raw_field(TupleDescAttr(desc, i), ptrs[i], off);
+		off += lens[i];
+	}
+
+	result.data = (Pointer) palloc0(hoff + off);
+
+	if (!(result.formatFlags & O_TUPLE_FLAGS_FIXED_FORMAT))
+	{
+		OTupleHeader tup = (OTupleHeader) result.data;
+
+		tup->hasnulls = hasnull;
+		tup->len = hoff + off;
+		tup->natts = header.natts;
+		tup->version = header.version;
+		if (hasnull)
+		{
+			bits8	   *bp = (bits8 *) (result.data + SizeOfOTupleHeader);
+
+			for (i = 0; i < header.natts; i++)
+			{
+				if (ptrs[i] != NULL)
+					bp[i >> 3] |= 1 << (i & 0x07);
+			}
+		}
+	}
+
+	off = 0;
+	for (i = 0; i < header.natts; i++)
+	{
+		if (ptrs[i] == NULL)
+			continue;
+		off = o_tuple_align_raw_field(TupleDescAttr(desc, i), ptrs[i], off);
+		memcpy(result.data + hoff + off, ptrs[i], lens[i]);
+		off += lens[i];
+	}
+
+	pfree(ptrs);
+	pfree(lens);
+
+	return result;
+}
@@ -294,8 +294,33 @@ tts_orioledb_getsomeattrs(TupleTableSlot *slot, int __natts)
 		natts = oslot->state.desc->natts;
 	}
 
+	/*
+	 * Table attributes of the primary index leaf tuple go in the tuple
+	 * order.  So deform them using the precomputed program of the leaf
+	 * tuple descriptor.
+	 */
+	attnum = slot->tts_nvalid;
+	if (oslot->ixnum == PrimaryIndexNumber && oslot->leafTuple &&
+		!index_order)
+	{
+		OTupleDeformProgram *program = o_index_get_leaf_deform(idx);
+
+		hastoast = o_tuple_deform(program, &oslot->state, natts - attnum,
+								  &values[attnum], &isnull[attnum]);
+
+		/* We need primary key values to make TOAST pointers */
+		if (hastoast && natts < idx->maxTableAttnum - ctid_off)
+		{
+			attnum = natts;
+			natts = idx->maxTableAttnum - ctid_off;
+			(void) o_tuple_deform(program, &oslot->state, natts - attnum,
+								  &values[attnum], &isnull[attnum]);
+		}
+		attnum = natts;
+	}
+
 	/* Iterate over the attributes to populate values and null flags. */
-	for (attnum = slot->tts_nvalid; attnum < natts; attnum++)
+	for (; attnum < natts; attnum++)
 	{
 		Form_pg_attribute thisatt;
 		int			res_attnum;
@@ -391,6 +416,8 @@ tts_orioledb_getsomeattrs(TupleTableSlot *slot, int __natts)
 	if (hastoast)
 	{
 		OTuple		pkey;
+		struct varlena **rowAttrs;
+		int			nrowAttrs = 0;
 
 		/* Allocate memory for TOASTed attributes if not already done. */
 		if (!oslot->to_toast)
@@ -402,6 +429,8 @@ tts_orioledb_getsomeattrs(TupleTableSlot *slot, int __natts)
 		else
 			pkey = make_key_from_secondary_slot(slot, idx, descr);
 
+		rowAttrs = (struct varlena **) palloc(sizeof(struct varlena *) * natts);
+
 		/* Iterate over attributes to process TOASTed values. */
 		for (attnum = 0; attnum < natts; attnum++)
 		{
@@ -425,12 +454,25 @@ tts_orioledb_getsomeattrs(TupleTableSlot *slot, int __natts)
 															 oslot->csn);
 					oslot->vfree[attnum] = true;
 					MemoryContextSwitchTo(mcxt);
+
+					if (attnum < __natts && COMMITSEQNO_IS_NORMAL(oslot->csn))
+						rowAttrs[nrowAttrs++] = (struct varlena *) DatumGetPointer(values[attnum]);
 				}
 			}
 		}
+
+		/*
+		 * Let the requested TOASTed values of the row be fetched in a single
+		 * TOAST tree pass once the first of them is detoasted.
+		 */
+		o_detoast_set_row(rowAttrs, nrowAttrs);
+
 		/* Free the primary key memory except for bump context */
 		if (!is_bump_memory_context(CurrentMemoryContext))
+		{
 			pfree(pkey.data);
+			pfree(rowAttrs);
+		}
 	}
 
 	/* Ensure the number of processed attributes matches the expected count. */
@@ -643,16 +685,60 @@ tts_orioledb_materialize(TupleTableSlot *slot)
 	}
 }
 
+/*
+ * Detoasts OrioleDB TOAST pointers of the given slot attributes.  Values of
+ * the same row are fetched in a single pass over the TOAST tree.  Results are
+ * allocated in the slot memory context.
+ */
+static void
+tts_orioledb_fetch_toasted(TupleTableSlot *slot, int *attnums, int n,
+						   Datum *result)
+{
+	struct varlena **attrs;
+	struct varlena **fetched;
+	MemoryContext mcxt;
+	int			i;
+
+	mcxt = MemoryContextSwitchTo(slot->tts_mcxt);
+	attrs = (struct varlena **) palloc(sizeof(struct varlena *) * n * 2);
+	fetched = attrs + n;
+	for (i = 0; i < n; i++)
+		attrs[i] = (struct varlena *) DatumGetPointer(slot->tts_values[attnums[i]]);
+
+	o_detoast_batch(attrs, fetched, n);
+
+	for (i = 0; i < n; i++)
+	{
+		Datum		value = PointerGetDatum(fetched[i]);
+
+		if (fetched[i] == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("failed to fetch TOASTed value of attribute %d",
+							attnums[i] + 1)));
+
+		/* decompress the value if needed */
+		result[i] = PointerGetDatum(PG_DETOAST_DATUM(value));
+		if (result[i] != value)
+			pfree(fetched[i]);
+	}
+	pfree(attrs);
+	MemoryContextSwitchTo(mcxt);
+}
+
 void
 tts_orioledb_detoast(TupleTableSlot *slot)
 {
 	OTableSlot *oslot = (OTableSlot *) slot;
 	TupleDesc	tupleDesc = slot->tts_tupleDescriptor;
 	int			natts = tupleDesc->natts;
+	int		   *batch;
+	int			nbatch = 0;
 	int			i;
 
 	slot_getallattrs(slot);
 
+	batch = (int *) palloc(sizeof(int) * natts);
 	for (i = 0; i < natts; i++)
 	{
 		Form_pg_attribute att = TupleDescAttr(tupleDesc, i);
@@ -666,6 +752,13 @@ tts_orioledb_detoast(TupleTableSlot *slot)
 			if (!oslot->vfree)
 				alloc_to_toast_vfree_detoasted(slot);
 
+			/* OrioleDB TOASTed values are fetched below all at once */
+			if (VARATT_IS_EXTERNAL_ORIOLEDB(DatumGetPointer(slot->tts_values[i])))
+			{
+				batch[nbatch++] = i;
+				continue;
+			}
+
 			mctx = MemoryContextSwitchTo(slot->tts_mcxt);
 			tmp = PointerGetDatum(PG_DETOAST_DATUM(slot->tts_values[i]));
 			MemoryContextSwitchTo(mctx);
@@ -676,6 +769,24 @@ tts_orioledb_detoast(TupleTableSlot *slot)
 			oslot->vfree[i] = true;
 		}
 	}
+
+	if (nbatch > 0)
+	{
+		Datum	   *detoasted = (Datum *) palloc(sizeof(Datum) * nbatch);
+
+		tts_orioledb_fetch_toasted(slot, batch, nbatch, detoasted);
+		for (i = 0; i < nbatch; i++)
+		{
+			int			attnum = batch[i];
+
+			if (oslot->vfree[attnum])
+				pfree(DatumGetPointer(slot->tts_values[attnum]));
+			slot->tts_values[attnum] = detoasted[i];
+			oslot->vfree[attnum] = true;
+		}
+		pfree(detoasted);
+	}
+	pfree(batch);
 }
 
 static void
@@ -942,9 +1053,51 @@ tts_orioledb_get_index_values(TupleTableSlot *slot, OIndexDescr *idx,
 	int			natts = tupleDesc->natts;
 	int			i;
 	ListCell   *indexpr_item = list_head(idx->expressions_state);
+	OTableSlot *oSlot = (OTableSlot *) slot;
+	int			batch[2 * INDEX_MAX_KEYS];
+	int			nbatch = 0;
 
 	Assert(natts <= 2 * INDEX_MAX_KEYS);
 
+	/*
+	 * Fetch OrioleDB TOASTed values of the index fields at once, so that
+	 * get_tbl_att() finds them already detoasted.
+	 */
+	for (i = 0; i < natts; i++)
+	{
+		int			attnum = idx->fields[i].tableAttnum;
+		Form_pg_attribute att;
+		int			j;
+
+		if (attnum == EXPR_ATTNUM || (idx->primaryIsCtid && attnum == 1))
+			continue;
+		attnum -= idx->primaryIsCtid ? 2 : 1;
+
+		att = TupleDescAttr(slot->tts_tupleDescriptor, attnum);
+		if (slot->tts_isnull[attnum] || att->attlen >= 0 ||
+			!VARATT_IS_EXTERNAL_ORIOLEDB(DatumGetPointer(slot->tts_values[attnum])) ||
+			(oSlot->detoasted && oSlot->detoasted[attnum]))
+			continue;
+
+		for (j = 0; j < nbatch; j++)
+			if (batch[j] == attnum)
+				break;
+		if (j == nbatch)
+			batch[nbatch++] = attnum;
+	}
+
+	if (nbatch > 1)
+	{
+		Datum		detoasted[2 * INDEX_MAX_KEYS];
+
+		if (!oSlot->to_toast)
+			alloc_to_toast_vfree_detoasted(slot);
+
+		tts_orioledb_fetch_toasted(slot, batch, nbatch, detoasted);
+		for (i = 0; i < nbatch; i++)
+			oSlot->detoasted[batch[i]] = detoasted[i];
+	}
+
 	for (i = 0; i < natts; i++)
 	{
 		int			attnum = idx->fields[i].tableAttnum;
@@ -31,6 +31,7 @@
 #include "catalog/pg_type.h"
 #include "utils/builtins.h"
 #include "miscadmin.h"
+#include "utils/memutils.h"
 
 typedef struct
 {
@@ -197,6 +198,107 @@ o_toast_needs_undo(BTreeDescr *desc, BTreeOperationType action,
 }
 
 
+/*
+ * OrioleDB TOAST pointers of the row last deformed by a table slot.  The first
+ * of them to be detoasted fetches the values of all of them in one pass, the
+ * rest are served from the fetched values.
+ */
+static MemoryContext detoastRowCxt = NULL;
+static struct varlena **detoastRowAttrs = NULL;
+static struct varlena **detoastRowValues = NULL;
+static int	detoastRowNattrs = 0;
+static bool detoastRowFetched = false;
+
+/*
+ * Remembers TOAST pointers of the row for o_detoast().  Pointers of the
+ * previous row are forgotten.
+ */
+void
+o_detoast_set_row(struct varlena **attrs, int n)
+{
+	MemoryContext mcxt;
+	int			i;
+
+	if (detoastRowCxt == NULL)
+		detoastRowCxt = AllocSetContextCreate(TopMemoryContext,
+											  "orioledb detoast row",
+											  ALLOCSET_DEFAULT_SIZES);
+	else
+		MemoryContextReset(detoastRowCxt);
+
+	detoastRowNattrs = 0;
+	detoastRowFetched = false;
+
+	/* nothing to batch */
+	if (n < 2)
+		return;
+
+	mcxt = MemoryContextSwitchTo(detoastRowCxt);
+	detoastRowAttrs = (struct varlena **) palloc(sizeof(struct varlena *) * n);
+	detoastRowValues = (struct varlena **) palloc0(sizeof(struct varlena *) * n);
+	for (i = 0; i < n; i++)
+	{
+		Size		size = VARSIZE_ANY(attrs[i]);
+
+		Assert(VARATT_IS_EXTERNAL_ORIOLEDB(attrs[i]));
+		detoastRowAttrs[i] = (struct varlena *) palloc(size);
+		memcpy(detoastRowAttrs[i], attrs[i], size);
+	}
+	MemoryContextSwitchTo(mcxt);
+	detoastRowNattrs = n;
+}
+
+/*
+ * Forgets TOAST pointers of the row and frees their fetched values.
+ */
+void
+o_detoast_reset_row(void)
+{
+	if (detoastRowCxt != NULL)
+		MemoryContextReset(detoastRowCxt);
+	detoastRowNattrs = 0;
+	detoastRowFetched = false;
+}
+
+/*
+ * Looks for the value in the row given to o_detoast_set_row().  Returns its
+ * copy or NULL if the pointer doesn't belong to the row.
+ */
+static struct varlena *
+o_detoast_from_row(struct varlena *attr)
+{
+	Size		size = VARSIZE_ANY(attr);
+	struct varlena *result;
+	int			i;
+
+	for (i = 0; i < detoastRowNattrs; i++)
+	{
+		if (VARSIZE_ANY(detoastRowAttrs[i]) == size &&
+			memcmp(detoastRowAttrs[i], attr, size) == 0)
+			break;
+	}
+
+	if (i >= detoastRowNattrs)
+		return NULL;
+
+	if (!detoastRowFetched)
+	{
+		MemoryContext mcxt = MemoryContextSwitchTo(detoastRowCxt);
+
+		o_detoast_batch(detoastRowAttrs, detoastRowValues, detoastRowNattrs);
+		MemoryContextSwitchTo(mcxt);
+		detoastRowFetched = true;
+	}
+
+	if (detoastRowValues[i] == NULL)
+		return NULL;
+
+	size = VARSIZE_ANY(detoastRowValues[i]);
+	result = (struct varlena *) palloc(size);
+	memcpy(result, detoastRowValues[i], size);
+	return result;
+}
+
 struct varlena *
 o_detoast(struct varlena *attr)
 {
@@ -206,6 +308,14 @@ o_detoast(struct varlena *attr)
 	OFixedKey	key;
 	OSnapshot	oSnapshot;
 
+	if (detoastRowNattrs > 0)
+	{
+		struct varlena *result = o_detoast_from_row(attr);
+
+		if (result)
+			return result;
+	}
+
 	memcpy(&ote, VARDATA_EXTERNAL(attr), O_TOAST_EXTERNAL_SZ);
 	oids.datoid = ote.datoid;
 	oids.reloid = ote.relid;
@@ -226,6 +336,170 @@ o_detoast(struct varlena *attr)
 										  ote.toasted_size, &oSnapshot);
 }
 
+/*
+ * OrioleDB TOAST pointer prepared for batched detoasting.
+ */
+typedef struct
+{
+	OToastExternal ote;
+	Pointer		pkData;
+	int			index;
+} ODetoastItem;
+
+#define O_TOAST_EXTERNAL_PK_FLAGS(ote) \
+	((ote).formatFlags & ((1 << ORIOLEDB_EXT_FORMAT_FLAGS_BITS) - 1))
+
+/*
+ * Compares TOAST pointers by the table row they belong to.
+ */
+static int
+detoast_item_row_cmp(const ODetoastItem *item1, const ODetoastItem *item2)
+{
+	const OToastExternal *ote1 = &item1->ote;
+	const OToastExternal *ote2 = &item2->ote;
+
+	if (ote1->datoid != ote2->datoid)
+		return ote1->datoid < ote2->datoid ? -1 : 1;
+	if (ote1->relid != ote2->relid)
+		return ote1->relid < ote2->relid ? -1 : 1;
+	if (ote1->relnode != ote2->relnode)
+		return ote1->relnode < ote2->relnode ? -1 : 1;
+	if (ote1->csn != ote2->csn)
+		return ote1->csn < ote2->csn ? -1 : 1;
+	if (O_TOAST_EXTERNAL_PK_FLAGS(*ote1) != O_TOAST_EXTERNAL_PK_FLAGS(*ote2))
+		return O_TOAST_EXTERNAL_PK_FLAGS(*ote1) <
+			O_TOAST_EXTERNAL_PK_FLAGS(*ote2) ? -1 : 1;
+	if (ote1->data_size != ote2->data_size)
+		return ote1->data_size < ote2->data_size ? -1 : 1;
+	return memcmp(item1->pkData, item2->pkData, ote1->data_size);
+}
+
+/*
+ * Sorts TOAST pointers in the TOAST tree order within each row.
+ */
+static int
+detoast_item_cmp(const void *p1, const void *p2)
+{
+	const ODetoastItem *item1 = (const ODetoastItem *) p1;
+	const ODetoastItem *item2 = (const ODetoastItem *) p2;
+	int			cmp;
+
+	cmp = detoast_item_row_cmp(item1, item2);
+	if (cmp != 0)
+		return cmp;
+	if (item1->ote.attnum != item2->ote.attnum)
+		return item1->ote.attnum < item2->ote.attnum ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Batched version of o_detoast().  Pointers of the same row are fetched in
+ * a single ordered pass over the TOAST tree, and the table descriptor is
+ * looked up once per table.  Results are placed into 'results' in the order
+ * of 'attrs'.
+ */
+void
+o_detoast_batch(struct varlena **attrs, struct varlena **results, int n)
+{
+	ODetoastItem *items;
+	uint16	   *attnums;
+	Size	   *sizes;
+	Pointer    *data;
+	int		   *unique;
+	OTableDescr *descr = NULL;
+	int			start,
+				end,
+				i;
+
+	if (n <= 0)
+		return;
+
+	items = (ODetoastItem *) palloc(sizeof(ODetoastItem) * n);
+	attnums = (uint16 *) palloc(sizeof(uint16) * n);
+	sizes = (Size *) palloc(sizeof(Size) * n);
+	data = (Pointer *) palloc(sizeof(Pointer) * n);
+	unique = (int *) palloc(sizeof(int) * n);
+
+	for (i = 0; i < n; i++)
+	{
+		Assert(VARATT_IS_EXTERNAL_ORIOLEDB(attrs[i]));
+		memcpy(&items[i].ote, VARDATA_EXTERNAL(attrs[i]), O_TOAST_EXTERNAL_SZ);
+		items[i].pkData = VARDATA_EXTERNAL(attrs[i]) + O_TOAST_EXTERNAL_SZ;
+		items[i].index = i;
+	}
+
+	if (n > 1)
+		qsort(items, n, sizeof(ODetoastItem), detoast_item_cmp);
+
+	for (start = 0; start < n; start = end)
+	{
+		OToastExternal *ote = &items[start].ote;
+		OFixedKey	key;
+		OSnapshot	oSnapshot;
+		int			nunique = 0;
+
+		if (!descr ||
+			descr->oids.datoid != ote->datoid ||
+			descr->oids.reloid != ote->relid ||
+			descr->oids.relnode != ote->relnode)
+		{
+			ORelOids	oids;
+
+			oids.datoid = ote->datoid;
+			oids.reloid = ote->relid;
+			oids.relnode = ote->relnode;
+			descr = o_fetch_table_descr(oids);
+			Assert(descr);
+			o_btree_load_shmem(&descr->toast->desc);
+		}
+
+		/* Collect distinct attributes of the same row */
+		for (end = start; end < n; end++)
+		{
+			if (end > start &&
+				detoast_item_row_cmp(&items[start], &items[end]) != 0)
+				break;
+
+			if (nunique == 0 || attnums[nunique - 1] != items[end].ote.attnum)
+			{
+				attnums[nunique] = items[end].ote.attnum;
+				sizes[nunique] = items[end].ote.toasted_size;
+				nunique++;
+			}
+			unique[end] = nunique - 1;
+		}
+
+		key.tuple.formatFlags = ote->formatFlags;
+		key.tuple.data = key.fixedData;
+		memcpy(key.fixedData, items[start].pkData, ote->data_size);
+		O_LOAD_SNAPSHOT_CSN(&oSnapshot, ote->csn);
+
+		o_toast_get_batch(GET_PRIMARY(descr), descr->toast, key.tuple,
+						  nunique, attnums, sizes, data, &oSnapshot);
+
+		for (i = start; i < end; i++)
+		{
+			Pointer		value = data[unique[i]];
+
+			/* The same value may be requested more than once */
+			if (i > start && unique[i] == unique[i - 1] && value)
+			{
+				Pointer		copy = palloc(sizes[unique[i]]);
+
+				memcpy(copy, value, sizes[unique[i]]);
+				value = copy;
+			}
+			results[items[i].index] = (struct varlena *) value;
+		}
+	}
+
+	pfree(items);
+	pfree(attnums);
+	pfree(sizes);
+	pfree(data);
+	pfree(unique);
+}
+
 static BTreeDescr *
 tableGetBTreeDesc(void *arg)
 {
@@ -691,12 +965,15 @@ generic_toast_delete(ToastAPI *api, void *key, OXid oxid, CommitSeqNo csn,
 	return generic_toast_delete_optional_wal(api, key, oxid, csn, arg, true);
 }
 
-Pointer
-generic_toast_get(ToastAPI *api, void *key, Size data_size,
-				  OSnapshot *o_snapshot, void *arg)
+/*
+ * Reads the chunks of the value identified by 'key' starting from the current
+ * iterator position.  Returns NULL if the value size doesn't match
+ * 'data_size'.
+ */
+static Pointer
+generic_toast_read_value(ToastAPI *api, BTreeIterator *it, void *key,
+						 Size data_size, void *arg)
 {
-	BTreeDescr *desc = api->getBTreeDesc(arg);
-	BTreeIterator *it;
 	void	   *nextKey;
 	int			max_length = api->getMaxChunkSize(key, arg);
 	int			actual_size;
@@ -704,11 +981,6 @@ generic_toast_get(ToastAPI *api, void *key, Size data_size,
 
 	nextKey = api->getNextKey(key, arg);
 
-	it = o_btree_iterator_create(desc, key, BTreeKeyBound,
-								 o_snapshot, ForwardScanDirection);
-	if (api->versionCallback)
-		o_btree_iterator_set_callback(it, api->versionCallback, (void *) key);
-
 	data = palloc(data_size);
 	actual_size = 0;
 
@@ -745,8 +1017,6 @@ generic_toast_get(ToastAPI *api, void *key, Size data_size,
 		Assert(actual_size <= data_size);
 	} while (true);
 
-	btree_iterator_free(it);
-
 	Assert(actual_size == data_size);
 	if (actual_size != data_size)
 	{
@@ -756,6 +1026,26 @@ generic_toast_get(ToastAPI *api, void *key, Size data_size,
 	return data;
 }
 
+Pointer
+generic_toast_get(ToastAPI *api, void *key, Size data_size,
+				  OSnapshot *o_snapshot, void *arg)
+{
+	BTreeDescr *desc = api->getBTreeDesc(arg);
+	BTreeIterator *it;
+	Pointer		data;
+
+	it = o_btree_iterator_create(desc, key, BTreeKeyBound,
+								 o_snapshot, ForwardScanDirection);
+	if (api->versionCallback)
+		o_btree_iterator_set_callback(it, api->versionCallback, (void *) key);
+
+	data = generic_toast_read_value(api, it, key, data_size, arg);
+
+	btree_iterator_free(it);
+
+	return data;
+}
+
 /*
  * Common code for
  * generic_toast_get_any_with_callback and generic_toast_get_any_with_key
@@ -947,6 +1237,51 @@ o_toast_get(OIndexDescr *primary, OIndexDescr *toast,
 	return result;
 }
 
+/*
+ * Fetches several TOASTed attributes of the same primary key using a single
+ * TOAST tree iterator.  'attnums' must be sorted in ascending order without
+ * duplicates.  The iterator is repositioned to each attribute, so chunks of
+ * other attributes aren't read.  Fills 'results' with the fetched values, or
+ * NULLs for values whose size doesn't match the expected one.
+ */
+void
+o_toast_get_batch(OIndexDescr *primary, OIndexDescr *toast, OTuple pk,
+				  int nattrs, uint16 *attnums, Size *data_sizes,
+				  Pointer *results, OSnapshot *o_snapshot)
+{
+	OToastKey	tkey;
+	OTableToastArg arg = {primary, toast};
+	BTreeIterator *it;
+	int			i;
+
+	Assert(toast->desc.type == oIndexToast);
+	Assert(nattrs > 0);
+
+	tkey.pk_tuple = pk;
+	tkey.attnum = attnums[0];
+	tkey.chunknum = 0;
+
+	it = o_btree_iterator_create(&toast->desc, &tkey, BTreeKeyBound,
+								 o_snapshot, ForwardScanDirection);
+	o_btree_iterator_set_callback(it, tableVersionCallback, (void *) &tkey);
+
+	for (i = 0; i < nattrs; i++)
+	{
+		if (i > 0)
+		{
+			Assert(attnums[i] > attnums[i - 1]);
+			tkey.attnum = attnums[i];
+			tkey.chunknum = 0;
+			o_btree_iterator_seek(it, &tkey, BTreeKeyBound);
+		}
+
+		results[i] = generic_toast_read_value(&tableToastAPI, it, &tkey,
+											  data_sizes[i], &arg);
+	}
+
+	btree_iterator_free(it);
+}
+
 static OTuple
 o_create_toast_tuple(OToastKey tkey, Pointer data_ptr, Size data_length,
 					 OTableToastArg *arg)
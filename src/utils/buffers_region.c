@@ -0,0 +1,290 @@
+/*-------------------------------------------------------------------------
+ *
+ * buffers_region.c
+ *		Separately allocated region of orioledb page buffers.
+ *
+ * By default page buffers of all the orioledb page pools reside in the main
+ * shared memory segment.  When orioledb.buffers_huge_pages or
+ * orioledb.buffers_numa is set, the buffers are allocated in a separate
+ * anonymous shared mapping instead.  The mapping might use explicit huge
+ * pages of the given size independently of the core huge_pages setting, and
+ * might have a NUMA memory policy applied before the buffers are touched
+ * first time.
+ *
+ * The region is created by postmaster once and inherited by its children.
+ * It survives the reinitialization of the shared memory after a backend
+ * crash.  EXEC_BACKEND builds don't support it.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/src/utils/buffers_region.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include "orioledb.h"
+
+#include "utils/buffers_region.h"
+
+#include "storage/fd.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT		26
+#endif
+
+/* NUMA memory policies, see mbind(2) */
+#define O_MPOL_BIND			2
+#define O_MPOL_INTERLEAVE	3
+
+#define O_MAX_NUMA_NODES	1024
+#define O_NUMA_MASK_WORDS	(O_MAX_NUMA_NODES / (8 * sizeof(unsigned long)))
+
+const struct config_enum_entry buffers_huge_pages_options[] = {
+	{"off", OBuffersHugePagesOff, false},
+	{"try", OBuffersHugePagesTry, false},
+	{"on", OBuffersHugePagesOn, false},
+	{"false", OBuffersHugePagesOff, true},
+	{"true", OBuffersHugePagesOn, true},
+	{NULL, 0, false}
+};
+
+const struct config_enum_entry buffers_numa_options[] = {
+	{"off", OBuffersNumaOff, false},
+	{"interleave", OBuffersNumaInterleave, false},
+	{"bind", OBuffersNumaBind, false},
+	{NULL, 0, false}
+};
+
+int			buffers_huge_pages = OBuffersHugePagesOff;
+int			buffers_huge_page_size = 0;
+int			buffers_numa = OBuffersNumaOff;
+char	   *buffers_numa_nodes = NULL;
+
+static Pointer region = NULL;
+static Size regionSize = 0;
+
+bool
+buffers_region_enabled(void)
+{
+	return buffers_huge_pages != OBuffersHugePagesOff ||
+		buffers_numa != OBuffersNumaOff;
+}
+
+/*
+ * Returns the default huge page size of the system or 0 if unknown.
+ */
+static Size
+get_default_huge_page_size(void)
+{
+	Size		result = 0;
+	FILE	   *fp;
+	char		buf[128];
+	unsigned int sz;
+
+	fp = AllocateFile("/proc/meminfo", "r");
+	if (!fp)
+		return 0;
+
+	while (fgets(buf, sizeof(buf), fp))
+	{
+		if (sscanf(buf, "Hugepagesize: %u kB", &sz) == 1)
+		{
+			result = (Size) sz * 1024;
+			break;
+		}
+	}
+	FreeFile(fp);
+
+	return result;
+}
+
+/*
+ * Parses the list of NUMA nodes like "0,2-3" into the bit mask.
+ */
+static bool
+parse_numa_nodes(const char *str, unsigned long *mask)
+{
+	const char *ptr = str;
+
+	memset(mask, 0, sizeof(unsigned long) * O_NUMA_MASK_WORDS);
+	while (*ptr)
+	{
+		char	   *end;
+		long		from,
+					to,
+					node;
+
+		while (*ptr == ' ' || *ptr == ',' || *ptr == '\n')
+			ptr++;
+		if (*ptr == '\0')
+			break;
+
+		from = strtol(ptr, &end, 10);
+		if (end == ptr)
+			return false;
+		ptr = end;
+		to = from;
+		if (*ptr == '-')
+		{
+			ptr++;
+			to = strtol(ptr, &end, 10);
+			if (end == ptr)
+				return false;
+			ptr = end;
+		}
+		if (from < 0 || to < from || to >= O_MAX_NUMA_NODES)
+			return false;
+
+		for (node = from; node <= to; node++)
+			mask[node / (8 * sizeof(unsigned long))] |=
+				1UL << (node % (8 * sizeof(unsigned long)));
+	}
+	return true;
+}
+
+/*
+ * Applies orioledb.buffers_numa policy to the region.  Failures are reported
+ * as warnings: the buffers remain usable with the default policy.
+ */
+static const char *
+apply_numa_policy(Pointer ptr, Size size)
+{
+#ifdef SYS_mbind
+	unsigned long mask[O_NUMA_MASK_WORDS];
+	char		online[256];
+	const char *nodes = buffers_numa_nodes;
+	int			mode;
+
+	if (buffers_numa == OBuffersNumaOff)
+		return "default";
+
+	if (nodes == NULL || nodes[0] == '\0')
+	{
+		FILE	   *fp;
+
+		fp = AllocateFile("/sys/devices/system/node/online", "r");
+		if (!fp || !fgets(online, sizeof(online), fp))
+		{
+			if (fp)
+				FreeFile(fp);
+			elog(WARNING, "could not read the list of online NUMA nodes");
+			return "default";
+		}
+		FreeFile(fp);
+		nodes = online;
+	}
+
+	if (!parse_numa_nodes(nodes, mask))
+	{
+		elog(WARNING, "invalid list of NUMA nodes \"%s\"", nodes);
+		return "default";
+	}
+
+	mode = (buffers_numa == OBuffersNumaBind) ? O_MPOL_BIND : O_MPOL_INTERLEAVE;
+	if (syscall(SYS_mbind, ptr, size, mode, mask, O_MAX_NUMA_NODES + 1, 0) != 0)
+	{
+		elog(WARNING, "could not apply NUMA policy to orioledb buffers: %m");
+		return "default";
+	}
+
+	return (buffers_numa == OBuffersNumaBind) ? "bind" : "interleave";
+#else
+	if (buffers_numa != OBuffersNumaOff)
+		elog(WARNING, "NUMA policy for orioledb buffers is not supported on this platform");
+	return "default";
+#endif
+}
+
+/*
+ * Returns the region for `size` bytes of page buffers.  Maps it on the first
+ * call.  Must be called by postmaster.
+ */
+Pointer
+buffers_region_get(Size size)
+{
+	Size		pageSize = 0;
+	Size		mapSize = size;
+	int			flags = MAP_SHARED | MAP_ANONYMOUS;
+	const char *policy;
+
+	Assert(buffers_region_enabled());
+
+	if (region != NULL)
+	{
+		Assert(size <= regionSize);
+		return region;
+	}
+
+#ifdef EXEC_BACKEND
+	ereport(FATAL,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("orioledb.buffers_huge_pages and orioledb.buffers_numa are not supported by this build")));
+#endif
+
+#ifdef MAP_HUGETLB
+	if (buffers_huge_pages != OBuffersHugePagesOff)
+	{
+		pageSize = buffers_huge_page_size > 0 ?
+			(Size) buffers_huge_page_size * 1024 :
+			get_default_huge_page_size();
+
+		if (pageSize > 0)
+		{
+			int			shift = 0;
+
+			while (((Size) 1 << shift) < pageSize)
+				shift++;
+			mapSize = TYPEALIGN(pageSize, size);
+			region = mmap(NULL, mapSize, PROT_READ | PROT_WRITE,
+						  flags | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT),
+						  -1, 0);
+			if (region == MAP_FAILED)
+				region = NULL;
+		}
+
+		if (region == NULL && buffers_huge_pages == OBuffersHugePagesOn)
+			ereport(FATAL,
+					(errcode(ERRCODE_OUT_OF_MEMORY),
+					 errmsg("could not map %zu bytes of orioledb buffers using huge pages of %zu kB: %m",
+							mapSize, pageSize / 1024),
+					 errhint("Check the number of free huge pages of this size in the system.")));
+	}
+#else
+	if (buffers_huge_pages == OBuffersHugePagesOn)
+		ereport(FATAL,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("huge pages are not supported on this platform")));
+#endif
+
+	if (region == NULL)
+	{
+		pageSize = 0;
+		mapSize = size;
+		region = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (region == MAP_FAILED)
+			ereport(FATAL,
+					(errcode(ERRCODE_OUT_OF_MEMORY),
+					 errmsg("could not map %zu bytes of orioledb buffers: %m",
+							mapSize)));
+	}
+	regionSize = mapSize;
+
+	policy = apply_numa_policy(region, mapSize);
+
+	if (pageSize > 0)
+		elog(LOG, "orioledb buffers: mapped %zu MB using %zu kB huge pages, NUMA policy %s",
+			 mapSize / (1024 * 1024), pageSize / 1024, policy);
+	else
+		elog(LOG, "orioledb buffers: mapped %zu MB using regular pages, NUMA policy %s",
+			 mapSize / (1024 * 1024), policy);
+
+	return region;
+}
@@ -1,7 +1,8 @@
 /*-------------------------------------------------------------------------
  *
  * compress.c
- *		Compression functions for BTree pages. Wrapper for libzstd.
+ *		Compression functions for BTree pages and WAL containers. Wrapper
+ *		for libzstd.
  *
  * Copyright (c) 2021-2025, Oriole DB Inc.
  *
@@ -25,6 +26,7 @@ static ZSTD_CCtx *zstd_cctx = NULL;
 static ZSTD_DCtx *zstd_dctx = NULL;
 static size_t zstd_dst_size;
 static Pointer zstd_dst = NULL;
+static Pointer zstd_buf_dst = NULL;
 
 /*
  * Initializes compression context.
@@ -36,6 +38,7 @@ o_compress_init(void)
 	zstd_dctx = ZSTD_createDCtx();
 	zstd_dst_size = ZSTD_compressBound(ORIOLEDB_BLCKSZ);
 	zstd_dst = malloc(zstd_dst_size);
+	zstd_buf_dst = malloc(zstd_dst_size);
 
 	/*
 	 * It helps to avoid Valgrind uninitialized bytes error inside
@@ -89,6 +92,74 @@ o_decompress_page(Pointer src, size_t size, Pointer page)
 	Assert(result == ORIOLEDB_BLCKSZ);
 }
 
+/*
+ * Compresses an arbitrary buffer of at most ORIOLEDB_BLCKSZ bytes.  Returns
+ * pointer to the static buffer containing the compressed data.
+ */
+Pointer
+o_compress_buffer(Pointer src, size_t size, size_t *result_size,
+				  OCompress lvl)
+{
+	Assert(size <= ORIOLEDB_BLCKSZ);
+	*result_size = ZSTD_compressCCtx(zstd_cctx,
+									 zstd_buf_dst, zstd_dst_size,
+									 src, size,
+									 lvl);
+	if (ZSTD_isError(*result_size))
+	{
+		elog(ERROR,
+			 "Unable to compress buffer, reason: %s",
+			 ZSTD_getErrorName(*result_size));
+	}
+
+	return zstd_buf_dst;
+}
+
+/*
+ * Decompresses the buffer made by o_compress_buffer().  The decompressed data
+ * must be exactly dst_size bytes.
+ */
+void
+o_decompress_buffer(Pointer src, size_t size, Pointer dst, size_t dst_size)
+{
+	size_t		result;
+
+	result = ZSTD_decompressDCtx(zstd_dctx,
+								 dst, dst_size,
+								 src, size);
+	if (ZSTD_isError(result))
+	{
+		elog(ERROR,
+			 "Unable to decompress buffer, reason: %s", ZSTD_getErrorName(result));
+	}
+
+	if (result != dst_size)
+		elog(ERROR, "decompressed buffer size %zu doesn't match expected %zu",
+			 result, dst_size);
+}
+
+/*
+ * Compresses an arbitrary amount of data into a single zstd frame.  Unlike
+ * o_compress_buffer(), the result is palloc'ed and the frame records the
+ * original size, so it could be decompressed by any zstd tool.
+ */
+Pointer
+o_compress_data(Pointer src, size_t size, size_t *result_size, OCompress lvl)
+{
+	size_t		dst_size = ZSTD_compressBound(size);
+	Pointer		dst = palloc(dst_size);
+
+	*result_size = ZSTD_compressCCtx(zstd_cctx, dst, dst_size, src, size, lvl);
+	if (ZSTD_isError(*result_size))
+	{
+		elog(ERROR,
+			 "Unable to compress data, reason: %s",
+			 ZSTD_getErrorName(*result_size));
+	}
+
+	return dst;
+}
+
 /*
  * Returns max orioledb compression level.
  */
@@ -0,0 +1,706 @@
+/*-------------------------------------------------------------------------
+ *
+ * o_stat.c
+ *		OrioleDB cumulative I/O and eviction statistics.
+ *
+ * Counters are first accumulated in backend-local memory and then flushed to
+ * shared memory in batches: on transaction end, on backend exit, at the end
+ * of checkpoint and every O_STAT_FLUSH_THRESHOLD events.  So the hot path
+ * costs just a couple of local additions.  Flushing uses only atomic
+ * operations and never allocates memory, so counting is safe within page
+ * locks and critical sections.
+ *
+ * Shared memory contains the global counters and a fixed-size open-addressing
+ * table of per-tree counters.  Existing entries are found without locking.
+ * Entries are claimed and released under the spinlock, and the entries of
+ * dropped trees are turned into tombstones to be reused by the new trees.
+ * When the table is full, events of the new trees are counted only globally,
+ * and the backend reports it to the log once.
+ *
+ * Waits for page locks, page reads, split completion and IO are counted the
+ * same way.  Only every orioledb.wait_sample_interval'th wait of the backend
+ * is timed and placed into the wait time histogram.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/src/utils/o_stat.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "orioledb.h"
+
+#include "utils/o_stat.h"
+#include "workers/bgwriter.h"
+
+#include "access/htup_details.h"
+#include "catalog/pg_type.h"
+#include "common/hashfn.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "storage/lwlock.h"
+#include "storage/spin.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/timestamp.h"
+
+#define O_STAT_LOCAL_TREES		64
+#define O_STAT_FLUSH_THRESHOLD	1024
+
+#define O_STAT_TREE_KEY(datoid, relnode) \
+	(((uint64) (datoid) << 32) | (uint64) (relnode))
+#define O_STAT_KEY_DATOID(key)	((Oid) ((key) >> 32))
+#define O_STAT_KEY_RELNODE(key) ((Oid) ((key) & 0xFFFFFFFF))
+#define O_STAT_KEY_FREE			UINT64CONST(0)
+#define O_STAT_KEY_DELETED		PG_UINT64_MAX
+#define O_STAT_KEY_IS_USED(key) \
+	((key) != O_STAT_KEY_FREE && (key) != O_STAT_KEY_DELETED)
+
+typedef struct
+{
+	pg_atomic_uint64 key;
+	pg_atomic_uint64 counters[OStatCountersNum];
+} OStatTreeEntry;
+
+#define O_STAT_WAIT_COUNTER(kind, i) \
+	(OStatWaitFirst + (kind) * O_STAT_WAIT_COUNTERS + (i))
+
+typedef struct
+{
+	int			waitTrancheIds[OStatWaitKindsNum];
+	slock_t		treesLock;		/* serializes claiming and releasing of
+								 * the tree entries */
+	pg_atomic_uint64 resetTime;
+	pg_atomic_uint64 global[OStatCountersNum];
+	OStatTreeEntry trees[FLEXIBLE_ARRAY_MEMBER];
+} OStatShmem;
+
+typedef struct
+{
+	uint64		key;
+	uint64		counters[OStatCountersNum];
+} OStatLocalEntry;
+
+int			o_stat_max_trees = 1024;
+int			o_stat_wait_sample_interval = 8;
+
+static const char *const waitKindNames[OStatWaitKindsNum] = {
+	"page_lock",
+	"page_read",
+	"page_split",
+	"io"
+};
+
+/* Names of the wait events, IO waits are reported by the IO lock itself */
+static const char *const waitTrancheNames[OStatWaitKindsNum] = {
+	"OPageLockTrancheId",
+	"OPageReadTrancheId",
+	"OPageSplitTrancheId",
+	NULL
+};
+
+static OStatShmem *oStatShmem = NULL;
+
+static OStatLocalEntry localTrees[O_STAT_LOCAL_TREES];
+static int	localTreesCount = 0;
+static uint64 localGlobal[OStatCountersNum];
+static int	pendingEvents = 0;
+static uint32 waitsCount = 0;
+static bool overflowReported = false;
+
+PG_FUNCTION_INFO_V1(orioledb_get_stat_global);
+PG_FUNCTION_INFO_V1(orioledb_get_stat_trees);
+PG_FUNCTION_INFO_V1(orioledb_get_stat_waits);
+PG_FUNCTION_INFO_V1(orioledb_stat_reset);
+
+Size
+o_stat_shmem_needs(void)
+{
+	return CACHELINEALIGN(add_size(offsetof(OStatShmem, trees),
+								   mul_size(sizeof(OStatTreeEntry),
+											o_stat_max_trees)));
+}
+
+void
+o_stat_shmem_init(Pointer ptr, bool found)
+{
+	int			i;
+
+	oStatShmem = (OStatShmem *) ptr;
+
+	if (!found)
+	{
+		int			j;
+
+		for (i = 0; i < OStatWaitKindsNum; i++)
+			if (waitTrancheNames[i])
+				oStatShmem->waitTrancheIds[i] = LWLockNewTrancheId();
+
+		SpinLockInit(&oStatShmem->treesLock);
+		pg_atomic_init_u64(&oStatShmem->resetTime,
+						   (uint64) GetCurrentTimestamp());
+		for (j = 0; j < OStatCountersNum; j++)
+			pg_atomic_init_u64(&oStatShmem->global[j], 0);
+
+		for (i = 0; i < o_stat_max_trees; i++)
+		{
+			pg_atomic_init_u64(&oStatShmem->trees[i].key, 0);
+			for (j = 0; j < OStatCountersNum; j++)
+				pg_atomic_init_u64(&oStatShmem->trees[i].counters[j], 0);
+		}
+	}
+
+	for (i = 0; i < OStatWaitKindsNum; i++)
+		if (waitTrancheNames[i])
+			LWLockRegisterTranche(oStatShmem->waitTrancheIds[i],
+								  waitTrancheNames[i]);
+}
+
+/* first entry of the probe sequence for the key */
+static inline uint32
+shared_tree_entry_start(uint64 key)
+{
+	return hash_bytes_uint32((uint32) key ^ (uint32) (key >> 32)) %
+		(uint32) o_stat_max_trees;
+}
+
+/*
+ * Finds the shared entry for the tree, claiming a free one if needed.
+ * Returns NULL if the table is full.
+ */
+static OStatTreeEntry *
+get_shared_tree_entry(uint64 key)
+{
+	OStatTreeEntry *result = NULL;
+	bool		found = false;
+	uint32		start,
+				i;
+
+	if (o_stat_max_trees <= 0)
+		return NULL;
+
+	/* Fast path: the entry already exists */
+	start = shared_tree_entry_start(key);
+	i = start;
+	do
+	{
+		OStatTreeEntry *entry = &oStatShmem->trees[i];
+		uint64		cur = pg_atomic_read_u64(&entry->key);
+
+		if (cur == key)
+			return entry;
+		if (cur == O_STAT_KEY_FREE)
+			break;
+		i = (i + 1) % (uint32) o_stat_max_trees;
+	} while (i != start);
+
+	/*
+	 * Claim the first free entry or tombstone.  Recheck the probe chain under
+	 * the lock, because another backend might have claimed the entry for the
+	 * same tree.  Counters are reset before the key gets visible.
+	 */
+	SpinLockAcquire(&oStatShmem->treesLock);
+	i = start;
+	do
+	{
+		OStatTreeEntry *entry = &oStatShmem->trees[i];
+		uint64		cur = pg_atomic_read_u64(&entry->key);
+
+		if (cur == key)
+		{
+			result = entry;
+			found = true;
+			break;
+		}
+		if (!O_STAT_KEY_IS_USED(cur) && result == NULL)
+			result = entry;
+		if (cur == O_STAT_KEY_FREE)
+			break;
+		i = (i + 1) % (uint32) o_stat_max_trees;
+	} while (i != start);
+
+	if (result != NULL && !found)
+	{
+		int			j;
+
+		for (j = 0; j < OStatCountersNum; j++)
+			pg_atomic_write_u64(&result->counters[j], 0);
+		pg_write_barrier();
+		pg_atomic_write_u64(&result->key, key);
+	}
+	SpinLockRelease(&oStatShmem->treesLock);
+
+	if (result == NULL && !overflowReported)
+	{
+		overflowReported = true;
+		ereport(LOG,
+				(errmsg("orioledb cumulative statistics table is full"),
+				 errdetail("Events of the tree (%u, %u) and other new trees are counted only globally.",
+						   O_STAT_KEY_DATOID(key), O_STAT_KEY_RELNODE(key)),
+				 errhint("Consider increasing orioledb.stat_max_trees.")));
+	}
+
+	return result;
+}
+
+/*
+ * Releases the shared entry of the dropped tree.  Pending local events of the
+ * tree are discarded.
+ */
+void
+o_stat_drop_tree(Oid datoid, Oid relnode)
+{
+	uint64		key = O_STAT_TREE_KEY(datoid, relnode);
+	uint32		start,
+				i;
+
+	if (oStatShmem == NULL || !OidIsValid(relnode))
+		return;
+
+	for (i = 0; i < O_STAT_LOCAL_TREES; i++)
+	{
+		if (localTrees[i].key == key)
+			memset(localTrees[i].counters, 0, sizeof(localTrees[i].counters));
+	}
+
+	if (o_stat_max_trees <= 0)
+		return;
+
+	SpinLockAcquire(&oStatShmem->treesLock);
+	start = shared_tree_entry_start(key);
+	i = start;
+	do
+	{
+		OStatTreeEntry *entry = &oStatShmem->trees[i];
+		uint64		cur = pg_atomic_read_u64(&entry->key);
+
+		if (cur == key)
+		{
+			pg_atomic_write_u64(&entry->key, O_STAT_KEY_DELETED);
+			break;
+		}
+		if (cur == O_STAT_KEY_FREE)
+			break;
+		i = (i + 1) % (uint32) o_stat_max_trees;
+	} while (i != start);
+	SpinLockRelease(&oStatShmem->treesLock);
+}
+
+/*
+ * Moves the locally accumulated counters to shared memory.
+ */
+void
+o_stat_flush(void)
+{
+	int			i,
+				j;
+
+	if (pendingEvents == 0 || oStatShmem == NULL)
+		return;
+
+	for (j = 0; j < OStatCountersNum; j++)
+	{
+		if (localGlobal[j] != 0)
+			pg_atomic_fetch_add_u64(&oStatShmem->global[j], localGlobal[j]);
+		localGlobal[j] = 0;
+	}
+
+	for (i = 0; i < O_STAT_LOCAL_TREES; i++)
+	{
+		OStatLocalEntry *local = &localTrees[i];
+		OStatTreeEntry *shared = NULL;
+
+		if (local->key == 0)
+			continue;
+
+		/* Counters of the dropped trees are zeroed, don't claim for them */
+		for (j = 0; j < OStatCountersNum; j++)
+		{
+			if (local->counters[j] != 0)
+			{
+				shared = get_shared_tree_entry(local->key);
+				break;
+			}
+		}
+
+		for (j = 0; j < OStatCountersNum; j++)
+		{
+			if (shared && local->counters[j] != 0)
+				pg_atomic_fetch_add_u64(&shared->counters[j],
+										local->counters[j]);
+			local->counters[j] = 0;
+		}
+		local->key = 0;
+	}
+
+	localTreesCount = 0;
+	pendingEvents = 0;
+}
+
+/*
+ * Returns the current value of the global counter including the events of
+ * this backend.
+ */
+uint64
+o_stat_global_read(OStatCounter counter)
+{
+	o_stat_flush();
+
+	if (oStatShmem == NULL)
+		return 0;
+	return pg_atomic_read_u64(&oStatShmem->global[counter]);
+}
+
+static OStatLocalEntry *
+get_local_tree_entry(uint64 key)
+{
+	uint32		i;
+
+	/* Keep a free slot so the search always terminates */
+	if (localTreesCount >= O_STAT_LOCAL_TREES - 1)
+		o_stat_flush();
+
+	i = hash_bytes_uint32((uint32) key ^ (uint32) (key >> 32)) %
+		O_STAT_LOCAL_TREES;
+	while (true)
+	{
+		OStatLocalEntry *entry = &localTrees[i];
+
+		if (entry->key == key)
+			return entry;
+		if (entry->key == 0)
+		{
+			entry->key = key;
+			localTreesCount++;
+			return entry;
+		}
+		i = (i + 1) % O_STAT_LOCAL_TREES;
+	}
+}
+
+/*
+ * Accounts the event.  Invalid relnode means event isn't attributed to any
+ * tree and is counted only globally.
+ */
+void
+o_stat_count(Oid datoid, Oid relnode, OStatCounter counter, uint64 value)
+{
+	Assert(counter >= 0 && counter < OStatCountersNum);
+
+	localGlobal[counter] += value;
+	if (OidIsValid(relnode))
+		get_local_tree_entry(O_STAT_TREE_KEY(datoid, relnode))->counters[counter] += value;
+
+	if (++pendingEvents >= O_STAT_FLUSH_THRESHOLD)
+		o_stat_flush();
+}
+
+/*
+ * Accounts the page write to the data file.  Writes are distinguished by the
+ * process performing them.
+ */
+void
+o_stat_count_write(BTreeDescr *desc, uint64 bytesWritten)
+{
+	OStatCounter counter;
+
+	if (MyBackendType == B_CHECKPOINTER)
+		counter = OStatWritesCheckpointer;
+	else if (IsBGWriter)
+		counter = OStatWritesBGWriter;
+	else
+		counter = OStatWritesBackend;
+
+	o_stat_tree_count(desc, counter, 1);
+	o_stat_tree_count(desc, OStatBytesWritten, bytesWritten);
+	o_stat_tree_count(desc, OStatBytesUncompressed, ORIOLEDB_BLCKSZ);
+}
+
+/*
+ * Accounts the page eviction.  Evictions are distinguished by the page state
+ * and by the reason: requested by orioledb_evict_pages(), performed by
+ * orioledb bgwriter, or performed by a process needing free pages.
+ */
+void
+o_stat_count_eviction(BTreeDescr *desc, bool dirty, bool requested)
+{
+	OStatCounter counter;
+
+	if (requested)
+		counter = OStatEvictionsExplicit;
+	else if (IsBGWriter)
+		counter = OStatEvictionsBGWriter;
+	else
+		counter = OStatEvictionsOnDemand;
+
+	o_stat_tree_count(desc, dirty ? OStatEvictionsDirty : OStatEvictionsClean,
+					  1);
+	o_stat_tree_count(desc, counter, 1);
+}
+
+/*
+ * Returns the wait event to report while sleeping in the wait of the given
+ * kind.
+ */
+uint32
+o_stat_wait_event(OStatWaitKind kind)
+{
+	Assert(waitTrancheNames[kind] != NULL);
+
+	if (oStatShmem == NULL)
+		return PG_WAIT_LWLOCK | LWTRANCHE_BUFFER_CONTENT;
+	return PG_WAIT_LWLOCK | oStatShmem->waitTrancheIds[kind];
+}
+
+/*
+ * Should be called before the first sleep of the wait.  Decides whether the
+ * wait is sampled.
+ */
+void
+o_stat_wait_start(OStatWait *wait)
+{
+	wait->sampled = o_stat_wait_sample_interval > 0 &&
+		(++waitsCount % (uint32) o_stat_wait_sample_interval) == 0;
+	if (wait->sampled)
+		INSTR_TIME_SET_CURRENT(wait->start);
+}
+
+/*
+ * Accounts the finished wait.  Invalid relnode means the wait isn't
+ * attributed to any tree.
+ */
+void
+o_stat_wait_end(OStatWait *wait, Oid datoid, Oid relnode, OStatWaitKind kind)
+{
+	o_stat_count(datoid, relnode,
+				 O_STAT_WAIT_COUNTER(kind, O_STAT_WAIT_WAITS), 1);
+
+	if (wait->sampled)
+	{
+		instr_time	duration;
+		uint64		us,
+					limit = 16;
+		int			bucket = 0;
+
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, wait->start);
+		us = INSTR_TIME_GET_MICROSEC(duration);
+
+		while (us >= limit && bucket < O_STAT_WAIT_BUCKETS - 1)
+		{
+			limit *= 4;
+			bucket++;
+		}
+
+		o_stat_count(datoid, relnode,
+					 O_STAT_WAIT_COUNTER(kind, O_STAT_WAIT_SAMPLED), 1);
+		o_stat_count(datoid, relnode,
+					 O_STAT_WAIT_COUNTER(kind, O_STAT_WAIT_TIME), us);
+		o_stat_count(datoid, relnode,
+					 O_STAT_WAIT_COUNTER(kind, O_STAT_WAIT_HIST + bucket), 1);
+	}
+}
+
+void
+o_stat_xact_callback(XactEvent event, void *arg)
+{
+	if (event == XACT_EVENT_COMMIT || event == XACT_EVENT_ABORT ||
+		event == XACT_EVENT_PARALLEL_COMMIT ||
+		event == XACT_EVENT_PARALLEL_ABORT)
+		o_stat_flush();
+}
+
+static void
+stat_values_fill(Datum *values, pg_atomic_uint64 *counters, int ncounters)
+{
+	int			j;
+
+	for (j = 0; j < ncounters; j++)
+		values[j] = Int64GetDatum((int64) pg_atomic_read_u64(&counters[j]));
+}
+
+Datum
+orioledb_get_stat_global(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[OStatWaitFirst + 1];
+	bool		nulls[OStatWaitFirst + 1];
+
+	orioledb_check_shmem();
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	o_stat_flush();
+
+	/* Wait counters are shown by orioledb_get_stat_waits() */
+	MemSet(nulls, 0, sizeof(nulls));
+	stat_values_fill(values, oStatShmem->global, OStatWaitFirst);
+	values[OStatWaitFirst] = TimestampTzGetDatum((TimestampTz) pg_atomic_read_u64(&oStatShmem->resetTime));
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
+
+Datum
+orioledb_get_stat_trees(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	Datum		values[OStatUndoBytes + 2];
+	bool		nulls[OStatUndoBytes + 2];
+	int			i;
+
+	orioledb_check_shmem();
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	o_stat_flush();
+
+	/* Per-tree counters don't include undo ones */
+	MemSet(nulls, 0, sizeof(nulls));
+	for (i = 0; i < o_stat_max_trees; i++)
+	{
+		OStatTreeEntry *entry = &oStatShmem->trees[i];
+		uint64		key = pg_atomic_read_u64(&entry->key);
+
+		if (!O_STAT_KEY_IS_USED(key))
+			continue;
+
+		values[0] = ObjectIdGetDatum(O_STAT_KEY_DATOID(key));
+		values[1] = ObjectIdGetDatum(O_STAT_KEY_RELNODE(key));
+		stat_values_fill(&values[2], entry->counters, OStatUndoBytes);
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	return (Datum) 0;
+}
+
+/*
+ * Puts the rows of wait counters into the tuplestore.  Kinds without waits
+ * are skipped for trees.
+ */
+static void
+stat_waits_put(Tuplestorestate *tupstore, TupleDesc tupdesc,
+			   pg_atomic_uint64 *counters, uint64 key, bool global)
+{
+	Datum		values[7];
+	bool		nulls[7];
+	Datum		hist[O_STAT_WAIT_BUCKETS];
+	int			kind,
+				i;
+
+	MemSet(nulls, 0, sizeof(nulls));
+	for (kind = 0; kind < OStatWaitKindsNum; kind++)
+	{
+		pg_atomic_uint64 *c = &counters[O_STAT_WAIT_COUNTER(kind, 0)];
+		uint64		waits = pg_atomic_read_u64(&c[O_STAT_WAIT_WAITS]);
+
+		if (!global && waits == 0)
+			continue;
+
+		if (global)
+		{
+			nulls[0] = true;
+			nulls[1] = true;
+		}
+		else
+		{
+			values[0] = ObjectIdGetDatum(O_STAT_KEY_DATOID(key));
+			values[1] = ObjectIdGetDatum(O_STAT_KEY_RELNODE(key));
+		}
+		values[2] = CStringGetTextDatum(waitKindNames[kind]);
+		values[3] = Int64GetDatum((int64) waits);
+		values[4] = Int64GetDatum((int64) pg_atomic_read_u64(&c[O_STAT_WAIT_SAMPLED]));
+		values[5] = Int64GetDatum((int64) pg_atomic_read_u64(&c[O_STAT_WAIT_TIME]));
+		for (i = 0; i < O_STAT_WAIT_BUCKETS; i++)
+			hist[i] = Int64GetDatum((int64) pg_atomic_read_u64(&c[O_STAT_WAIT_HIST + i]));
+		values[6] = PointerGetDatum(construct_array(hist, O_STAT_WAIT_BUCKETS,
+													INT8OID, sizeof(int64),
+													FLOAT8PASSBYVAL,
+													TYPALIGN_DOUBLE));
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+}
+
+Datum
+orioledb_get_stat_waits(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			i;
+
+	orioledb_check_shmem();
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	o_stat_flush();
+
+	stat_waits_put(tupstore, tupdesc, oStatShmem->global, 0, true);
+	for (i = 0; i < o_stat_max_trees; i++)
+	{
+		OStatTreeEntry *entry = &oStatShmem->trees[i];
+		uint64		key = pg_atomic_read_u64(&entry->key);
+
+		if (!O_STAT_KEY_IS_USED(key))
+			continue;
+
+		stat_waits_put(tupstore, tupdesc, entry->counters, key, false);
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+
+	return (Datum) 0;
+}
+
+Datum
+orioledb_stat_reset(PG_FUNCTION_ARGS)
+{
+	int			i,
+				j;
+
+	orioledb_check_shmem();
+
+	o_stat_flush();
+
+	for (j = 0; j < OStatCountersNum; j++)
+		pg_atomic_write_u64(&oStatShmem->global[j], 0);
+
+	for (i = 0; i < o_stat_max_trees; i++)
+		for (j = 0; j < OStatCountersNum; j++)
+			pg_atomic_write_u64(&oStatShmem->trees[i].counters[j], 0);
+
+	pg_atomic_write_u64(&oStatShmem->resetTime, (uint64) GetCurrentTimestamp());
+
+	PG_RETURN_VOID();
+}
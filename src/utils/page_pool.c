@@ -24,23 +24,33 @@
 
 #include "utils/memdebug.h"
 
+/*
+ * The main pool lends its pages only while it keeps this part of the pool
+ * free.
+ */
+#define PPOOL_LEND_MIN_FREE_RATIO	10
+
+bool		ppool_adaptive_buffers = false;
+
 /*
  * Calculates shared memory space needed for a page pool. Be careful,
  * it prepares local memory structures to initialize.
  */
 Size
-ppool_estimate_space(OPagePool *pool, OInMemoryBlkno offset, OInMemoryBlkno size, bool debug)
+ppool_estimate_space(OPagePool *pool, OPagePoolType type, OInMemoryBlkno offset, OInMemoryBlkno size, bool debug)
 {
 	Size		result = 0;
 
 	if (!debug)
 		Assert(size >= PPOOL_MIN_SIZE);
 
+	pool->type = type;
 	pool->offset = offset;
 	pool->size = size;
 
 	result += CACHELINEALIGN(sizeof(pg_atomic_uint64));
 	result += CACHELINEALIGN(sizeof(pg_atomic_uint32));
+	result += CACHELINEALIGN(sizeof(OPagePoolCounters));
 
 	pool->ucmShmemSize = estimate_ucm_space(&pool->ucm, offset, size);
 
@@ -61,10 +71,17 @@ ppool_shmem_init(OPagePool *pool, Pointer ptr, bool found)
 	pool->dirtyPagesCount = (pg_atomic_uint32 *) ptr;
 	ptr += CACHELINEALIGN(sizeof(pg_atomic_uint32));
 
+	pool->counters = (OPagePoolCounters *) ptr;
+	ptr += CACHELINEALIGN(sizeof(OPagePoolCounters));
+
 	if (!found)
 	{
 		pg_atomic_init_u64(pool->availablePagesCount, pool->size);
 		pg_atomic_init_u32(pool->dirtyPagesCount, 0);
+		pg_atomic_init_u32(&pool->counters->lentPagesCount, 0);
+		pg_atomic_init_u32(&pool->counters->borrowedPagesCount, 0);
+		pg_atomic_init_u64(&pool->counters->borrowsCount, 0);
+		pg_atomic_init_u64(&pool->counters->evictionsCount, 0);
 	}
 
 	init_ucm(&pool->ucm, ptr, found);
@@ -75,6 +92,41 @@ ppool_shmem_init(OPagePool *pool, Pointer ptr, bool found)
 										  pool->offset + pool->size - 1);
 }
 
+/*
+ * Tries to reserve `count` free pages of the main pool for the free extents
+ * or catalog pool, when orioledb.adaptive_buffers is enabled.
+ *
+ * The main pool is never clocked here: evicting the main pool pages requires
+ * pages of the other pools, and we might be already evicting a page of the
+ * main pool.  So, the pages are lent only while the main pool has enough of
+ * free pages.  Lent pages stay in the UCM of the main pool, and its clock
+ * evicts them once they become colder than the main pool pages.  This way
+ * the memory moves between the pools according to their usage.  The main
+ * pool never borrows pages for the same reason.
+ */
+static bool
+ppool_borrow_pages(OPagePool *pool, int count)
+{
+	OPagePool  *donor;
+	uint64		minFree,
+				val;
+
+	if (!ppool_adaptive_buffers || pool->type == OPagePoolMain)
+		return false;
+
+	donor = get_ppool(OPagePoolMain);
+	minFree = donor->size / PPOOL_LEND_MIN_FREE_RATIO;
+
+	val = pg_atomic_read_u64(donor->availablePagesCount);
+	while (!(val & (UINT64CONST(1) << 63)) && val >= minFree + count)
+	{
+		if (pg_atomic_compare_exchange_u64(donor->availablePagesCount,
+										   &val, val - count))
+			return true;
+	}
+	return false;
+}
+
 /*
  * Reserve pages for further allocation.  Reserving pages might require running
  * clock algorithm with page eviction.  It shouldn't be called while holding
@@ -99,6 +151,16 @@ ppool_reserve_pages(OPagePool *pool, int kind, int count)
 	if (count <= 0)
 		return;
 
+	/* Borrow the main pool pages instead of evicting our own ones */
+	val = pg_atomic_read_u64(pool->availablePagesCount);
+	if ((val & (UINT64CONST(1) << 63) || val < count) &&
+		ppool_borrow_pages(pool, count))
+	{
+		pool->numPagesReserved[kind] += count;
+		pool->numPagesBorrowed[kind] += count;
+		return;
+	}
+
 	val = pg_atomic_sub_fetch_u64(pool->availablePagesCount, count);
 	while (val & (UINT64CONST(1) << 63))
 	{
@@ -117,18 +179,24 @@ void
 ppool_release_reserved(OPagePool *pool, uint32 mask)
 {
 	int			sum = 0,
+				borrowedSum = 0,
 				kind;
 
 	for (kind = 0; kind < PPOOL_RESERVE_COUNT; kind++)
 	{
 		if (mask & (1 << kind))
 		{
-			sum += pool->numPagesReserved[kind];
+			sum += pool->numPagesReserved[kind] - pool->numPagesBorrowed[kind];
+			borrowedSum += pool->numPagesBorrowed[kind];
 			pool->numPagesReserved[kind] = 0;
+			pool->numPagesBorrowed[kind] = 0;
 		}
 	}
 	if (sum != 0)
 		pg_atomic_add_fetch_u64(pool->availablePagesCount, sum);
+	if (borrowedSum != 0)
+		pg_atomic_add_fetch_u64(get_ppool(OPagePoolMain)->availablePagesCount,
+								borrowedSum);
 }
 
 /*
@@ -171,8 +239,27 @@ ppool_get_page(OPagePool *pool, int kind)
 	Assert(pool->numPagesReserved[kind] > 0);
 	pool->numPagesReserved[kind]--;
 
-	result = ucm_occupy_free_page(&pool->ucm);
-	Assert(pool->offset <= result && result < pool->offset + pool->size);
+	if (pool->numPagesBorrowed[kind] > 0)
+	{
+		OPagePool  *donor = get_ppool(OPagePoolMain);
+		OrioleDBPageDesc *page_desc;
+
+		pool->numPagesBorrowed[kind]--;
+		result = ucm_occupy_free_page(&donor->ucm);
+		Assert(donor->offset <= result && result < donor->offset + donor->size);
+
+		page_desc = O_GET_IN_MEMORY_PAGEDESC(result);
+		Assert(PAGE_DESC_GET_BORROWER(page_desc) == 0);
+		page_desc->flags |= (pool->type << PAGE_DESC_BORROWER_SHIFT);
+		pg_atomic_fetch_add_u32(&donor->counters->lentPagesCount, 1);
+		pg_atomic_fetch_add_u32(&pool->counters->borrowedPagesCount, 1);
+		pg_atomic_fetch_add_u64(&pool->counters->borrowsCount, 1);
+	}
+	else
+	{
+		result = ucm_occupy_free_page(&pool->ucm);
+		Assert(pool->offset <= result && result < pool->offset + pool->size);
+	}
 
 	VALGRIND_CHECK_MEM_IS_DEFINED(O_GET_IN_MEMORY_PAGE(result), ORIOLEDB_BLCKSZ);
 
@@ -180,15 +267,17 @@ ppool_get_page(OPagePool *pool, int kind)
 }
 
 /*
- * Return free page to the pool.
+ * Return free page to the pool.  The page borrowed from the main pool is
+ * returned to the main pool.
  */
 void
 ppool_free_page(OPagePool *pool, OInMemoryBlkno blkno, bool haveLock)
 {
 	Page		p = O_GET_IN_MEMORY_PAGE(blkno);
 	OrioleDBPageDesc *page_desc = O_GET_IN_MEMORY_PAGEDESC(blkno);
+	int			borrower;
 
-	Assert(pool->offset <= blkno && blkno < pool->offset + pool->size);
+	pool = get_ppool_by_blkno(blkno);
 
 	VALGRIND_CHECK_MEM_IS_DEFINED(p, ORIOLEDB_BLCKSZ);
 	Assert(!IS_DIRTY(blkno));
@@ -206,8 +295,16 @@ ppool_free_page(OPagePool *pool, OInMemoryBlkno blkno, bool haveLock)
 	page_desc->type = 0;
 	page_desc->fileExtent.off = InvalidFileExtentOff;
 	page_desc->fileExtent.len = InvalidFileExtentLen;
+	borrower = PAGE_DESC_GET_BORROWER(page_desc);
+	page_desc->flags &= ~PAGE_DESC_BORROWER_MASK;
 	unlock_page(blkno);
 
+	if (borrower != 0)
+	{
+		pg_atomic_fetch_sub_u32(&get_ppool((OPagePoolType) borrower)->counters->borrowedPagesCount, 1);
+		pg_atomic_fetch_sub_u32(&pool->counters->lentPagesCount, 1);
+	}
+
 	page_change_usage_count(&pool->ucm, blkno, UCM_FREE_PAGES_LEVEL);
 
 	pg_atomic_add_fetch_u64(pool->availablePagesCount, 1);
@@ -244,6 +341,7 @@ ppool_run_clock(OPagePool *pool, bool evict,
 				volatile sig_atomic_t *shutdown_requested)
 {
 	uint64		blkno;
+	OWalkPageResult result;
 	Size		undoRegularSize = get_reserved_undo_size(UndoLogRegularPageLevel);
 	Size		undoSystemSize = get_reserved_undo_size(UndoLogSystem);
 	bool		haveRetainRegularLoc = undo_type_has_retained_location(UndoLogRegularPageLevel);
@@ -275,9 +373,12 @@ ppool_run_clock(OPagePool *pool, bool evict,
 		blkno = ucm_next_blkno(&pool->ucm, blkno, 1);
 
 		Assert(blkno >= pool->offset && blkno < pool->offset + pool->size);
-		if (walk_page(blkno, evict) != OWalkPageSkipped)
+		result = walk_page(blkno, evict);
+		if (result != OWalkPageSkipped)
 		{
 			Assert(!have_locked_pages());
+			if (result == OWalkPageEvicted)
+				pg_atomic_fetch_add_u64(&pool->counters->evictionsCount, 1);
 			break;
 		}
 		Assert(!have_locked_pages());
@@ -17,6 +17,7 @@
 #include "btree/undo.h"
 #include "s3/headers.h"
 #include "transam/undo.h"
+#include "utils/o_stat.h"
 #include "utils/page_pool.h"
 #include "utils/ucm.h"
 #include "utils/stopevent.h"
@@ -192,6 +193,8 @@ bgwriter_main(Datum main_arg)
 			if (orioledb_s3_mode)
 				s3_headers_try_eviction_cycle();
 
+			o_stat_flush();
+
 			ResetLatch(MyLatch);
 		}
 		elog(LOG, "orioledb bgwriter is shut down");
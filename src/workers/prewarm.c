@@ -0,0 +1,690 @@
+/*-------------------------------------------------------------------------
+ *
+ * prewarm.c
+ *		Routines for automatic warm-up of OrioleDB page pool.
+ *
+ * The autoprewarm leader process periodically dumps the list of pages
+ * residing in the main and catalog page pools to AUTOPREWARM_FILENAME.  Each
+ * page is identified by its tree and its on-disk location, which is the same
+ * as the location in the parent downlink.  Page usage level from the UCM is
+ * saved as well: when the dump doesn't fit into the free space of the pool,
+ * only the hottest pages are loaded.
+ *
+ * After restart, trees of the dump are distributed between the leader and
+ * the dynamic autoprewarm workers.  Every tree is walked top-down level by
+ * level, so internal pages are loaded first.  Within the level pages are
+ * loaded in the order of their on-disk offsets.  Loading stops when the pool
+ * free space goes low so that warm-up never causes evictions.
+ *
+ * Copyright (c) 2021-2025, Oriole DB Inc.
+ *
+ * IDENTIFICATION
+ *	  contrib/orioledb/src/workers/prewarm.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "orioledb.h"
+
+#include "btree/find.h"
+#include "btree/page_contents.h"
+#include "catalog/sys_trees.h"
+#include "tableam/descr.h"
+#include "utils/page_pool.h"
+#include "utils/ucm.h"
+#include "workers/prewarm.h"
+
+#include "fmgr.h"
+#include "miscadmin.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/interrupt.h"
+#include "storage/fd.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/proc.h"
+#include "storage/sinvaladt.h"
+#include "utils/guc.h"
+#include "utils/memutils.h"
+#include "utils/relcache.h"
+#include "utils/syscache.h"
+#include "utils/timeout.h"
+#include "utils/wait_event.h"
+
+#include <unistd.h>
+
+#define AUTOPREWARM_MAGIC	0x5752504F
+
+typedef struct
+{
+	uint32		magic;
+	uint32		binaryVersion;
+	uint64		count;
+	/* number of pages per usage level, higher level is hotter */
+	uint64		usageCounts[UCM_USAGE_LEVELS];
+} OAutoPrewarmHeader;
+
+typedef struct
+{
+	ORelOids	oids;
+	uint8		type;
+	uint8		level;
+	uint8		usage;
+	uint64		offset;
+} OAutoPrewarmEntry;
+
+/* The page to be visited during the tree walk */
+typedef struct
+{
+	OTuple		lokey;
+	uint64		offset;
+} OAutoPrewarmPage;
+
+bool		orioledb_autoprewarm = false;
+int			autoprewarm_interval = 300;
+int			autoprewarm_workers = 2;
+
+static volatile sig_atomic_t shutdown_requested = false;
+
+PG_FUNCTION_INFO_V1(orioledb_autoprewarm_dump);
+
+static void
+handle_sigterm(SIGNAL_ARGS)
+{
+	shutdown_requested = true;
+	SetLatch(MyLatch);
+}
+
+void
+register_autoprewarm(void)
+{
+	BackgroundWorker worker;
+
+	memset(&worker, 0, sizeof(worker));
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	worker.bgw_start_time = BgWorkerStart_ConsistentState;
+	worker.bgw_restart_time = BGW_NEVER_RESTART;
+	strcpy(worker.bgw_library_name, "orioledb");
+	strcpy(worker.bgw_function_name, "autoprewarm_main");
+	strcpy(worker.bgw_name, "orioledb autoprewarm leader");
+	strcpy(worker.bgw_type, "orioledb autoprewarm leader");
+	RegisterBackgroundWorker(&worker);
+}
+
+static BackgroundWorkerHandle *
+register_autoprewarm_worker(int part, int nparts)
+{
+	BackgroundWorker worker;
+	BackgroundWorkerHandle *handle = NULL;
+
+	memset(&worker, 0, sizeof(worker));
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	worker.bgw_start_time = BgWorkerStart_ConsistentState;
+	worker.bgw_restart_time = BGW_NEVER_RESTART;
+	worker.bgw_main_arg = Int32GetDatum(part);
+	worker.bgw_notify_pid = MyProcPid;
+	memcpy(worker.bgw_extra, &nparts, sizeof(nparts));
+	strcpy(worker.bgw_library_name, "orioledb");
+	strcpy(worker.bgw_function_name, "autoprewarm_worker_main");
+	snprintf(worker.bgw_name, BGW_MAXLEN, "orioledb autoprewarm worker %d", part);
+	strcpy(worker.bgw_type, "orioledb autoprewarm worker");
+
+	if (!RegisterDynamicBackgroundWorker(&worker, &handle))
+		return NULL;
+	return handle;
+}
+
+static int
+autoprewarm_entry_cmp(const void *a, const void *b)
+{
+	const OAutoPrewarmEntry *ea = (const OAutoPrewarmEntry *) a;
+	const OAutoPrewarmEntry *eb = (const OAutoPrewarmEntry *) b;
+
+	if (ea->oids.datoid != eb->oids.datoid)
+		return ea->oids.datoid < eb->oids.datoid ? -1 : 1;
+	if (ea->oids.reloid != eb->oids.reloid)
+		return ea->oids.reloid < eb->oids.reloid ? -1 : 1;
+	if (ea->oids.relnode != eb->oids.relnode)
+		return ea->oids.relnode < eb->oids.relnode ? -1 : 1;
+	if (ea->type != eb->type)
+		return ea->type < eb->type ? -1 : 1;
+	if (ea->offset != eb->offset)
+		return ea->offset < eb->offset ? -1 : 1;
+	return 0;
+}
+
+static int
+autoprewarm_page_cmp(const void *a, const void *b)
+{
+	uint64		oa = ((const OAutoPrewarmPage *) a)->offset;
+	uint64		ob = ((const OAutoPrewarmPage *) b)->offset;
+
+	return oa > ob ? 1 : oa < ob ? -1 : 0;
+}
+
+static int
+uint64_cmp(const void *a, const void *b)
+{
+	uint64		va = *((const uint64 *) a);
+	uint64		vb = *((const uint64 *) b);
+
+	return va > vb ? 1 : va < vb ? -1 : 0;
+}
+
+/*
+ * Writes the list of pages residing in the page pools to the autoprewarm
+ * file.  Returns the number of pages written.
+ *
+ * Page descriptors are read without locking.  So, the dump might contain a
+ * garbage entry for the page concurrently loaded or evicted.  That's OK: such
+ * an entry is just skipped during the warm-up.  Dirty pages are saved with
+ * their previous location, which could be reused by the next checkpoint.
+ */
+int64
+autoprewarm_dump(void)
+{
+	OPagePoolType poolTypes[] = {OPagePoolMain, OPagePoolCatalog};
+	OAutoPrewarmHeader header;
+	OAutoPrewarmEntry *entries;
+	Size		maxCount = 0;
+	Size		count = 0;
+	char	   *tmpFilename;
+	FILE	   *file;
+	int			i;
+
+	for (i = 0; i < lengthof(poolTypes); i++)
+		maxCount += get_ppool(poolTypes[i])->size;
+
+	entries = (OAutoPrewarmEntry *)
+		MemoryContextAllocHuge(CurrentMemoryContext,
+							   mul_size(maxCount, sizeof(OAutoPrewarmEntry)));
+	memset(&header, 0, sizeof(header));
+
+	for (i = 0; i < lengthof(poolTypes); i++)
+	{
+		OPagePool  *pool = get_ppool(poolTypes[i]);
+		uint32		epoch = pg_atomic_read_u32(pool->ucm.epoch);
+		OInMemoryBlkno blkno;
+
+		for (blkno = pool->offset; blkno < pool->offset + pool->size; blkno++)
+		{
+			OrioleDBPageDesc *page_desc = O_GET_IN_MEMORY_PAGEDESC(blkno);
+			Page		p = O_GET_IN_MEMORY_PAGE(blkno);
+			OAutoPrewarmEntry *entry;
+			ORelOids	oids;
+			FileExtent	extent;
+			uint32		usageCount,
+						type;
+
+			usageCount = pg_atomic_read_u32(&O_PAGE_HEADER(p)->usageCount);
+			if (usageCount >= UCM_USAGE_LEVELS)
+				continue;
+
+			oids = *((volatile ORelOids *) &page_desc->oids);
+			type = page_desc->type;
+			extent = page_desc->fileExtent;
+			if (!ORelOidsIsValid(oids) || type == oIndexInvalid ||
+				!FileExtentIsValid(extent))
+				continue;
+
+			entry = &entries[count++];
+			entry->oids = oids;
+			entry->type = type;
+			entry->level = PAGE_GET_LEVEL(p);
+
+			/*
+			 * The clock evicts pages having usage count equal to the epoch,
+			 * while page accesses move it up to the epoch - 1.
+			 */
+			entry->usage = (usageCount + UCM_USAGE_LEVELS - epoch) % UCM_USAGE_LEVELS;
+			entry->offset = extent.off;
+			header.usageCounts[entry->usage]++;
+		}
+	}
+
+	if (count > 1)
+		qsort(entries, count, sizeof(OAutoPrewarmEntry), autoprewarm_entry_cmp);
+
+	header.magic = AUTOPREWARM_MAGIC;
+	header.binaryVersion = ORIOLEDB_BINARY_VERSION;
+	header.count = count;
+
+	tmpFilename = psprintf("%s.%d.tmp", AUTOPREWARM_FILENAME, MyProcPid);
+	file = AllocateFile(tmpFilename, PG_BINARY_W);
+	if (!file)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not open file \"%s\": %m", tmpFilename)));
+
+	if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+		(count > 0 &&
+		 fwrite(entries, sizeof(OAutoPrewarmEntry), count, file) != count))
+	{
+		int			save_errno = errno;
+
+		FreeFile(file);
+		unlink(tmpFilename);
+		errno = save_errno;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not write file \"%s\": %m", tmpFilename)));
+	}
+
+	if (FreeFile(file) != 0)
+	{
+		int			save_errno = errno;
+
+		unlink(tmpFilename);
+		errno = save_errno;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not close file \"%s\": %m", tmpFilename)));
+	}
+
+	(void) durable_rename(tmpFilename, AUTOPREWARM_FILENAME, ERROR);
+
+	pfree(tmpFilename);
+	pfree(entries);
+
+	return (int64) count;
+}
+
+/*
+ * Returns true if warm-up can load more pages to the pool.  We stop earlier
+ * than the background writer starts evictions.
+ */
+static bool
+autoprewarm_can_continue(OPagePool *pool)
+{
+	return !shutdown_requested &&
+		ppool_free_pages_count(pool) > pool->size / 10;
+}
+
+/*
+ * Chooses the lowest usage level, which pages fit the free space of the main
+ * pool together with hotter pages.
+ */
+static int
+autoprewarm_min_usage(OAutoPrewarmHeader *header)
+{
+	OPagePool  *pool = get_ppool(OPagePoolMain);
+	int64		budget;
+	int			usage = UCM_USAGE_LEVELS - 1;
+
+	budget = (int64) ppool_free_pages_count(pool) - (int64) (pool->size / 10);
+	budget -= header->usageCounts[usage];
+	while (usage > 0 && budget >= (int64) header->usageCounts[usage - 1])
+	{
+		usage--;
+		budget -= header->usageCounts[usage];
+	}
+	return usage;
+}
+
+/*
+ * Loads pages of the tree having given on-disk offsets.  Returns false if the
+ * warm-up should be stopped.
+ */
+static bool
+autoprewarm_tree(ORelOids oids, OIndexType type,
+				 OAutoPrewarmEntry *entries, int nentries, int64 *loaded)
+{
+	OBTreeFindPageContext context;
+	BTreeDescr *desc;
+	OAutoPrewarmPage *pages,
+			   *nextPages;
+	uint64	   *offsets;
+	int			npages,
+				nextPagesAllocated,
+				nnextPages,
+				level,
+				minLevel = ORIOLEDB_MAX_DEPTH,
+				i;
+
+	if (IS_SYS_TREE_OIDS(oids))
+	{
+		if (sys_tree_get_storage_type(oids.relnode) == BTreeStorageInMemory)
+			return true;
+		desc = get_sys_tree(oids.relnode);
+	}
+	else
+	{
+		OIndexDescr *indexDescr;
+		bool		nested;
+
+		indexDescr = o_fetch_index_descr(oids, type, false, &nested);
+		if (indexDescr == NULL)
+			return true;
+		desc = &indexDescr->desc;
+		o_btree_load_shmem(desc);
+	}
+
+	offsets = (uint64 *) palloc(sizeof(uint64) * nentries);
+	for (i = 0; i < nentries; i++)
+	{
+		offsets[i] = entries[i].offset;
+		minLevel = Min(minLevel, entries[i].level);
+	}
+
+	init_page_find_context(&context, desc, COMMITSEQNO_INPROGRESS,
+						   BTREE_PAGE_FIND_IMAGE);
+
+	pages = (OAutoPrewarmPage *) palloc(sizeof(OAutoPrewarmPage));
+	O_TUPLE_SET_NULL(pages[0].lokey);
+	pages[0].offset = InvalidFileExtentOff;
+	npages = 1;
+	level = PAGE_GET_LEVEL(O_GET_IN_MEMORY_PAGE(desc->rootInfo.rootPageBlkno));
+
+	for (; level >= minLevel && npages > 0; level--)
+	{
+		nextPagesAllocated = 16;
+		nextPages = (OAutoPrewarmPage *) palloc(sizeof(OAutoPrewarmPage) *
+												nextPagesAllocated);
+		nnextPages = 0;
+
+		if (npages > 1)
+			qsort(pages, npages, sizeof(OAutoPrewarmPage),
+				  autoprewarm_page_cmp);
+
+		for (i = 0; i < npages; i++)
+		{
+			BTreePageItemLocator loc;
+			Page		img = context.img;
+
+			if (!autoprewarm_can_continue(desc->ppool))
+				return false;
+
+			if (O_TUPLE_IS_NULL(pages[i].lokey))
+				(void) find_page(&context, NULL, BTreeKeyNone, level);
+			else
+				(void) find_page(&context, &pages[i].lokey,
+								 BTreeKeyNonLeafKey, level);
+
+			if (PAGE_GET_LEVEL(img) != level)
+				continue;
+			if (FileExtentOffIsValid(pages[i].offset))
+				(*loaded)++;
+			if (level == minLevel)
+				continue;
+
+			BTREE_PAGE_FOREACH_ITEMS(img, &loc)
+			{
+				BTreeNonLeafTuphdr *tuphdr;
+				OAutoPrewarmPage *child;
+				uint64		offset;
+				OTuple		key;
+
+				BTREE_PAGE_READ_INTERNAL_ITEM(tuphdr, key, img, &loc);
+
+				/*
+				 * Visit the child if it's to be loaded, or if it's in-memory
+				 * internal page, which might have children to be loaded.
+				 */
+				if (DOWNLINK_IS_ON_DISK(tuphdr->downlink))
+				{
+					offset = DOWNLINK_GET_DISK_OFF(tuphdr->downlink);
+					if (!bsearch(&offset, offsets, nentries, sizeof(uint64),
+								 uint64_cmp))
+						continue;
+				}
+				else if (DOWNLINK_IS_IN_MEMORY(tuphdr->downlink) &&
+						 level - 1 > minLevel)
+				{
+					offset = InvalidFileExtentOff;
+				}
+				else
+				{
+					continue;
+				}
+
+				if (nnextPages >= nextPagesAllocated)
+				{
+					nextPagesAllocated *= 2;
+					nextPages = (OAutoPrewarmPage *)
+						repalloc(nextPages,
+								 sizeof(OAutoPrewarmPage) * nextPagesAllocated);
+				}
+				child = &nextPages[nnextPages++];
+				child->offset = offset;
+
+				if (BTREE_PAGE_LOCATOR_GET_OFFSET(img, &loc) == 0)
+				{
+					/* The first child shares the lokey with its parent */
+					child->lokey = pages[i].lokey;
+				}
+				else
+				{
+					int			len = o_btree_len(desc, key, OKeyLength);
+
+					child->lokey.formatFlags = key.formatFlags;
+					child->lokey.data = palloc(len);
+					memcpy(child->lokey.data, key.data, len);
+				}
+			}
+		}
+
+		pfree(pages);
+		pages = nextPages;
+		npages = nnextPages;
+	}
+
+	return true;
+}
+
+/*
+ * Loads the trees of the autoprewarm file having tree number % nparts ==
+ * part.
+ */
+static void
+autoprewarm_load_part(int part, int nparts)
+{
+	MemoryContext treeContext,
+				oldContext;
+	OAutoPrewarmHeader header;
+	OAutoPrewarmEntry entry;
+	OAutoPrewarmEntry *entries;
+	FILE	   *file;
+	uint64		i;
+	int			nentries = 0,
+				entriesAllocated = 64,
+				minUsage;
+	int64		treeNum = -1,
+				loaded = 0;
+	bool		stop = false;
+
+	file = AllocateFile(AUTOPREWARM_FILENAME, PG_BINARY_R);
+	if (!file)
+	{
+		if (errno != ENOENT)
+			ereport(LOG,
+					(errcode_for_file_access(),
+					 errmsg("could not open file \"%s\": %m",
+							AUTOPREWARM_FILENAME)));
+		return;
+	}
+
+	if (fread(&header, sizeof(header), 1, file) != 1 ||
+		header.magic != AUTOPREWARM_MAGIC ||
+		header.binaryVersion != ORIOLEDB_BINARY_VERSION)
+	{
+		ereport(LOG,
+				(errmsg("invalid orioledb autoprewarm file \"%s\"",
+						AUTOPREWARM_FILENAME)));
+		FreeFile(file);
+		return;
+	}
+
+	minUsage = autoprewarm_min_usage(&header);
+	treeContext = AllocSetContextCreate(CurrentMemoryContext,
+										"orioledb autoprewarm tree context",
+										ALLOCSET_DEFAULT_SIZES);
+	entries = (OAutoPrewarmEntry *) palloc(sizeof(OAutoPrewarmEntry) *
+										   entriesAllocated);
+
+	for (i = 0; i <= header.count && !stop; i++)
+	{
+		bool		last = (i == header.count);
+
+		if (!last && fread(&entry, sizeof(entry), 1, file) != 1)
+		{
+			ereport(LOG,
+					(errmsg("orioledb autoprewarm file \"%s\" is truncated",
+							AUTOPREWARM_FILENAME)));
+			last = true;
+		}
+
+		/* Entries are sorted by tree, so the tree ends on a new one */
+		if (last || treeNum < 0 ||
+			!ORelOidsIsEqual(entry.oids, entries[0].oids) ||
+			entry.type != entries[0].type)
+		{
+			if (nentries > 0)
+			{
+				oldContext = MemoryContextSwitchTo(treeContext);
+				stop = !autoprewarm_tree(entries[0].oids, entries[0].type,
+										 entries, nentries, &loaded);
+				MemoryContextSwitchTo(oldContext);
+				MemoryContextReset(treeContext);
+			}
+			if (last)
+				break;
+			nentries = 0;
+			treeNum++;
+			entries[0] = entry;
+		}
+
+		if (treeNum % nparts != part || entry.usage < minUsage)
+			continue;
+
+		if (nentries >= entriesAllocated)
+		{
+			entriesAllocated *= 2;
+			entries = (OAutoPrewarmEntry *)
+				repalloc_huge(entries,
+							  sizeof(OAutoPrewarmEntry) * entriesAllocated);
+		}
+		entries[nentries++] = entry;
+	}
+
+	FreeFile(file);
+	pfree(entries);
+	MemoryContextDelete(treeContext);
+
+	elog(LOG, "orioledb autoprewarm worker %d loaded " INT64_FORMAT " pages",
+		 part, loaded);
+}
+
+static void
+autoprewarm_process_init(void)
+{
+	/* enable timeout for relation lock */
+	RegisterTimeout(DEADLOCK_TIMEOUT, CheckDeadLockAlert);
+
+	/* enable relation cache invalidation (remove old OTableDescr) */
+	RelationCacheInitialize();
+	InitCatalogCache();
+	SharedInvalBackendInit(false);
+
+	SetProcessingMode(NormalProcessing);
+
+	pqsignal(SIGTERM, handle_sigterm);
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	BackgroundWorkerUnblockSignals();
+
+	CurTransactionContext = AllocSetContextCreate(TopMemoryContext,
+												  "orioledb autoprewarm current transaction context",
+												  ALLOCSET_DEFAULT_SIZES);
+	TopTransactionContext = AllocSetContextCreate(TopMemoryContext,
+												  "orioledb autoprewarm top transaction context",
+												  ALLOCSET_DEFAULT_SIZES);
+	MemoryContextSwitchTo(CurTransactionContext);
+}
+
+/*
+ * Warms up the page pool using dynamic workers, then periodically dumps the
+ * pool contents.
+ */
+void
+autoprewarm_main(Datum main_arg)
+{
+	BackgroundWorkerHandle **handles;
+	int			nparts = autoprewarm_workers,
+				i;
+
+	autoprewarm_process_init();
+
+	elog(LOG, "orioledb autoprewarm leader started");
+
+	/* The leader handles the first part itself */
+	handles = (BackgroundWorkerHandle **)
+		palloc0(sizeof(BackgroundWorkerHandle *) * nparts);
+	if (access(AUTOPREWARM_FILENAME, F_OK) == 0)
+	{
+		for (i = 1; i < nparts; i++)
+			handles[i] = register_autoprewarm_worker(i, nparts);
+		for (i = 0; i < nparts; i++)
+		{
+			if (!handles[i])
+				autoprewarm_load_part(i, nparts);
+		}
+		for (i = 1; i < nparts; i++)
+		{
+			if (handles[i])
+				(void) WaitForBackgroundWorkerShutdown(handles[i]);
+		}
+	}
+	pfree(handles);
+	MemoryContextReset(CurTransactionContext);
+
+	while (!shutdown_requested)
+	{
+		int			rc,
+					wake_events = WL_LATCH_SET | WL_POSTMASTER_DEATH;
+
+		if (autoprewarm_interval > 0)
+			wake_events |= WL_TIMEOUT;
+
+		rc = WaitLatch(MyLatch, wake_events,
+					   (long) autoprewarm_interval * 1000L,
+					   PG_WAIT_EXTENSION);
+		ResetLatch(MyLatch);
+
+		if (rc & WL_POSTMASTER_DEATH)
+			proc_exit(1);
+
+		if (ConfigReloadPending)
+		{
+			ConfigReloadPending = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		if (!shutdown_requested && (rc & WL_TIMEOUT))
+		{
+			(void) autoprewarm_dump();
+			MemoryContextReset(CurTransactionContext);
+		}
+	}
+
+	(void) autoprewarm_dump();
+	elog(LOG, "orioledb autoprewarm leader is shut down");
+}
+
+void
+autoprewarm_worker_main(Datum main_arg)
+{
+	int			part = DatumGetInt32(main_arg);
+	int			nparts;
+
+	memcpy(&nparts, MyBgworkerEntry->bgw_extra, sizeof(nparts));
+
+	autoprewarm_process_init();
+	autoprewarm_load_part(part, nparts);
+}
+
+Datum
+orioledb_autoprewarm_dump(PG_FUNCTION_ARGS)
+{
+	orioledb_check_shmem();
+
+	PG_RETURN_INT64(autoprewarm_dump());
+}
@@ -356,6 +356,29 @@ SELECT explain_as_json($$
 			   SELECT * FROM o_explain_json ORDER BY val_1;
 	   $$)->0->'Plan'->'Actual Rows';
 
+CREATE TABLE o_explain_deform (
+	id int PRIMARY KEY,
+	a int,
+	b text
+) USING orioledb;
+INSERT INTO o_explain_deform
+	SELECT i, i % 10, 'x' FROM generate_series(1, 100) i;
+BEGIN;
+SET LOCAL enable_seqscan = off;
+SET LOCAL enable_bitmapscan = off;
+-- "a = 3" is checked before deforming, only "id" is deformed for the result
+SELECT p->'Rows Skipped Before Deforming' AS skipped,
+	   p->'Rows Removed by Filter' AS removed,
+	   p->'Rows Deformed' AS deformed,
+	   p->'Attributes Deformed' AS attrs
+FROM (SELECT explain_as_json($$
+		   EXPLAIN (FORMAT json, ANALYZE, VERBOSE)
+			   SELECT id FROM o_explain_deform WHERE a = 3 AND id > 50;
+	   $$)->0->'Plan' AS p) t;
+SELECT id FROM o_explain_deform WHERE a = 3 AND id > 50;
+COMMIT;
+DROP TABLE o_explain_deform;
+
 DROP EXTENSION orioledb CASCADE;
 DROP SCHEMA explain CASCADE;
 RESET search_path;
@@ -344,6 +344,26 @@ EXPLAIN (COSTS OFF)
 SELECT * FROM o_test_pkey_include_same_field;
 COMMIT;
 
+CREATE TABLE o_test_deform
+(
+	id int PRIMARY KEY,
+	c1 "char",
+	i2 smallint,
+	t1 text,
+	i8 bigint,
+	t2 text,
+	f8 float8
+) USING orioledb;
+INSERT INTO o_test_deform VALUES (1, 'a', 2, 'x', 3, 'yy', 4.5),
+								 (2, NULL, 5, NULL, 6, 'zz', NULL),
+								 (3, 'b', NULL, 'w', NULL, NULL, 7.5);
+ALTER TABLE o_test_deform ADD COLUMN i4 int DEFAULT 10;
+INSERT INTO o_test_deform VALUES (4, 'c', 8, 'v', 9, 'uu', 1.5, 11);
+SELECT * FROM o_test_deform ORDER BY id;
+SELECT i2, id FROM o_test_deform ORDER BY id;
+SELECT f8, i4 FROM o_test_deform ORDER BY id;
+DROP TABLE o_test_deform;
+
 DROP EXTENSION orioledb CASCADE;
 DROP SCHEMA getsomeattrs CASCADE;
 RESET search_path;
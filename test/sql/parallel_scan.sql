@@ -438,17 +438,79 @@ SET LOCAL enable_seqscan = off;
 EXPLAIN (COSTS OFF)
     SELECT count(*) FROM o_test_no_parallel_bitmap_scan WHERE val_1 >= 10 AND val_1 < 50;
 SELECT count(*) FROM o_test_no_parallel_bitmap_scan WHERE val_1 >= 10 AND val_1 < 50;
--- Parallel Bitmap Heap Scan is not implemented yet, so it doesn't used here
+-- Bitmap Heap Scan isn't used for such a small table
 EXPLAIN (COSTS OFF)
     SELECT count(*) FROM o_test_no_parallel_bitmap_scan WHERE val_1 <@ int4range(10,50);
 SELECT count(*) FROM o_test_no_parallel_bitmap_scan WHERE val_1 <@ int4range(10,50);
--- Parallel Bitmap Heap Scan is not implemented yet, so it doesn't used here
+-- Bitmap Heap Scan isn't used for such a small table
 EXPLAIN (COSTS OFF)
 	SELECT * FROM o_test_no_parallel_bitmap_scan WHERE val_1 <@ int4range(10,50);
 SELECT * FROM o_test_no_parallel_bitmap_scan WHERE val_1 <@ int4range(10,50);
 
 COMMIT;
 
+CREATE TABLE o_test_parallel_index_scan_range (
+	id int PRIMARY KEY,
+	i int NOT NULL,
+	j int NOT NULL
+) USING orioledb;
+CREATE INDEX o_test_parallel_index_scan_range_ix1
+	ON o_test_parallel_index_scan_range (i);
+INSERT INTO o_test_parallel_index_scan_range
+	SELECT v, v, v * 2 FROM generate_series(1, 100000) v;
+ANALYZE o_test_parallel_index_scan_range;
+
+BEGIN;
+SET LOCAL max_parallel_workers_per_gather = 1;
+SET LOCAL parallel_setup_cost = 0;
+SET LOCAL parallel_tuple_cost = 0;
+SET LOCAL min_parallel_table_scan_size = 0;
+SET LOCAL min_parallel_index_scan_size = 0;
+SET LOCAL enable_seqscan = off;
+SET LOCAL enable_bitmapscan = off;
+
+-- Participants split the key range of secondary index into chunks
+EXPLAIN (COSTS OFF)
+	SELECT count(*), sum(i) FROM o_test_parallel_index_scan_range
+		WHERE i >= 1000 AND i < 90000;
+SELECT count(*), sum(i) FROM o_test_parallel_index_scan_range
+	WHERE i >= 1000 AND i < 90000;
+EXPLAIN (COSTS OFF)
+	SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range
+		WHERE i >= 1000 AND i < 90000;
+SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range
+	WHERE i >= 1000 AND i < 90000;
+SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range WHERE i > 0;
+-- Backward scans, array keys and exact lookups are done by one participant
+SELECT i FROM o_test_parallel_index_scan_range
+	WHERE i > 99990 ORDER BY i DESC;
+SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range
+	WHERE i = ANY(ARRAY[5, 500, 50000, 99999]);
+SELECT j FROM o_test_parallel_index_scan_range WHERE i = 777;
+COMMIT;
+
+BEGIN;
+SET LOCAL max_parallel_workers_per_gather = 1;
+SET LOCAL parallel_setup_cost = 0;
+SET LOCAL parallel_tuple_cost = 0;
+SET LOCAL min_parallel_table_scan_size = 0;
+SET LOCAL min_parallel_index_scan_size = 0;
+SET LOCAL enable_seqscan = off;
+SET LOCAL enable_indexscan = off;
+SET LOCAL enable_indexonlyscan = off;
+-- The first participant builds the bitmap, then all of them scan the table
+EXPLAIN (COSTS OFF)
+	SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range
+		WHERE i >= 1000 AND i < 90000;
+SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range
+	WHERE i >= 1000 AND i < 90000;
+EXPLAIN (COSTS OFF)
+	SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range
+		WHERE i < 100 OR i > 99900;
+SELECT count(*), sum(j) FROM o_test_parallel_index_scan_range
+	WHERE i < 100 OR i > 99900;
+COMMIT;
+
 DROP EXTENSION orioledb CASCADE;
 DROP SCHEMA parallel_scan CASCADE;
 RESET search_path;
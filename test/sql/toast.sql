@@ -584,6 +584,48 @@ EXPLAIN (COSTS OFF) SELECT * FROM o_test_toast_update_delete ORDER BY v1;
 SELECT * FROM o_test_toast_update_delete ORDER BY v1;
 COMMIT;
 
+-- Several TOASTed values of the same row are fetched at once
+CREATE TABLE o_test_toast_batch (
+	id int PRIMARY KEY,
+	v1 text, v2 text, v3 text, v4 text,
+	v5 text, v6 text, v7 text, v8 text
+) USING orioledb;
+CREATE INDEX o_test_toast_batch_idx1 ON o_test_toast_batch (v1, v2);
+INSERT INTO o_test_toast_batch
+	SELECT i, generate_string(i, 600), generate_string(i + 10, 600),
+		   generate_string(i + 20, 600), generate_string(i + 30, 600),
+		   generate_string(i + 40, 600), generate_string(i + 50, 600),
+		   generate_string(i + 60, 600), generate_string(i + 70, 600)
+	FROM generate_series(1, 5) i;
+UPDATE o_test_toast_batch SET v3 = generate_string(id + 80, 600)
+	WHERE id % 2 = 0;
+DELETE FROM o_test_toast_batch WHERE id = 5;
+SELECT id,
+	   v1 = generate_string(id, 600) AND v2 = generate_string(id + 10, 600) AND
+	   v3 = generate_string(id + CASE WHEN id % 2 = 0 THEN 80 ELSE 20 END, 600) AND
+	   v4 = generate_string(id + 30, 600) AND v5 = generate_string(id + 40, 600) AND
+	   v6 = generate_string(id + 50, 600) AND v7 = generate_string(id + 60, 600) AND
+	   v8 = generate_string(id + 70, 600) AS ok
+	FROM o_test_toast_batch ORDER BY id;
+BEGIN;
+SET LOCAL enable_seqscan = off;
+SELECT id FROM o_test_toast_batch
+	WHERE v1 = generate_string(3, 600) AND v2 = generate_string(13, 600);
+COMMIT;
+-- Only the requested TOASTed values are fetched
+SELECT id, v2 = generate_string(id + 10, 600) AND
+		   v7 = generate_string(id + 60, 600) AS ok
+	FROM o_test_toast_batch ORDER BY id;
+BEGIN;
+UPDATE o_test_toast_batch SET v2 = generate_string(id + 90, 600)
+	WHERE id = 1;
+SELECT id,
+	   v2 = generate_string(id + CASE WHEN id = 1 THEN 90 ELSE 10 END, 600) AND
+	   v7 = generate_string(id + 60, 600) AS ok
+	FROM o_test_toast_batch ORDER BY id;
+ROLLBACK;
+DROP TABLE o_test_toast_batch;
+
 SELECT orioledb_parallel_debug_stop();
 DROP EXTENSION orioledb CASCADE;
 DROP SCHEMA toast CASCADE;
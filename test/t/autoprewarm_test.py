@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+import os
+import re
+import time
+
+from .base_test import BaseTest
+
+
+class AutoprewarmTest(BaseTest):
+
+	def wait_prewarm_loaded(self, node, nworkers):
+		pattern = re.compile(r'orioledb autoprewarm worker \d+ loaded (\d+) pages')
+		for _ in range(300):
+			with open(node.pg_log_file) as f:
+				loaded = [int(m) for m in pattern.findall(f.read())]
+			if len(loaded) >= nworkers:
+				return sum(loaded)
+			time.sleep(0.1)
+		self.fail("autoprewarm didn't finish")
+
+	def test_autoprewarm(self):
+		node = self.node
+		node.append_conf(
+		    'postgresql.conf', "orioledb.autoprewarm = on\n"
+		    "orioledb.autoprewarm_workers = 2\n")
+		node.start()
+		node.safe_psql(
+		    'postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;\n"
+		    "CREATE TABLE o_test (\n"
+		    "	id integer NOT NULL PRIMARY KEY,\n"
+		    "	val text NOT NULL\n"
+		    ") USING orioledb;\n"
+		    "CREATE INDEX o_test_val_idx ON o_test (val);\n"
+		    "INSERT INTO o_test\n"
+		    "	(SELECT id, repeat(id::text, 20) FROM generate_series(1, 20000) id);\n"
+		    "CHECKPOINT;\n")
+		self.assertGreater(
+		    node.execute("SELECT orioledb_autoprewarm_dump();")[0][0], 0)
+		self.assertTrue(
+		    os.path.exists(
+		        os.path.join(node.data_dir, 'orioledb_data', 'autoprewarm')))
+		node.stop()
+
+		node.start()
+		self.assertGreater(self.wait_prewarm_loaded(node, 2), 0)
+		self.assertTrue(
+		    node.execute("SELECT orioledb_tbl_check('o_test'::regclass);")[0]
+		    [0])
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM o_test;")[0][0], 20000)
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM "
+		                 "(SELECT * FROM o_test ORDER BY val) x;")[0][0], 20000)
+		node.stop()
+
+	def test_autoprewarm_no_file(self):
+		node = self.node
+		node.append_conf('postgresql.conf', "orioledb.autoprewarm = on\n")
+		node.start()
+		node.safe_psql(
+		    'postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;\n"
+		    "CREATE TABLE o_test (\n"
+		    "	id integer NOT NULL PRIMARY KEY\n"
+		    ") USING orioledb;\n"
+		    "INSERT INTO o_test (SELECT generate_series(1, 100));\n")
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM o_test;")[0][0], 100)
+		node.stop()
+
+		# The dump is written at shutdown
+		self.assertTrue(
+		    os.path.exists(
+		        os.path.join(node.data_dir, 'orioledb_data', 'autoprewarm')))
@@ -169,6 +169,51 @@ class EvictionCompressionTest(BaseTest):
 		con.close()
 		node.stop()
 
+	def test_eviction_compress_free_extents_reuse(self):
+		node = self.node
+		node.append_conf('postgresql.conf', "orioledb.main_buffers = 8MB\n")
+		node.start()
+		node.safe_psql(
+		    'postgres', """
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE IF NOT EXISTS o_test (
+				key integer NOT NULL,
+				val text NOT NULL,
+				PRIMARY KEY (key)
+			) USING orioledb WITH (primary_compress);
+			INSERT INTO o_test
+				(SELECT id, repeat(id::text, 10) FROM generate_series(1, 50000) id);
+			CHECKPOINT;
+			""")
+
+		for i in range(1, 6):
+			node.safe_psql(
+			    'postgres', """
+				UPDATE o_test SET val = repeat((key + %d)::text, 10 + %d)
+					WHERE key %% 3 = %d;
+				CHECKPOINT;
+				""" % (i, i % 3, i % 3))
+			self.assertTrue(
+			    node.execute(
+			        "SELECT orioledb_tbl_check('o_test'::regclass, true);")[0]
+			    [0])
+
+		node.safe_psql('postgres',
+		               "SELECT orioledb_evict_pages('o_test'::regclass, 0);")
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM o_test;")[0][0], 50000)
+		node.stop()
+
+		node.start()
+		self.assertTrue(
+		    node.execute(
+		        "SELECT orioledb_tbl_check('o_test'::regclass, true);")[0][0])
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM o_test "
+		                 "WHERE val = repeat((key + 5)::text, 12);")[0][0],
+		    len([k for k in range(1, 50001) if k % 3 == 2]))
+		node.stop()
+
 
 if __name__ == "__main__":
 	unittest.main()
@@ -56,6 +56,110 @@ class EvictionTest(BaseTest):
 		con1.close()
 		node.stop()
 
+	def test_eviction_stat(self):
+		node = self.node
+		node.append_conf('postgresql.conf', "orioledb.main_buffers = 8MB\n")
+		node.start()
+		node.safe_psql(
+		    'postgres', """
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE o_eviction (
+				id integer NOT NULL,
+				val text,
+				PRIMARY KEY (id)
+			) USING orioledb;
+			INSERT INTO o_eviction
+				(SELECT id, repeat('x', 100)
+				 FROM generate_series(1, 100000, 1) id);
+		""")
+		node.safe_psql('postgres', "CHECKPOINT;")
+		self.assertEqual(
+		    node.execute('postgres',
+		                 "SELECT COUNT(*) FROM o_eviction;")[0][0], 100000)
+
+		page_loads, evictions, writes_checkpointer = node.execute(
+		    'postgres', """
+			SELECT page_loads, evictions_clean + evictions_dirty,
+				   writes_checkpointer
+			FROM orioledb_stat_global;
+		""")[0]
+		self.assertGreater(page_loads, 0)
+		self.assertGreater(evictions, 0)
+		self.assertGreater(writes_checkpointer, 0)
+
+		tree_page_loads = node.execute(
+		    'postgres', """
+			SELECT sum(page_loads) FROM orioledb_stat_trees
+			WHERE table_reloid = 'o_eviction'::regclass;
+		""")[0][0]
+		self.assertGreater(tree_page_loads, 0)
+
+		node.safe_psql('postgres',
+		               "SELECT orioledb_evict_pages('o_eviction'::regclass, 0);")
+		evictions, on_demand, bgwriter, explicit = node.execute(
+		    'postgres', """
+			SELECT evictions_clean + evictions_dirty, evictions_on_demand,
+				   evictions_bgwriter, evictions_explicit
+			FROM orioledb_stat_global;
+		""")[0]
+		self.assertGreater(explicit, 0)
+		self.assertEqual(evictions, on_demand + bgwriter + explicit)
+
+		node.safe_psql('postgres', "SELECT orioledb_stat_reset();")
+		self.assertEqual(
+		    node.execute(
+		        'postgres',
+		        "SELECT page_loads FROM orioledb_stat_global;")[0][0], 0)
+		node.stop()
+
+	def test_eviction_stat_dropped_trees(self):
+		node = self.node
+		node.append_conf('postgresql.conf', "orioledb.stat_max_trees = 16\n")
+		node.start()
+		node.safe_psql('postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;")
+
+		def create_table(name):
+			node.safe_psql(
+			    'postgres', """
+				CREATE TABLE %s (
+					id integer NOT NULL PRIMARY KEY,
+					val text
+				) USING orioledb;
+				INSERT INTO %s
+					(SELECT id, repeat('x', 100)
+					 FROM generate_series(1, 1000) id);
+				SELECT orioledb_evict_pages('%s'::regclass, 0);
+			""" % (name, name, name))
+
+		# Entries of the dropped trees are reused by the new ones
+		dropped = []
+		for i in range(20):
+			create_table('o_stat_%d' % i)
+			relnodes = node.execute("""
+				SELECT relnode FROM orioledb_stat_trees
+				WHERE table_reloid = 'o_stat_%d'::regclass AND
+					  evictions_explicit > 0;
+			""" % i)
+			self.assertGreater(len(relnodes), 0)
+			dropped += [str(x[0]) for x in relnodes]
+			node.safe_psql('postgres', "DROP TABLE o_stat_%d;" % i)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM orioledb_stat_trees
+				WHERE relnode IN (%s);
+			""" % ', '.join(dropped))[0][0], 0)
+
+		# The overflow is reported to the log
+		for i in range(20):
+			create_table('o_stat_keep_%d' % i)
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM orioledb_stat_trees;")[0][0],
+		    16)
+		with open(node.pg_log_file) as f:
+			self.assertIn("orioledb cumulative statistics table is full",
+			              f.read())
+		node.stop()
+
 	def test_eviction_tree(self):
 		INDEX_NOT_LOADED = "Index o_evicted_pkey: not loaded"
 		node = self.node
@@ -229,6 +333,140 @@ class EvictionTest(BaseTest):
 	def test_eviction_compress_after_checkpoint(self):
 		self.eviction_after_checkpoint_base(True)
 
+	def test_eviction_separate_buffers_region(self):
+		node = self.node
+		node.append_conf(
+		    'postgresql.conf', "orioledb.main_buffers = 8MB\n"
+		    "orioledb.buffers_huge_pages = try\n"
+		    "orioledb.buffers_numa = interleave\n")
+		node.start()
+		with open(node.pg_log_file) as f:
+			self.assertIn('orioledb buffers: mapped', f.read())
+		node.safe_psql(
+		    'postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;\n"
+		    "CREATE TABLE o_test (\n"
+		    "	id integer NOT NULL PRIMARY KEY,\n"
+		    "	val text NOT NULL\n"
+		    ") USING orioledb;\n"
+		    "INSERT INTO o_test\n"
+		    "	(SELECT id, repeat('x', 100) FROM generate_series(1, 100000) id);\n"
+		)
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM o_test;")[0][0], 100000)
+		self.assertTrue(
+		    node.execute("SELECT orioledb_tbl_check('o_test'::regclass);")[0]
+		    [0])
+		node.stop()
+
+		node.start()
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM o_test;")[0][0], 100000)
+		node.stop()
+
+	def test_eviction_adaptive_buffers(self):
+		node = self.node
+		node.append_conf(
+		    'postgresql.conf', "orioledb.debug_disable_pools_limit = true\n"
+		    "orioledb.main_buffers = 16MB\n"
+		    "orioledb.catalog_buffers = 256kB\n"
+		    "orioledb.adaptive_buffers = true\n")
+		node.start()
+		node.safe_psql('postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;")
+		for i in range(300):
+			node.safe_psql(
+			    'postgres', "CREATE TABLE o_test_%d (\n"
+			    "	id integer NOT NULL PRIMARY KEY,\n"
+			    "	val_%d text NOT NULL\n"
+			    ") USING orioledb;\n"
+			    "CREATE INDEX o_test_%d_ix ON o_test_%d (val_%d);\n"
+			    "INSERT INTO o_test_%d VALUES (1, 'x');\n" %
+			    (i, i, i, i, i, i))
+
+		borrows, current, size = node.execute(
+		    "SELECT borrows, current_pages, all_pages "
+		    "FROM orioledb_page_pools WHERE pool_name = 'catalog';")[0]
+		self.assertGreater(borrows, 0)
+		self.assertGreaterEqual(current, size)
+		self.assertEqual(
+		    node.execute("SELECT sum(lent_pages) - sum(borrowed_pages) "
+		                 "FROM orioledb_page_pools;")[0][0], 0)
+
+		node.safe_psql(
+		    'postgres', "CREATE TABLE o_big (\n"
+		    "	id integer NOT NULL PRIMARY KEY,\n"
+		    "	val text NOT NULL\n"
+		    ") USING orioledb;\n"
+		    "INSERT INTO o_big\n"
+		    "	(SELECT id, repeat('x', 100) FROM generate_series(1, 200000) id);\n"
+		)
+		self.assertGreater(
+		    node.execute("SELECT evictions FROM orioledb_page_pools "
+		                 "WHERE pool_name = 'main';")[0][0], 0)
+		for i in range(0, 300, 30):
+			self.assertEqual(
+			    node.execute("SELECT val_%d FROM o_test_%d WHERE id = 1;" %
+			                 (i, i))[0][0], 'x')
+		self.assertTrue(
+		    node.execute("SELECT orioledb_tbl_check('o_big'::regclass);")[0]
+		    [0])
+		node.stop()
+
+		node.start()
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM o_big;")[0][0], 200000)
+		self.assertEqual(
+		    node.execute("SELECT val_299 FROM o_test_299;")[0][0], 'x')
+		node.stop()
+
+	def test_eviction_adaptive_buffers_reload(self):
+		node = self.node
+		node.append_conf(
+		    'postgresql.conf', "orioledb.debug_disable_pools_limit = true\n"
+		    "orioledb.main_buffers = 16MB\n"
+		    "orioledb.catalog_buffers = 256kB\n"
+		    "orioledb.adaptive_buffers = true\n")
+		node.start()
+		node.safe_psql('postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;")
+		for i in range(300):
+			node.safe_psql(
+			    'postgres', "CREATE TABLE o_test_%d (\n"
+			    "	id integer NOT NULL PRIMARY KEY,\n"
+			    "	val_%d text NOT NULL\n"
+			    ") USING orioledb;\n"
+			    "INSERT INTO o_test_%d VALUES (1, 'x');\n" % (i, i, i))
+		self.assertGreater(
+		    node.execute("SELECT borrowed_pages FROM orioledb_page_pools "
+		                 "WHERE pool_name = 'catalog';")[0][0], 0)
+		node.safe_psql('postgres', "CHECKPOINT;")
+
+		# Evict borrowed catalog pages, then load them back several times
+		for j in range(3):
+			node.safe_psql(
+			    'postgres', "CREATE TABLE o_big_%d (\n"
+			    "	id integer NOT NULL PRIMARY KEY,\n"
+			    "	val text NOT NULL\n"
+			    ") USING orioledb;\n"
+			    "INSERT INTO o_big_%d\n"
+			    "	(SELECT id, repeat('x', 100)\n"
+			    "	 FROM generate_series(1, 150000) id);\n"
+			    "CHECKPOINT;\n" % (j, j))
+			for i in range(300):
+				self.assertEqual(
+				    node.execute("SELECT val_%d FROM o_test_%d WHERE id = 1;" %
+				                 (i, i))[0][0], 'x')
+			self.assertTrue(node.execute("SELECT orioledb_ucm_check();")[0][0])
+			self.assertEqual(
+			    node.execute("SELECT sum(lent_pages) - sum(borrowed_pages) "
+			                 "FROM orioledb_page_pools;")[0][0], 0)
+		self.assertGreater(
+		    node.execute("SELECT evictions FROM orioledb_page_pools "
+		                 "WHERE pool_name = 'main';")[0][0], 0)
+		for num in (2, 3):
+			self.assertTrue(
+			    node.execute("SELECT orioledb_sys_tree_check(%d);" %
+			                 num)[0][0])
+		node.stop()
+
 	def test_eviction_after_checkpoint_con1(self):
 		node = self.node
 		node.append_conf(
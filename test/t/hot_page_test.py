@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+import unittest
+import testgres
+
+from .base_test import BaseTest
+from .base_test import ThreadQueryExecutor
+
+
+class HotPageTest(BaseTest):
+
+	def concurrent_updates(self, node, query, nthreads):
+		connections = [
+		    node.connect(autocommit=True) for _ in range(nthreads)
+		]
+		threads = [
+		    ThreadQueryExecutor(con, query) for con in connections
+		]
+		for t in threads:
+			t.start()
+		for t in threads:
+			t.join()
+		for con in connections:
+			con.close()
+
+	def test_hot_page_counters(self):
+		node = self.node
+		node.append_conf('postgresql.conf',
+		                 "orioledb.wait_sample_interval = 1\n")
+		node.start()
+		node.safe_psql(
+		    'postgres', """
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE o_counters (
+				id int PRIMARY KEY,
+				value bigint NOT NULL
+			) USING orioledb;
+			INSERT INTO o_counters SELECT i, 0 FROM generate_series(1, 4) i;
+		""")
+
+		self.concurrent_updates(
+		    node, """
+			DO $$
+			BEGIN
+				FOR i IN 1..1000 LOOP
+					UPDATE o_counters SET value = value + 1
+						WHERE id = i % 4 + 1;
+					COMMIT;
+				END LOOP;
+			END $$;
+		""", 8)
+		self.assertEqual(
+		    node.execute("SELECT sum(value), min(value), max(value) "
+		                 "FROM o_counters;")[0], (8000, 2000, 2000))
+		self.assertTrue(
+		    node.execute("SELECT orioledb_tbl_check('o_counters'::regclass)")
+		    [0][0])
+
+		# Every wait is sampled and falls into exactly one histogram bucket
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM orioledb_stat_waits
+				WHERE sampled_waits <> waits OR
+					  (SELECT sum(h) FROM unnest(wait_histogram) h) <> waits OR
+					  array_length(wait_histogram, 1) <> 8;
+			""")[0][0], 0)
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM orioledb_stat_waits "
+		                 "WHERE datoid IS NULL;")[0][0], 4)
+		node.stop()
@@ -654,6 +654,80 @@ class IndicesBuildTest(BaseTest):
 		    'o_indices_ix1')
 		node.stop()
 
+	def test_create_index_concurrently(self):
+		node = self.node
+		node.append_conf('postgresql.conf',
+		                 "orioledb.enable_stopevents = true\n")
+		node.start()
+
+		node.safe_psql("""
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE o_indices
+			(
+				key int NOT NULL,
+				val int,
+				PRIMARY KEY (key)
+			) USING orioledb;
+			INSERT INTO o_indices
+				SELECT i, i + 1000 FROM generate_series(1, 500) AS i;
+		""")
+
+		con1 = node.connect(autocommit=True)
+		con1_pid = con1.pid
+		con2 = node.connect(autocommit=True)
+
+		con2.execute("""
+			SELECT pg_stopevent_set('build_index_placeholder_inserted',
+									'$.treeName == \"o_indices_ix1\"');
+		""")
+		con1_thread = ThreadQueryExecutor(
+		    con1, """
+			CREATE UNIQUE INDEX CONCURRENTLY o_indices_ix1
+				ON o_indices (val);
+		""")
+		con1_thread.start()
+		wait_stopevent(node, con1_pid)
+
+		# Modify the table while the index is being built
+		con2.execute("""
+			INSERT INTO o_indices
+				SELECT i, i + 1000 FROM generate_series(501, 600) AS i;
+		""")
+		con2.execute(
+		    "UPDATE o_indices SET val = val + 10000 WHERE key % 10 = 0;")
+		con2.execute("DELETE FROM o_indices WHERE key % 7 = 0;")
+		con2.execute("""
+			SELECT pg_stopevent_reset('build_index_placeholder_inserted');
+		""")
+		con1_thread.join()
+		con1.close()
+
+		# Modify the table after the index is built
+		con2.execute("UPDATE o_indices SET val = val + 20000 "
+		             "WHERE key % 11 = 0;")
+		con2.execute("DELETE FROM o_indices WHERE key % 13 = 0;")
+		con2.close()
+
+		self.assertTrue(
+		    node.execute("""
+			SELECT indisvalid FROM pg_index
+				WHERE indexrelid = 'o_indices_ix1'::regclass;
+		""")[0][0])
+		self.check_used_index(
+		    node, "SELECT * FROM o_indices WHERE val > 0 ORDER BY val",
+		    'o_indices_ix1')
+		expected = node.execute("""
+			SET enable_indexscan = off;
+			SET enable_bitmapscan = off;
+			SELECT key, val FROM o_indices ORDER BY val;
+		""")
+		self.assertEqual(
+		    node.execute("""
+			SET enable_seqscan = off;
+			SELECT key, val FROM o_indices WHERE val > 0 ORDER BY val;
+		"""), expected)
+		node.stop()
+
 	def get_map_files(self, filter_files):
 		map_files = []
 
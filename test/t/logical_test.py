@@ -70,6 +70,82 @@ class LogicalTest(BaseTest):
 		    "BEGIN\ntable public.data: INSERT: id[integer]:1 data[text]:'1'\ntable public.data: INSERT: id[integer]:2 data[text]:'2'\nCOMMIT\n"
 		)
 
+	@unittest.skipIf(not extension_installed("test_decoding"),
+	                 "'test_decoding' is not installed")
+	def test_stream_in_progress(self):
+		node = self.node
+		node.start()
+		node.safe_psql("""
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE o_stream(
+				id integer primary key,
+				data text
+			) USING orioledb;
+		""")
+		node.safe_psql(
+		    "SELECT * FROM pg_create_logical_replication_slot('stream_slot', 'test_decoding');"
+		)
+
+		node.safe_psql("""
+			BEGIN;
+			INSERT INTO o_stream (SELECT id, repeat('a', 100)
+				FROM generate_series(1, 2000) id);
+			SAVEPOINT s1;
+			INSERT INTO o_stream (SELECT id, repeat('b', 100)
+				FROM generate_series(2001, 4000) id);
+			ROLLBACK TO SAVEPOINT s1;
+			SAVEPOINT s2;
+			INSERT INTO o_stream VALUES (4001, 'c');
+			RELEASE SAVEPOINT s2;
+			DO $$
+			BEGIN
+				INSERT INTO o_stream VALUES (4002, 'd');
+				RAISE EXCEPTION 'rollback';
+			EXCEPTION WHEN others THEN
+				NULL;
+			END $$;
+			INSERT INTO o_stream VALUES (4003, 'e');
+			COMMIT;
+		""")
+
+		rows = node.execute("""
+			SET logical_decoding_work_mem = '64kB';
+			SELECT data FROM pg_logical_slot_get_changes('stream_slot',
+				NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1',
+				'stream-changes', '1');
+		""")
+		lines = [row[0] for row in rows]
+
+		# the transaction is streamed before commit
+		self.assertIn('opening a streamed block for transaction', lines)
+		self.assertLess(lines.index('opening a streamed block for transaction'),
+		                lines.index('committing streamed transaction'))
+		self.assertIn('aborting streamed (sub)transaction', lines)
+		self.assertEqual(lines.count('committing streamed transaction'), 1)
+
+		# rolled back changes aren't committed
+		node.safe_psql(
+		    "SELECT * FROM pg_create_logical_replication_slot('slot', 'test_decoding');"
+		)
+		node.safe_psql("""
+			BEGIN;
+			INSERT INTO o_stream VALUES (5001, 'f');
+			SAVEPOINT s1;
+			INSERT INTO o_stream VALUES (5002, 'g');
+			ROLLBACK TO SAVEPOINT s1;
+			INSERT INTO o_stream VALUES (5003, 'h');
+			COMMIT;
+		""")
+		result = self.squashLogicalChanges(
+		    node.execute(
+		        "SELECT * FROM pg_logical_slot_get_changes('slot', NULL, NULL);"
+		    ))
+		self.assertEqual(
+		    result, "BEGIN\n"
+		    "table public.o_stream: INSERT: id[integer]:5001 data[text]:'f'\n"
+		    "table public.o_stream: INSERT: id[integer]:5003 data[text]:'h'\n"
+		    "COMMIT\n")
+
 	@unittest.skipIf(not extension_installed("wal2json"),
 	                 "'wal2json' is not installed")
 	def test_wal2json(self):
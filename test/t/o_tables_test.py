@@ -257,3 +257,50 @@ class OTablesTest(BaseTest):
 		node.safe_psql('postgres', "CREATE EXTENSION orioledb;\n")
 		self.assertTblCount(0)
 		node.stop()
+
+	def test_o_tables_descr_cache_invalidation(self):
+		node = self.node
+		node.start()
+		node.safe_psql(
+		    'postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;\n"
+		    "CREATE TABLE o_test(\n"
+		    "   id integer NOT NULL PRIMARY KEY,\n"
+		    "   val text\n"
+		    ") USING orioledb;\n"
+		    "INSERT INTO o_test VALUES (1, 'a'), (2, 'b');")
+
+		# Fill the shared descriptions cache
+		self.assertEqual(
+		    node.execute('postgres', 'SELECT count(*) FROM o_test;')[0][0], 2)
+
+		con1 = node.connect()
+		con1.begin()
+		con1.execute("ALTER TABLE o_test ADD COLUMN val2 integer DEFAULT 5;")
+		con1.execute("CREATE INDEX o_test_val_ix ON o_test (val);")
+		con1.rollback()
+		con1.close()
+
+		# A new backend must see the rolled back description
+		self.assertEqual(
+		    node.execute('postgres', 'SELECT * FROM o_test ORDER BY id;'),
+		    [(1, 'a'), (2, 'b')])
+
+		node.safe_psql(
+		    'postgres',
+		    "ALTER TABLE o_test ADD COLUMN val2 integer DEFAULT 5;\n"
+		    "CREATE INDEX o_test_val_ix ON o_test (val);\n"
+		    "INSERT INTO o_test VALUES (3, 'c', 7);")
+
+		# A new backend must see the committed description
+		self.assertEqual(
+		    node.execute('postgres', 'SELECT * FROM o_test ORDER BY id;'),
+		    [(1, 'a', 5), (2, 'b', 5), (3, 'c', 7)])
+		self.assertEqual(
+		    node.execute(
+		        'postgres', "SET enable_seqscan = off;\n"
+		        "SELECT id FROM o_test WHERE val = 'c';")[0][0], 3)
+		self.assertTrue(
+		    node.execute('postgres',
+		                 "SELECT orioledb_tbl_check('o_test'::regclass);")[0]
+		    [0])
+		node.stop()
@@ -77,6 +77,165 @@ class ReplicationTest(BaseTest):
 				replica.poll_query_until(
 				    "SELECT orioledb_has_retained_undo();", expected=False)
 
+	def test_replication_batch_apply(self):
+		with self.node as master:
+			master.start()
+
+			# create a backup
+			with self.getReplica().start() as replica:
+				master.safe_psql("""CREATE EXTENSION orioledb;
+					CREATE TABLE o_test (
+						id integer NOT NULL,
+						val integer NOT NULL,
+						PRIMARY KEY (id)
+					) USING orioledb;
+					CREATE INDEX o_test_val_idx ON o_test (val);
+					CREATE TABLE o_test_uniq (
+						id integer NOT NULL,
+						val integer NOT NULL,
+						PRIMARY KEY (id)
+					) USING orioledb;
+					CREATE UNIQUE INDEX o_test_uniq_val_idx ON o_test_uniq (val);
+					INSERT INTO o_test_uniq VALUES (1, 1), (2, 2);""")
+				replica.catchup()
+
+				master.safe_psql("""BEGIN;
+					INSERT INTO o_test (SELECT id, id % 100
+						FROM generate_series(1, 20000) id
+						ORDER BY random());
+					UPDATE o_test SET val = val + 1 WHERE id % 3 = 0;
+					DELETE FROM o_test WHERE id % 7 = 0;
+					INSERT INTO o_test (SELECT id, 0
+						FROM generate_series(1, 20000) id
+						WHERE id % 7 = 0 AND id % 2 = 0);
+					COMMIT;""")
+				master.safe_psql("""BEGIN;
+					UPDATE o_test_uniq SET val = 3 WHERE id = 1;
+					UPDATE o_test_uniq SET val = 1 WHERE id = 2;
+					UPDATE o_test_uniq SET val = 2 WHERE id = 1;
+					COMMIT;""")
+				catchup_orioledb(replica)
+
+				query = "SELECT count(*), sum(id::int8 * val) FROM o_test;"
+				self.assertEqual(
+				    master.execute(query)[0], replica.execute(query)[0])
+				query = ("SELECT count(*), sum(id) FROM o_test "
+				         "WHERE val = 0;")
+				self.assertEqual(
+				    master.execute(query)[0], replica.execute(query)[0])
+				self.assertEqual(
+				    replica.execute(
+				        "SELECT * FROM o_test_uniq ORDER BY val;"),
+				    [(2, 1), (1, 2)])
+				self.assertTrue(
+				    replica.execute(
+				        "SELECT orioledb_tbl_check('o_test'::regclass);")[0]
+				    [0])
+				self.assertGreater(
+				    replica.execute(
+				        "SELECT sum(sorted_batches) "
+				        "FROM orioledb_recovery_workers;")[0][0], 0)
+
+	def test_replication_update_delta(self):
+		with self.node as master:
+			master.start()
+
+			# create a backup
+			with self.getReplica().start() as replica:
+				master.safe_psql("""CREATE EXTENSION orioledb;
+					CREATE TABLE o_test_full (
+						id integer NOT NULL,
+						val integer,
+						payload text,
+						PRIMARY KEY (id)
+					) USING orioledb;
+					CREATE TABLE o_test_delta (
+						id integer NOT NULL,
+						val integer,
+						payload text,
+						PRIMARY KEY (id)
+					) USING orioledb WITH (wal_update_delta = true);
+					CREATE INDEX o_test_delta_val_idx ON o_test_delta (val);
+					INSERT INTO o_test_full (SELECT id, id, repeat('x', 500)
+						FROM generate_series(1, 1000) id);
+					INSERT INTO o_test_delta (SELECT id, id, repeat('x', 500)
+						FROM generate_series(1, 1000) id);
+					INSERT INTO o_test_delta VALUES
+						(1001, 1, repeat('y', 10000));""")
+				replica.catchup()
+
+				def wal_size(query):
+					start = master.execute(
+					    "SELECT pg_current_wal_insert_lsn();")[0][0]
+					master.safe_psql(query)
+					return master.execute(
+					    "SELECT pg_current_wal_insert_lsn() - '%s'::pg_lsn;" %
+					    start)[0][0]
+
+				full_size = wal_size(
+				    "UPDATE o_test_full SET val = val + 1;")
+				delta_size = wal_size(
+				    "UPDATE o_test_delta SET val = val + 1;")
+				self.assertLess(delta_size, full_size / 2)
+
+				master.safe_psql("""BEGIN;
+					UPDATE o_test_delta SET val = NULL WHERE id % 3 = 0;
+					UPDATE o_test_delta SET val = id * 2 WHERE id % 6 = 0;
+					UPDATE o_test_delta SET payload = NULL WHERE id % 5 = 0;
+					COMMIT;
+					UPDATE o_test_delta SET payload = 'short'
+						WHERE id % 10 = 0;
+					UPDATE o_test_delta SET val = val + 1 WHERE id = 1001;
+					DELETE FROM o_test_delta WHERE id % 7 = 0;""")
+				catchup_orioledb(replica)
+
+				query = "SELECT * FROM o_test_delta ORDER BY id;"
+				self.assertEqual(master.execute(query), replica.execute(query))
+				query = ("SELECT count(*), sum(val) FROM o_test_delta "
+				         "WHERE val > 500;")
+				self.assertEqual(
+				    master.execute(query)[0], replica.execute(query)[0])
+				self.assertTrue(
+				    replica.execute(
+				        "SELECT orioledb_tbl_check('o_test_delta'::regclass);"
+				    )[0][0])
+
+	def test_replication_wal_compress(self):
+		node = self.node
+		node.append_conf('postgresql.conf', "orioledb.wal_compress = 3\n")
+		with node as master:
+			master.start()
+
+			# create a backup
+			with self.getReplica().start() as replica:
+				master.safe_psql("""CREATE EXTENSION orioledb;
+					CREATE TABLE o_test (
+						id integer NOT NULL,
+						val text,
+						PRIMARY KEY (id)
+					) USING orioledb;""")
+				master.safe_psql("SELECT orioledb_stat_reset();")
+				master.safe_psql("""
+					INSERT INTO o_test (SELECT id, repeat('abc', 50)
+						FROM generate_series(1, 5000) id);
+					BEGIN;
+					UPDATE o_test SET val = 'updated' WHERE id % 3 = 0;
+					SAVEPOINT s1;
+					DELETE FROM o_test WHERE id % 5 = 0;
+					ROLLBACK TO SAVEPOINT s1;
+					DELETE FROM o_test WHERE id % 7 = 0;
+					COMMIT;""")
+				catchup_orioledb(replica)
+
+				query = "SELECT * FROM o_test ORDER BY id;"
+				self.assertEqual(master.execute(query), replica.execute(query))
+
+				wal_bytes, wal_bytes_written = master.execute("""
+					SELECT wal_bytes, wal_bytes_written
+					FROM orioledb_stat_global;""")[0]
+				self.assertGreater(wal_bytes, 0)
+				self.assertLess(wal_bytes_written, wal_bytes / 2)
+
 	def test_replication_drop(self):
 		with self.node as master:
 			master.start()
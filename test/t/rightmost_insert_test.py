@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+import unittest
+import testgres
+
+from .base_test import BaseTest
+from .base_test import ThreadQueryExecutor
+
+
+class RightmostInsertTest(BaseTest):
+
+	def check_table(self, node, name, count):
+		self.assertTrue(
+		    node.execute("SELECT orioledb_tbl_check('%s'::regclass)" %
+		                 name)[0][0])
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM %s;" % name)[0][0], count)
+
+	def concurrent_inserts(self, node, query, nthreads):
+		connections = [node.connect() for _ in range(nthreads)]
+		threads = [
+		    ThreadQueryExecutor(con, query) for con in connections
+		]
+		for t in threads:
+			t.start()
+		for t in threads:
+			t.join()
+		for con in connections:
+			con.commit()
+			con.close()
+
+	def test_concurrent_serial_inserts(self):
+		node = self.node
+		node.start()
+		node.safe_psql(
+		    'postgres', """
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE o_serial (
+				id bigserial PRIMARY KEY,
+				val int NOT NULL
+			) USING orioledb;
+			CREATE INDEX o_serial_val_idx ON o_serial (val);
+		""")
+
+		self.concurrent_inserts(
+		    node, """
+			DO $$
+			BEGIN
+				FOR i IN 1..2000 LOOP
+					INSERT INTO o_serial (val) VALUES (i);
+				END LOOP;
+			END $$;
+		""", 8)
+		self.check_table(node, 'o_serial', 16000)
+		self.assertEqual(
+		    node.execute("SELECT count(DISTINCT id), min(id), max(id) "
+		                 "FROM o_serial;")[0], (16000, 1, 16000))
+
+		# Keys below the rightmost leaf must not use the cached leaf
+		node.safe_psql(
+		    "INSERT INTO o_serial VALUES (0, 0), (-1, 0);\n"
+		    "INSERT INTO o_serial VALUES (16001, 0);\n"
+		    "DELETE FROM o_serial WHERE id BETWEEN 15000 AND 16001;\n"
+		    "INSERT INTO o_serial VALUES (15500, 0);\n"
+		    "INSERT INTO o_serial (val) VALUES (1);")
+		self.check_table(node, 'o_serial', 15003)
+		self.assertEqual(
+		    node.execute("SELECT id FROM o_serial "
+		                 "WHERE id < 1 OR id >= 14999 ORDER BY id;"),
+		    [(-1, ), (0, ), (14999, ), (15500, ), (16001, )])
+		node.stop()
+
+	def test_concurrent_ctid_inserts(self):
+		node = self.node
+		node.start()
+		node.safe_psql(
+		    'postgres', """
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE o_ctid (
+				val int NOT NULL
+			) USING orioledb;
+		""")
+
+		self.concurrent_inserts(
+		    node, """
+			DO $$
+			BEGIN
+				FOR i IN 1..2000 LOOP
+					INSERT INTO o_ctid VALUES (i);
+				END LOOP;
+			END $$;
+		""", 8)
+		self.check_table(node, 'o_ctid', 16000)
+		self.assertEqual(
+		    node.execute("SELECT count(DISTINCT ctid) FROM o_ctid;")[0][0],
+		    16000)
+		node.stop()
@@ -241,6 +241,59 @@ class S3Test(S3BaseTest):
 
 		node.stop()
 
+	def test_s3_checkpoint_skip_unchanged(self):
+		node = self.node
+		node.append_conf(f"""
+			orioledb.s3_mode = true
+			orioledb.s3_host = '{self.host}:{self.port}/{self.bucket_name}'
+			orioledb.s3_region = '{self.region}'
+			orioledb.s3_accesskey = '{self.access_key_id}'
+			orioledb.s3_secretkey = '{self.secret_access_key}'
+			orioledb.s3_cainfo = '{self.s3_cainfo}'
+
+			orioledb.s3_num_workers = 3
+			orioledb.recovery_pool_size = 1
+
+			autovacuum = off
+		""")
+		node.start()
+		node.safe_psql("""
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE test_1 (
+				val_1 int
+			) USING heap;
+			INSERT INTO test_1 SELECT * FROM generate_series(1, 2000);
+		""")
+		test_1_filepath = node.execute(
+		    "SELECT pg_catalog.pg_relation_filepath('test_1'::regclass)")[0][0]
+
+		node.safe_psql("CHECKPOINT")
+
+		# Attributes of recently modified files aren't trusted, so file
+		# attributes are remembered only by the checkpoint after a delay.
+		time.sleep(2)
+		node.safe_psql("CHECKPOINT")
+
+		node.safe_psql("SELECT orioledb_stat_reset();")
+		node.safe_psql("CHECKPOINT")
+
+		hashed, skipped = node.execute("""
+			SELECT s3_files_hashed, s3_files_skipped
+			FROM orioledb_stat_global;""")[0]
+		self.assertGreater(skipped, 0)
+
+		objects = self.client.list_objects(Bucket=self.bucket_name)
+		objects = objects.get("Contents", [])
+		objects = sorted(list(x["Key"] for x in objects))
+		self.assertIn("data/1/" + test_1_filepath, objects)
+		self.assertNotIn("data/3/" + test_1_filepath, objects)
+
+		with open(node.pg_log_file) as f:
+			self.assertIn(
+			    f"orioledb s3 checkpoint 3: {hashed} files hashed", f.read())
+
+		node.stop()
+
 	def test_s3_checkpoint_checksum_error(self):
 		node = self.node
 		node.append_conf(f"""
@@ -284,7 +337,7 @@ class S3Test(S3BaseTest):
 		node.safe_psql("CHECKPOINT")
 		shutil.copy(small_file_checksums, f"{small_file_checksums}.copy")
 
-		pattern_str = r"^FILE: (?P<filename>.+), CHECKSUM: (?P<checksum>.+), CHECKPOINT: (?P<checkpoint>\d+)$"
+		pattern_str = r"^FILE: (?P<filename>.+), CHECKSUM: (?P<checksum>[^,]+), CHECKPOINT: (?P<checkpoint>\d+)(?:, SIZE: \d+, MTIME: \d+, INODE: \d+)?$"
 		pattern = re.compile(pattern_str)
 
 		with open(small_file_checksums, "r+") as f:
@@ -509,6 +562,91 @@ class S3Test(S3BaseTest):
 			new_node.stop()
 			new_node.cleanup()
 
+	def test_s3_archive_compress(self):
+		node = self.node
+		node.append_conf(f"""
+			orioledb.s3_mode = true
+			orioledb.s3_host = '{self.host}:{self.port}/{self.bucket_name}'
+			orioledb.s3_region = '{self.region}'
+			orioledb.s3_accesskey = '{self.access_key_id}'
+			orioledb.s3_secretkey = '{self.secret_access_key}'
+			orioledb.s3_cainfo = '{self.s3_cainfo}'
+			orioledb.s3_num_workers = 3
+			orioledb.s3_archive_compress = 3
+
+			archive_mode = on
+			archive_library = 'orioledb'
+		""")
+		node.append_conf(f"""
+			orioledb.recovery_pool_size = 1
+			orioledb.recovery_idx_pool_size = 1
+		""")
+		node.start()
+		node.safe_psql("""
+			CREATE EXTENSION orioledb;
+			CREATE TABLE o_test_1 (
+				val_1 int
+			) USING orioledb;
+			INSERT INTO o_test_1 SELECT * FROM generate_series(1, 5);
+		""")
+
+		# The in-progress transaction makes the checkpoint retain its undo,
+		# so the undo file is archived and has to be restored by the loader.
+		con = node.connect()
+		con.begin()
+		con.execute("INSERT INTO o_test_1 VALUES (6);")
+		node.safe_psql("CHECKPOINT;")
+		redo_wal_file = node.execute("""
+			SELECT pg_walfile_name(redo_lsn) FROM pg_control_checkpoint();
+		""")[0][0]
+		node.safe_psql("SELECT pg_switch_wal();")
+
+		deadline = time.monotonic() + 60
+		while 'Contents' not in self.client.list_objects(
+		    Bucket=self.bucket_name, Prefix=f'wal/{redo_wal_file}'):
+			if time.monotonic() > deadline:
+				self.fail(f"WAL file {redo_wal_file} was not archived")
+			time.sleep(0.1)
+		con.rollback()
+		con.close()
+
+		# Immediate stop to keep the checkpoint above the last one
+		node.stop(['-m', 'immediate'])
+
+		objects = self.client.list_objects(Bucket=self.bucket_name,
+		                                   Prefix='wal/')
+		wal_files = [x['Key'] for x in objects['Contents']]
+		self.assertIn(f'wal/{redo_wal_file}.zst', wal_files)
+		for key in wal_files:
+			self.assertTrue(key.endswith('.zst'))
+			obj = self.client.get_object(Bucket=self.bucket_name, Key=key)
+			self.assertEqual(obj['Body'].read(4), b'\x28\xb5\x2f\xfd')
+
+		objects = self.client.list_objects(Bucket=self.bucket_name,
+		                                   Prefix='orioledb_undo/')
+		undo_files = [x['Key'] for x in objects.get('Contents', [])]
+		for key in undo_files:
+			self.assertTrue(key.endswith('.zst'))
+		row_undo_files = [x for x in undo_files if x.endswith('row.zst')]
+		self.assertNotEqual(row_undo_files, [])
+
+		new_temp_dir = mkdtemp(prefix=self.myName + '_tgsb_')
+		with testgres.get_new_node('test', base_dir=new_temp_dir) as new_node:
+			self.loader.download(new_node.data_dir)
+			for key in [f'pg_wal/{redo_wal_file}.zst'] + row_undo_files:
+				path = os.path.join(new_node.data_dir, key[:-len('.zst')])
+				self.assertTrue(os.path.exists(path))
+				self.assertFalse(os.path.exists(path + '.zst'))
+
+			new_node.port = self.getBasePort() + 1
+			new_node.append_conf(port=new_node.port)
+
+			new_node.start()
+			self.assertEqual([(1, ), (2, ), (3, ), (4, ), (5, )],
+			                 new_node.execute("SELECT * FROM o_test_1"))
+			new_node.stop()
+			new_node.cleanup()
+
 	@s3_test_attrs(
 	    http=True,
 	    prefix=f'{S3BaseTest.bucket_name}/{S3BaseTest.optional_prefix}')
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+import re
+import unittest
+import testgres
+
+from .base_test import BaseTest
+
+
+class SuffixTruncationTest(BaseTest):
+
+	def truncated_hikeys(self, node, table, index):
+		structure = node.execute(
+		    "SELECT orioledb_idx_structure('%s'::regclass, '%s');" %
+		    (table, index))[0][0]
+		return len(re.findall(r"key = \('tenant_\d+'\)", structure))
+
+	def fill(self, node, table, start, end):
+		node.safe_psql(
+		    'postgres', """
+			INSERT INTO %s
+				SELECT 'tenant_' || (i / 10), repeat('k', 100) || i, i
+				FROM generate_series(%d, %d) i;
+		""" % (table, start, end))
+
+	def create(self, node, table):
+		node.safe_psql(
+		    'postgres', """
+			CREATE TABLE %s (
+				tenant text NOT NULL,
+				natural_key text NOT NULL,
+				val int NOT NULL,
+				PRIMARY KEY (tenant, natural_key)
+			) USING orioledb;
+			CREATE INDEX %s_ix ON %s (tenant, val);
+		""" % (table, table, table))
+
+	def check(self, node, table, count):
+		self.assertTrue(
+		    node.execute("SELECT orioledb_tbl_check('%s'::regclass)" %
+		                 table)[0][0])
+		self.assertEqual(
+		    node.execute("SELECT count(*) FROM %s;" % table)[0][0], count)
+
+	def test_suffix_truncation_text_keys(self):
+		node = self.node
+		node.append_conf('postgresql.conf',
+		                 "orioledb.btree_suffix_truncation = on\n")
+		node.start()
+		node.safe_psql('postgres', "CREATE EXTENSION IF NOT EXISTS orioledb;")
+		self.create(node, 'o_trunc')
+		self.fill(node, 'o_trunc', 1, 5000)
+
+		self.check(node, 'o_trunc', 5000)
+		self.assertGreater(
+		    self.truncated_hikeys(node, 'o_trunc', 'o_trunc_pkey'), 0)
+		self.assertGreater(
+		    self.truncated_hikeys(node, 'o_trunc', 'o_trunc_ix'), 0)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM o_trunc WHERE tenant = 'tenant_77';
+			""")[0][0], 10)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM o_trunc
+				WHERE tenant > 'tenant_17' AND tenant < 'tenant_18';
+			""")[0][0], 100)
+		self.assertEqual(
+		    node.execute("""
+				SELECT val FROM o_trunc
+				WHERE tenant = 'tenant_300' AND
+					  natural_key = repeat('k', 100) || 3003;
+			""")[0][0], 3003)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM o_trunc
+				WHERE tenant = 'tenant_123' AND val BETWEEN 1232 AND 1240;
+			""")[0][0], 8)
+
+		node.safe_psql('postgres', "DELETE FROM o_trunc WHERE val % 3 = 0;")
+		self.check(node, 'o_trunc', 3334)
+
+		# Turning the setting off affects the new trees only
+		node.safe_psql(
+		    'postgres', """
+			ALTER SYSTEM SET orioledb.btree_suffix_truncation = off;
+			SELECT pg_reload_conf();
+		""")
+		self.create(node, 'o_full')
+		self.fill(node, 'o_full', 1, 5000)
+		self.check(node, 'o_full', 5000)
+		self.assertEqual(
+		    self.truncated_hikeys(node, 'o_full', 'o_full_pkey'), 0)
+
+		# The tree keeps truncating separators after restart
+		node.safe_psql('postgres', "CHECKPOINT;")
+		truncated = self.truncated_hikeys(node, 'o_trunc', 'o_trunc_pkey')
+		node.stop()
+		node.start()
+		self.check(node, 'o_trunc', 3334)
+		self.fill(node, 'o_trunc', 5001, 10000)
+		self.check(node, 'o_trunc', 8334)
+		self.assertGreater(
+		    self.truncated_hikeys(node, 'o_trunc', 'o_trunc_pkey'), truncated)
+		self.assertEqual(
+		    self.truncated_hikeys(node, 'o_full', 'o_full_pkey'), 0)
+		node.stop()
+
+	def test_suffix_truncation_fixed_keys(self):
+		node = self.node
+		node.append_conf('postgresql.conf',
+		                 "orioledb.btree_suffix_truncation = on\n")
+		node.start()
+		node.safe_psql(
+		    'postgres', """
+			CREATE EXTENSION IF NOT EXISTS orioledb;
+			CREATE TABLE o_trunc_fixed (
+				a int NOT NULL,
+				b int NOT NULL,
+				c int NOT NULL,
+				PRIMARY KEY (a, b, c)
+			) USING orioledb;
+			CREATE INDEX o_trunc_fixed_ix ON o_trunc_fixed (b, a);
+			INSERT INTO o_trunc_fixed
+				SELECT i / 100, (i / 10) % 10, i FROM generate_series(1, 20000) i;
+		""")
+		self.check(node, 'o_trunc_fixed', 20000)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM o_trunc_fixed WHERE a = 77;
+			""")[0][0], 100)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM o_trunc_fixed WHERE a = 77 AND b >= 5;
+			""")[0][0], 50)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM o_trunc_fixed
+				WHERE a BETWEEN 10 AND 19 AND b = 3 AND c < 1500;
+			""")[0][0], 50)
+		self.assertEqual(
+		    node.execute("""
+				SELECT count(*) FROM o_trunc_fixed WHERE b = 3 AND a < 50;
+			""")[0][0], 500)
+		node.safe_psql('postgres',
+		               "DELETE FROM o_trunc_fixed WHERE c % 7 = 0;")
+		self.check(node, 'o_trunc_fixed', 20000 - 20000 // 7)
+		node.stop()